@@ -18,6 +18,11 @@
     #define MAPNAME phmap::flat_hash_map
     #define NMSP phmap
     #define EXTRAARGS
+#elif defined(PHMAP_SPARSE)
+    #include "parallel_hashmap/phmap_sparse.h"
+    #define MAPNAME phmap::sparse_hash_map
+    #define NMSP phmap
+    #define EXTRAARGS
 #elif defined(ABSEIL_PARALLEL_FLAT) || defined(PHMAP)
     #if defined(ABSEIL_PARALLEL_FLAT)
         #include "absl/container/parallel_flat_hash_map.h"
@@ -0,0 +1,84 @@
+// Compares flat_hash_map, node_hash_map and adaptive_hash_map for values of
+// increasing size.
+//
+// usage: ex_adaptive_bench [num_keys]
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <parallel_hashmap/phmap.h>
+
+using std::chrono::high_resolution_clock;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+
+template <size_t N>
+struct Value
+{
+    Value(uint64_t v = 0) { data[0] = v; }
+    std::array<uint64_t, N / sizeof(uint64_t)> data;
+};
+
+template <class Map>
+void bench(const char* name, const std::vector<uint64_t>& keys) {
+    auto t0 = high_resolution_clock::now();
+    Map m;
+    for (auto k : keys)
+        m.emplace(k, k);
+
+    auto t1 = high_resolution_clock::now();
+    uint64_t sum = 0;
+    for (int rep = 0; rep < 4; ++rep) {
+        for (auto k : keys) {
+            auto it = m.find(k);
+            sum += it->second.data[0];
+        }
+    }
+
+    auto t2 = high_resolution_clock::now();
+    uint64_t misses = 0;
+    for (auto k : keys)
+        misses += m.contains(k + 1);
+
+    auto t3 = high_resolution_clock::now();
+    for (auto k : keys)
+        m.erase(k);
+
+    auto t4 = high_resolution_clock::now();
+    printf("    %-18s insert: %5d ms   find: %5d ms   miss: %5d ms   erase: %5d ms  (%llu)\n", name,
+           (int)duration_cast<milliseconds>(t1 - t0).count(),
+           (int)duration_cast<milliseconds>(t2 - t1).count(),
+           (int)duration_cast<milliseconds>(t3 - t2).count(),
+           (int)duration_cast<milliseconds>(t4 - t3).count(),
+           (unsigned long long)(sum + misses));
+}
+
+template <size_t N>
+void bench_size(const std::vector<uint64_t>& keys) {
+    using V = Value<N>;
+    printf("value size %zu bytes (adaptive stores values %s)\n", sizeof(V),
+           phmap::adaptive_hash_map<uint64_t, V>::stores_values_inline ? "inline" : "out-of-line");
+    bench<phmap::flat_hash_map<uint64_t, V>>("flat_hash_map", keys);
+    bench<phmap::node_hash_map<uint64_t, V>>("node_hash_map", keys);
+    bench<phmap::adaptive_hash_map<uint64_t, V>>("adaptive_hash_map", keys);
+}
+
+int main(int argc, char** argv) {
+    size_t num_keys = argc > 1 ? (size_t)atoll(argv[1]) : 1000000;
+
+    std::mt19937_64 rng(42);
+    std::vector<uint64_t> keys(num_keys);
+    for (auto& k : keys)
+        k = rng() & ~uint64_t(1); // even keys, so that k + 1 is always a miss
+
+    bench_size<8>(keys);
+    bench_size<32>(keys);
+    bench_size<64>(keys);
+    bench_size<128>(keys);
+    bench_size<512>(keys);
+    return 0;
+}
@@ -1,3 +1,4 @@
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <array>
@@ -5,6 +6,7 @@
 #include <limits>
 #include <random>
 #include <utility>
+#include <vector>
 #define PHMAP_ALLOCATOR_NOTHROW 1
 #include <parallel_hashmap/phmap.h>
 
@@ -95,14 +97,132 @@ static inline std::string to_str(uint64_t x) {
     return res;
 }
 
+static double seconds_since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// mixes of phmap_mix<8>: the 128 bit multiplication (default) and the CRC32C
+// (PHMAP_USE_CRC32C_HASH, fast with -msse4.2 or on ARMv8 with crc)
+#if defined(PHMAP_HAS_UMUL128)
+struct MulMix {
+    static const char* name() { return "umul128"; }
+    size_t operator()(uint64_t a) const {
+        uint64_t h;
+        uint64_t l = umul128(a, 0xde5fb9d2630458e9ULL, &h);
+        return static_cast<size_t>(h + l);
+    }
+};
+#endif
+
+struct Crc32cMix {
+    static const char* name() { return "crc32c"; }
+    size_t operator()(uint64_t a) const { return static_cast<size_t>(phmap::priv::crc32c_mix(a)); }
+};
+
+template <class Mix>
+void bench_mix(size_t n) {
+    Mix mix;
+    // latency: each hash depends on the previous one
+    auto t0 = std::chrono::steady_clock::now();
+    uint64_t h = 1;
+    for (size_t i = 0; i < n; ++i)
+        h = mix(h + i);
+    double latency = seconds_since(t0);
+
+    // throughput: independent hashes
+    t0 = std::chrono::steady_clock::now();
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; ++i)
+        sum += mix(i);
+    double throughput = seconds_since(t0);
+
+    std::cout << "mix " << Mix::name() << ": " << latency * 1e9 / n << " ns latency, "
+              << throughput * 1e9 / n << " ns/hash throughput (" << ((h ^ sum) & 1) << ")\n";
+}
+
+// composite key: streamed into one MixingHashState (AbslHashValue), or each
+// member hashed separately and combined
+struct Person {
+    std::string first, last, city;
+    uint32_t    age;
+
+    template <class H>
+    friend H AbslHashValue(H h, const Person& p) {
+        return H::combine(std::move(h), p.first, p.last, p.city, p.age);
+    }
+};
+
+struct CombinedHash {
+    size_t operator()(const Person& p) const {
+        phmap::Combiner<size_t, sizeof(size_t)> c;
+        size_t seed = c(0, phmap::Hash<std::string>()(p.first));
+        seed = c(seed, phmap::Hash<std::string>()(p.last));
+        seed = c(seed, phmap::Hash<std::string>()(p.city));
+        return c(seed, phmap::Hash<uint32_t>()(p.age));
+    }
+};
+
+template <class H>
+void bench_composite(const char* name, const std::vector<Person>& people, size_t rounds) {
+    H hasher;
+    auto t0 = std::chrono::steady_clock::now();
+    size_t sum = 0;
+    for (size_t r = 0; r < rounds; ++r)
+        for (const auto& p : people)
+            sum += hasher(p);
+    double t = seconds_since(t0);
+    std::cout << "Person hash, " << name << ": " << t * 1e9 / (rounds * people.size())
+              << " ns/hash (" << (sum & 1) << ")\n";
+}
+
+void bench_int_map(size_t n) {
+    using Map = phmap::flat_hash_map<uint64_t, uint64_t>;
+    Map map;
+    sfc64 rng(123);
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i)
+        map[rng() >> 40]++;                    // 24 bit keys: half inserts, half updates
+    uint64_t found = 0;
+    for (size_t i = 0; i < n; ++i)
+        found += map.count(i << 8);            // keys differing in their high bits
+    std::cout << "flat_hash_map<uint64_t>: " << seconds_since(t0) << " s for " << n
+              << " updates and lookups (" << map.size() << ", " << found << ")\n";
+}
+
 int main()
 {
+#if defined(PHMAP_USE_CRC32C_HASH)
+    std::cout << "phmap_mix: crc32c";
+#else
+    std::cout << "phmap_mix: default";
+#endif
+#if PHMAP_HAVE_SSE42 || defined(__ARM_FEATURE_CRC32)
+    std::cout << " (crc32c in hardware)\n";
+#else
+    std::cout << " (crc32c in software)\n";
+#endif
+
+#if defined(PHMAP_HAS_UMUL128)
+    bench_mix<MulMix>(200000000);
+#endif
+    bench_mix<Crc32cMix>(200000000);
+    bench_int_map(20000000);
+
+    std::vector<Person> people;
+    sfc64 prng(7);
+    for (uint32_t i = 0; i < 1000; ++i)
+        people.push_back(Person{ "first_" + to_str(prng()), "last_name_" + to_str(prng()),
+                                 "city_" + to_str(prng()), i });
+    bench_composite<CombinedHash>("members combined", people, 20000);
+    bench_composite<phmap::Hash<Person>>("MixingHashState", people, 20000);
+
     using Map = phmap::flat_hash_map<std::string, uint32_t>;
     Map map;
     map.reserve((size_t)(65536 * 1.1)); // we will create a maximun of 65536 different strings
 
     sfc64 rng(123);
     constexpr size_t const n = 50000000;
+    auto t0 = std::chrono::steady_clock::now();
     for (size_t i = 0; i < n; ++i) {
         auto s = to_str(rng());
         map[s]++;
@@ -116,6 +236,7 @@ int main()
         map[s]++;
         map[s]++;
     }
+    std::cout << "flat_hash_map<std::string>: " << seconds_since(t0) << " s\n";
 
     uint64_t cnt = 0;
     for (const auto& s : map) {
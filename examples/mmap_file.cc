@@ -0,0 +1,35 @@
+// Stores a parallel_flat_hash_map in a memory-mapped file. The first run fills
+// the map; the following runs find it in the file, without loading anything.
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <parallel_hashmap/phmap_mmap.h>
+
+#if PHMAP_HAVE_MMAP
+
+using Alloc = phmap::mmap_file_allocator<std::pair<const uint64_t, uint64_t>>;
+using Map   = phmap::parallel_flat_hash_map<uint64_t, uint64_t, phmap::Hash<uint64_t>,
+                                            phmap::EqualTo<uint64_t>, Alloc, 4, std::mutex>;
+
+int main()
+{
+    phmap::mmap_file file("mmap_file_example.dat", size_t(1) << 30);
+    Map* map = file.find_or_construct<Map>("squares", file.get_allocator<Map::value_type>());
+
+    if (file.created()) {
+        map->reserve(1000000);
+        for (uint64_t i = 0; i < 1000000; ++i)
+            map->emplace(i, i * i);
+        std::cout << "created map with " << map->size() << " elements\n";
+    } else {
+        std::cout << "reopened map with " << map->size() << " elements, "
+                  << "map[1000] = " << map->at(1000) << '\n';
+    }
+    return 0;
+}
+
+#else
+
+int main() { return 0; }
+
+#endif
@@ -115,6 +115,7 @@
 #include <array>
 #include <cassert>
 #include <atomic>
+#include <future>
 
 #include "phmap_fwd_decl.h"
 #include "phmap_utils.h"
@@ -1829,6 +1830,8 @@ public:
 
     friend bool operator==(const raw_hash_set& a, const raw_hash_set& b) {
         if (a.size() != b.size()) return false;
+        if (a.capacity() == b.capacity() && a.capacity())
+            return a.equal_same_capacity(b);
         const raw_hash_set* outer = &a;
         const raw_hash_set* inner = &b;
         if (outer->capacity() > inner->capacity()) 
@@ -1852,6 +1855,12 @@ public:
         return HashElement{hash_ref()}(key);
     }
 
+    // out[i] = hash(keys[i]), see phmap::hash_batch
+    template <class K>
+    void hash_batch(const K* keys, size_t n, size_t* out) const {
+        phmap::hash_batch(keys, n, out, HashElement{hash_ref()});
+    }
+
 private:
     template <class Container, typename Enabler>
     friend struct phmap::priv::hashtable_debug_internal::HashtableDebugAccess;
@@ -1868,9 +1877,8 @@ private:
             Group g{ ctrl_ + seq.offset() };
             for (uint32_t i : g.Match((h2_t)H2(hashval))) {
                 offset = seq.offset((size_t)i);
-                if (PHMAP_PREDICT_TRUE(PolicyTraits::apply(
-                    EqualElement<K>{key, eq_ref()},
-                    PolicyTraits::element(slots_ + offset))))
+                if (PHMAP_PREDICT_TRUE(PolicyTraits::apply_key(
+                    EqualElement<K>{key, eq_ref()}, slots_ + offset)))
                     return true;
             }
             if (PHMAP_PREDICT_TRUE(g.MatchEmpty()))
@@ -1879,6 +1887,30 @@ private:
         }
     }
 
+    // Tables of the same capacity, filled with the same keys using the same
+    // hasher, usually hold each element in the same slot. So we walk both tables
+    // in group order, and compare the elements in place when the control bytes
+    // match. Only the elements not found at the same position are looked up.
+    // PRECONDITION: same size and capacity.
+    bool equal_same_capacity(const raw_hash_set& o) const {
+        assert(size() == o.size() && capacity_ == o.capacity_);
+        for (size_t i = 0; i < capacity_; i += Group::kWidth) {
+            const bool same_ctrl = std::memcmp(ctrl_ + i, o.ctrl_ + i, Group::kWidth) == 0;
+            const size_t last = (std::min)(i + Group::kWidth, capacity_);
+            for (size_t j = i; j < last; ++j) {
+                if (!IsFull(ctrl_[j])) 
+                    continue;
+                const value_type& elem = PolicyTraits::element(slots_ + j);
+                if ((same_ctrl || ctrl_[j] == o.ctrl_[j]) && 
+                    elem == PolicyTraits::element(o.slots_ + j))
+                    continue;
+                if (!o.has_element(elem)) 
+                    return false;
+            }
+        }
+        return true;
+    }
+
     struct FindElement 
     {
         template <class K, class... Args>
@@ -2061,8 +2093,8 @@ private:
 
         for (size_t i = 0; i != old_capacity; ++i) {
             if (IsFull(old_ctrl[i])) {
-                size_t hashval = PolicyTraits::apply(HashElement{hash_ref()},
-                                                     PolicyTraits::element(old_slots + i));
+                size_t hashval = PolicyTraits::apply_key(HashElement{hash_ref()},
+                                                         old_slots + i);
                 auto target = find_first_non_full(hashval);
                 size_t new_i = target.offset;
                 set_ctrl(new_i, H2(hashval));
@@ -2103,8 +2135,8 @@ private:
         slot_type* slot = reinterpret_cast<slot_type*>(&raw);
         for (size_t i = 0; i != capacity_; ++i) {
             if (!IsDeleted(ctrl_[i])) continue;
-            size_t hashval = PolicyTraits::apply(HashElement{hash_ref()},
-                                                 PolicyTraits::element(slots_ + i));
+            size_t hashval = PolicyTraits::apply_key(HashElement{hash_ref()},
+                                                     slots_ + i);
             auto target = find_first_non_full(hashval);
             size_t new_i = target.offset;
 
@@ -2230,9 +2262,9 @@ protected:
         while (true) {
             Group g{ctrl_ + seq.offset()};
             for (uint32_t i : g.Match((h2_t)H2(hashval))) {
-                if (PHMAP_PREDICT_TRUE(PolicyTraits::apply(
+                if (PHMAP_PREDICT_TRUE(PolicyTraits::apply_key(
                                           EqualElement<K>{key, eq_ref()},
-                                          PolicyTraits::element(slots_ + seq.offset((size_t)i)))))
+                                          slots_ + seq.offset((size_t)i))))
                     return seq.offset((size_t)i);
             }
             if (PHMAP_PREDICT_TRUE(g.MatchEmpty())) break;
@@ -2640,6 +2672,7 @@ protected:
         }
 
         EmbeddedSet set_;
+        size_t      modified_ = 0;   // epoch of the last modification, see advance_epoch()
     };
 
 private:
@@ -2678,11 +2711,6 @@ private:
     using IsDecomposable = IsDecomposable<void, PolicyTraits, Hash, Eq, Ts...>;
 
 public:
-    static_assert(std::is_same<pointer, value_type*>::value,
-                  "Allocators with custom pointer types are not supported");
-    static_assert(std::is_same<const_pointer, const value_type*>::value,
-                  "Allocators with custom pointer types are not supported");
-
     // --------------------- i t e r a t o r ------------------------------
     class iterator 
     {
@@ -2944,8 +2972,10 @@ public:
     }
 
     parallel_hash_set& operator=(const parallel_hash_set& that) {
-        for (size_t i=0; i<num_tables; ++i)
+        for (size_t i=0; i<num_tables; ++i) {
+            set_modified(sets_[i]);
             sets_[i].set_ = that.sets_[i].set_;
+        }
         return *this;
     }
 
@@ -2953,8 +2983,11 @@ public:
         phmap::allocator_traits<allocator_type>::is_always_equal::value &&
         std::is_nothrow_move_assignable<hasher>::value &&
         std::is_nothrow_move_assignable<key_equal>::value) {
-        for (size_t i=0; i<num_tables; ++i)
+        for (size_t i=0; i<num_tables; ++i) {
+            set_modified(sets_[i]);
+            that.set_modified(that.sets_[i]);
             sets_[i].set_ = std::move(that.sets_[i].set_);
+        }
         return *this;
     }
 
@@ -2994,6 +3027,7 @@ public:
         for (auto& inner : sets_)
         {
             UniqueLock m(inner);
+            set_modified(inner);
             inner.set_.clear();
         }
     }
@@ -3003,6 +3037,7 @@ public:
     void clear(std::size_t submap_index) {
         Inner& inner = sets_[submap_index];
         UniqueLock m(inner);
+        set_modified(inner);
         inner.set_.clear();
     }
 
@@ -3096,6 +3131,7 @@ public:
         auto&  set     = inner.set_;
 
         UniqueLock m(inner);
+        set_modified(inner);
         auto   res  = set.insert(std::move(node), hashval);
         return { make_iterator(&inner, res.position),
                  res.inserted,
@@ -3159,6 +3195,7 @@ public:
         Inner& inner    = sets_[subidx(hashval)];
         auto&  set      = inner.set_;
         UniqueLock m(inner);
+        set_modified(inner);
         typename EmbeddedSet::template InsertSlotWithHash<true> f { inner, std::move(*slot), hashval };
         return make_rv(PolicyTraits::apply(f, elem));
     }
@@ -3178,7 +3215,7 @@ public:
         Inner& inner   = sets_[subidx(hashval)];
         auto&  set     = inner.set_;
         UniqueLock m(inner);
-        
+        set_modified(inner);
         size_t offset = set._find_key(key, hashval);
         if (offset == (size_t)-1) {
             offset = set.prepare_insert(hashval);
@@ -3234,6 +3271,7 @@ public:
         Inner& inner     = sets_[subidx(hashval)];
         auto&  set       = inner.set_;
         UniqueLock m(inner);
+        set_modified(inner);
         typename EmbeddedSet::template InsertSlotWithHash<true> f { inner, std::move(*slot), hashval };
         return make_rv(PolicyTraits::apply(f, elem));
     }
@@ -3263,6 +3301,7 @@ public:
         Inner& inner = sets_[subidx(hashval)];
         auto&  set   = inner.set_;
         UniqueLock m(inner);
+        set_modified(inner);
         size_t offset = set._find_key(key, hashval);
         if (offset == (size_t)-1) {
             offset = set.prepare_insert(hashval);
@@ -3284,6 +3323,7 @@ public:
         Inner& inner = sets_[subidx(hashval)];
         auto&  set   = inner.set_;
         UniqueLock m(inner);
+        set_modified(inner);
         set.emplace_single_with_hash(key, hashval, std::forward<F>(f));
     }
 
@@ -3316,19 +3356,22 @@ public:
     // ----------------------------------------------------------------------------------------------------
     template <class K = key_type, class F>
     bool modify_if(const key_arg<K>& key, F&& f) {
-        return modify_if_impl<K, F, UniqueLock>(key, std::forward<F>(f));
+        return modify_if_impl<K, F, UniqueLock>(key, std::forward<F>(f), true);
     }
 
     // -----------------------------------------------------------------------------------------
     template <class K = key_type, class F, class L>
-    bool modify_if_impl(const key_arg<K>& key, F&& f) {
+    bool modify_if_impl(const key_arg<K>& key, F&& f, bool modifies = false) {
 #if __cplusplus >= 201703L
         static_assert(std::is_invocable<F, value_type&>::value);
 #endif
         L m;
-        auto ptr = this->template find_ptr<K, L>(key, this->hash(key), m);
+        size_t hashval = this->hash(key);
+        auto ptr = this->template find_ptr<K, L>(key, hashval, m);
         if (ptr == nullptr)
             return false;
+        if (modifies)
+            set_modified(sets_[subidx(hashval)]);
         std::forward<F>(f)(*ptr);
         return true;
     }
@@ -3361,6 +3404,7 @@ public:
             if (it == set.end())
                 return 0;
         }
+        set_modified(inner);
         if (std::forward<F>(f)(const_cast<value_type &>(*it)))
         {
             set._erase(it);
@@ -3413,6 +3457,7 @@ public:
     void for_each_m(F&& fCallback) {
         for (auto& inner : sets_) {
             UniqueLock m(inner);
+            set_modified(inner);
             std::for_each(inner.set_.begin(), inner.set_.end(), fCallback);
         }
     }
@@ -3435,6 +3480,7 @@ public:
             std::forward<ExecutionPolicy>(policy), sets_.begin(), sets_.end(),
             [&](auto& inner) {
                 UniqueLock m(inner);
+                set_modified(inner);
                 std::for_each(inner.set_.begin(), inner.set_.end(), fCallback);
             }
         );
@@ -3459,6 +3505,7 @@ public:
         Inner& inner   = sets_[idx];
         auto&  set     = inner.set_;
         UniqueLock m(inner);
+        set_modified(inner);
         fCallback(set);
     }
 
@@ -3511,7 +3558,7 @@ public:
         assert(inner != nullptr);
         auto&  set   = inner->set_;
         // UniqueLock m(*inner); // don't lock here 
-        
+        set_modified(*inner);
         set._erase(it.it_);
     }
     void _erase(const_iterator cit) { _erase(cit.iter_); }
@@ -3541,6 +3588,8 @@ public:
             for (size_t i=0; i<num_tables; ++i)
             {
                 typename Lockable::UniqueLocks l(sets_[i], src.sets_[i]);
+                set_modified(sets_[i]);
+                src.set_modified(src.sets_[i]);
                 sets_[i].set_.merge(src.sets_[i].set_);
             }
         }
@@ -3552,6 +3601,7 @@ public:
     }
 
     node_type extract(const_iterator position) {
+        set_modified(*position.iter_.inner_);
         return position.iter_.inner_->set_.extract(EmbeddedConstIterator(position.iter_.it_));
     }
 
@@ -3576,6 +3626,8 @@ public:
         {
             typename Lockable::UniqueLock l(sets_[i]);
             typename Lockable2::UniqueLock l2(that.get_inner(i));
+            set_modified(sets_[i]);
+            that.set_modified(that.get_inner(i));
             swap(sets_[i].set_, that.get_inner(i).set_);
         }
     }
@@ -3711,6 +3763,16 @@ public:
         return std::equal(a.sets_.begin(), a.sets_.end(), b.sets_.begin());
     }
 
+#if __cplusplus >= 201703L
+    // Same as operator==, but the submaps are compared according to `policy`,
+    // for example concurrently with `std::execution::par`.
+    template <class ExecutionPolicy>
+    bool equal(ExecutionPolicy&& policy, const parallel_hash_set& o) const {
+        return std::equal(std::forward<ExecutionPolicy>(policy),
+                          sets_.begin(), sets_.end(), o.sets_.begin());
+    }
+#endif
+
     friend bool operator!=(const parallel_hash_set& a, const parallel_hash_set& b) {
         return !(a == b);
     }
@@ -3728,18 +3790,56 @@ public:
         return HashElement{hash_ref()}(key);
     }
 
+    // out[i] = hash(keys[i]), see phmap::hash_batch
+    template <class K>
+    void hash_batch(const K* keys, size_t n, size_t* out) const {
+        phmap::hash_batch(keys, n, out, HashElement{hash_ref()});
+    }
+
+    // Dirty tracking: the submaps modified through the map's API are stamped
+    // with the current epoch (the values changed through references or
+    // iterators are not tracked). advance_epoch() starts a new epoch and
+    // returns it: the submaps modified after the call will have a stamp >= it.
+    size_t advance_epoch() { return ++epoch_; }
+
 #if !defined(PHMAP_NON_DETERMINISTIC)
     template<typename OutputArchive>
     bool phmap_dump(OutputArchive& ar) const;
 
     template<typename InputArchive>
     bool phmap_load(InputArchive& ar);
+
+    // writes the submaps modified since `since_epoch`, see advance_epoch()
+    template<typename OutputArchive>
+    bool dump_delta(OutputArchive& ar, size_t since_epoch) const;
+
+    // replays the deltas read from `ar` (one or more, until the end of the input)
+    template<typename InputArchive>
+    bool load_deltas(InputArchive& ar);
+
+    // dumps the live map from a background thread, locking one submap at a time
+    template<typename OutputArchive>
+    std::future<bool> dump_async(OutputArchive& ar,
+                                 std::function<void(size_t, size_t)> progress = {},
+                                 std::function<void(bool)> done = {}) const;
+
+#if PHMAP_HAVE_MMAP
+    // one thread per submap, and the dump can be loaded with a different N
+    bool phmap_dump_chunked(const char* file_path, size_t num_threads = 0) const;
+
+    bool phmap_load_chunked(const char* file_path, size_t num_threads = 0);
+#endif
 #endif
 
 private:
     template <class Container, typename Enabler>
     friend struct phmap::priv::hashtable_debug_internal::HashtableDebugAccess;
 
+    template <size_t N2,
+              template <class, class, class, class> class RefSet2,
+              class Mtx2, class Policy2, class Hash2, class Eq2, class Alloc2>
+    friend class parallel_hash_set;
+
     struct FindElement 
     {
         template <class K, class... Args>
@@ -3817,6 +3917,11 @@ private:
     }
 
 protected:
+    // called with the submap's lock held, before it is modified
+    void set_modified(Inner& inner) {
+        inner.modified_ = epoch_.load(std::memory_order_relaxed);
+    }
+
     template <class K = key_type, class L = SharedLock>
     pointer find_ptr(const key_arg<K>& key, size_t hashval, L& mutexlock)
     {
@@ -3840,6 +3945,7 @@ protected:
         Inner& inner = sets_[subidx(hashval)];
         auto&  set   = inner.set_;
         mutexlock    = std::move(UniqueLock(inner));
+        set_modified(inner);
         size_t offset = set._find_key(key, hashval);
         if (offset == (size_t)-1) {
             offset = set.prepare_insert(hashval);
@@ -3892,6 +3998,7 @@ private:
 
 protected:       // protected in case users want to derive fromm this
     std::array<Inner, num_tables> sets_;
+    std::atomic<size_t>           epoch_{1};
 };
 
 // --------------------------------------------------------------------------
@@ -4403,7 +4510,7 @@ struct NodeHashSetPolicy
         using ValueAlloc =
             typename phmap::allocator_traits<Allocator>::template rebind_alloc<T>;
         ValueAlloc value_alloc(*alloc);
-        T* res = phmap::allocator_traits<ValueAlloc>::allocate(value_alloc, 1);
+        T* res = &*phmap::allocator_traits<ValueAlloc>::allocate(value_alloc, 1); // `&*` for custom pointers
         phmap::allocator_traits<ValueAlloc>::construct(value_alloc, res,
                                                        std::forward<Args>(args)...);
         return res;
@@ -4450,7 +4557,7 @@ public:
             Allocator>::template rebind_alloc<value_type>;
         PairAlloc pair_alloc(*alloc);
         value_type* res =
-            phmap::allocator_traits<PairAlloc>::allocate(pair_alloc, 1);
+            &*phmap::allocator_traits<PairAlloc>::allocate(pair_alloc, 1); // `&*` for custom pointers
         phmap::allocator_traits<PairAlloc>::construct(pair_alloc, res,
                                                       std::forward<Args>(args)...);
         return res;
@@ -4481,6 +4588,81 @@ public:
     static const Value& value(const value_type* elem) { return elem->second; }
 };
 
+// --------------------------------------------------------------------------
+// Policy used by `adaptive_hash_map` for values stored out-of-line. The
+// elements are allocated as in `NodeHashMapPolicy`, but each slot also keeps a
+// copy of the key, so that lookups and rehashing don't dereference the node.
+// --------------------------------------------------------------------------
+template <class Key, class Value>
+class AdaptiveNodeMapPolicy
+{
+    using value_type = std::pair<const Key, Value>;
+    using NodePolicy = NodeHashMapPolicy<Key, Value>;
+
+public:
+    struct slot_type 
+    {
+        Key         key;
+        value_type* node;
+    };
+
+    using key_type = Key;
+    using mapped_type = Value;
+    using init_type = std::pair</*non const*/ key_type, mapped_type>;
+    using is_flat = std::false_type;
+
+    template <class Allocator, class... Args>
+    static void construct(Allocator* alloc, slot_type* slot, Args&&... args) {
+        slot->node = NodePolicy::new_element(alloc, std::forward<Args>(args)...);
+        construct_key(alloc, slot, slot->node->first);
+    }
+
+    template <class Allocator>
+    static void destroy(Allocator* alloc, slot_type* slot) {
+        destroy_key(alloc, slot);
+        NodePolicy::delete_element(alloc, slot->node);
+    }
+
+    template <class Allocator>
+    static void transfer(Allocator* alloc, slot_type* new_slot, slot_type* old_slot) {
+        construct_key(alloc, new_slot, std::move(old_slot->key));
+        destroy_key(alloc, old_slot);
+        new_slot->node = old_slot->node;
+    }
+
+    static value_type& element(slot_type* slot) { return *slot->node; }
+
+    static const Key& probe_key(const slot_type* slot) { return slot->key; }
+
+    template <class F, class... Args>
+        static decltype(phmap::priv::DecomposePair(
+                            std::declval<F>(), std::declval<Args>()...))
+        apply(F&& f, Args&&... args) {
+        return phmap::priv::DecomposePair(std::forward<F>(f),
+                                          std::forward<Args>(args)...);
+    }
+
+    static size_t space_used(const slot_type*) { return sizeof(value_type); }
+
+    static Value& value(value_type* elem) { return elem->second; }
+    static const Value& value(const value_type* elem) { return elem->second; }
+
+private:
+    template <class Allocator, class K>
+    static void construct_key(Allocator* alloc, slot_type* slot, K&& k) {
+        using KeyAlloc = typename phmap::allocator_traits<Allocator>::template rebind_alloc<Key>;
+        KeyAlloc key_alloc(*alloc);
+        phmap::allocator_traits<KeyAlloc>::construct(key_alloc, &slot->key, std::forward<K>(k));
+    }
+
+    template <class Allocator>
+    static void destroy_key(Allocator* alloc, slot_type* slot) {
+        using KeyAlloc = typename phmap::allocator_traits<Allocator>::template rebind_alloc<Key>;
+        KeyAlloc key_alloc(*alloc);
+        phmap::allocator_traits<KeyAlloc>::destroy(key_alloc, &slot->key);
+    }
+};
+
 
 // --------------------------------------------------------------------------
 //  hash_default
@@ -4497,9 +4679,7 @@ struct StringHashEqT
         using is_transparent = void;
         
         size_t operator()(std::basic_string_view<CharT> v) const {
-            std::string_view bv{
-                reinterpret_cast<const char*>(v.data()), v.size() * sizeof(CharT)};
-            return std::hash<std::string_view>()(bv);
+            return hash_key_bytes(v.data(), v.size() * sizeof(CharT));
         }
     };
 
@@ -4606,10 +4786,10 @@ struct HashtableDebugAccess<Set, typename std::enable_if<has_member_type_raw_has
         while (true) {
             priv::Group g{set.ctrl_ + seq.offset()};
             for (uint32_t i : g.Match((h2_t)priv::H2(hashval))) {
-                if (Traits::apply(
+                if (Traits::apply_key(
                         typename Set::template EqualElement<typename Set::key_type>{
                             key, set.eq_ref()},
-                        Traits::element(set.slots_ + seq.offset((size_t)i))))
+                        set.slots_ + seq.offset((size_t)i)))
                     return num_probes;
                 ++num_probes;
             }
@@ -4936,6 +5116,94 @@ public:
     void resize(typename Base::size_type hint) { this->rehash(hint); }
 };
 
+// -----------------------------------------------------------------------------
+// phmap::is_value_stored_inline
+// -----------------------------------------------------------------------------
+// Decides whether `adaptive_hash_map<Key, Value>` stores its values in the slot
+// array (as `flat_hash_map`) or out-of-line (as `node_hash_map`). Values which
+// are small and cheap to move are stored inline. Specialize this trait to
+// override the decision for a given value type.
+// -----------------------------------------------------------------------------
+template <class Key, class Value>
+struct is_value_stored_inline
+    : std::integral_constant<bool, (sizeof(std::pair<const Key, Value>) <= 64 &&
+                                    std::is_nothrow_move_constructible<Value>::value)> 
+{};
+
+// -----------------------------------------------------------------------------
+// phmap::adaptive_hash_map
+// -----------------------------------------------------------------------------
+// A hash map which picks its storage at compile time, according to
+// `phmap::is_value_stored_inline<Key, Value>`:
+//
+// * inline: same layout and behavior as `flat_hash_map<Key, Value>`.
+// * out-of-line: the values are allocated individually (so they are never
+//   moved, and pointers to them remain valid until erased), while the slots
+//   store a copy of the key next to the node pointer, so that probing and
+//   rehashing never touch the nodes. This requires `Key` to be copyable.
+//
+// Pointer stability should only be relied upon when `stores_values_inline` is
+// false.
+// -----------------------------------------------------------------------------
+template <class Key, class Value, class Hash, class Eq, class Alloc>  // default values in phmap_fwd_decl.h
+class adaptive_hash_map
+    : public phmap::priv::raw_hash_map<
+          phmap::conditional_t<phmap::is_value_stored_inline<Key, Value>::value,
+                               phmap::priv::FlatHashMapPolicy<Key, Value>,
+                               phmap::priv::AdaptiveNodeMapPolicy<Key, Value>>,
+          Hash, Eq, Alloc> 
+{
+    using Base = typename adaptive_hash_map::raw_hash_map;
+
+public:
+    static constexpr bool stores_values_inline = phmap::is_value_stored_inline<Key, Value>::value;
+
+    adaptive_hash_map() {}
+#ifdef __INTEL_COMPILER
+    using Base::raw_hash_map;
+#else
+    using Base::Base;
+#endif
+    using Base::begin;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::end;
+    using Base::capacity;
+    using Base::empty;
+    using Base::max_size;
+    using Base::size;
+    using Base::clear;
+    using Base::erase;
+    using Base::insert;
+    using Base::insert_or_assign;
+    using Base::emplace;
+    using Base::emplace_hint;
+    using Base::try_emplace;
+    using Base::extract;
+    using Base::merge;
+    using Base::swap;
+    using Base::rehash;
+    using Base::reserve;
+    using Base::at;
+    using Base::contains;
+    using Base::count;
+    using Base::equal_range;
+    using Base::find;
+    using Base::operator[];
+    using Base::bucket_count;
+    using Base::load_factor;
+    using Base::max_load_factor;
+    using Base::get_allocator;
+    using Base::hash_function;
+    using Base::hash;
+    using Base::key_eq;
+    typename Base::hasher hash_funct() { return this->hash_function(); }
+    void resize(typename Base::size_type hint) { this->rehash(hint); }
+};
+
+template <class Key, class Value, class Hash, class Eq, class Alloc>
+constexpr bool adaptive_hash_map<Key, Value, Hash, Eq, Alloc>::stores_values_inline;
+
 // -----------------------------------------------------------------------------
 // phmap::parallel_flat_hash_set
 // -----------------------------------------------------------------------------
@@ -5215,6 +5483,11 @@ namespace phmap {
         return phmap::priv::erase_if(c, std::move(pred));
     }
 
+    template <class K, class V, class Hash, class Eq, class Alloc, class Pred> 
+    std::size_t erase_if(phmap::adaptive_hash_map<K, V, Hash, Eq, Alloc>& c, Pred pred) {
+        return phmap::priv::erase_if(c, std::move(pred));
+    }
+
     template <class K, class V, class Hash, class Eq, class Alloc, size_t N, class Mtx_, class Pred> 
     std::size_t erase_if(phmap::parallel_flat_hash_map<K, V, Hash, Eq, Alloc, N, Mtx_>& c, Pred pred) {
         return phmap::priv::erase_if(c, std::move(pred));
@@ -5225,6 +5498,294 @@ namespace phmap {
         return phmap::priv::erase_if(c, std::move(pred));
     }
 
+    // ======== set algebra for phmap set containers ===============================
+    // The elements of the smaller set are looked up in the larger one in batches:
+    // the hashes of a batch are computed and their probe positions prefetched
+    // before any lookup is done. Results are reserved upfront.
+    //
+    // For parallel sets (which must have the same N, hasher and key_equal), a
+    // given key is in the same submap in both sets, so the operation is done
+    // submap by submap, concurrently when an execution policy is provided.
+    // ----------------------------------------------------------------------------
+    namespace priv {
+        // Calls `f(elem, hashval)` for each element of `from` which is (if
+        // `Found`) or is not (if `!Found`) in `in`.
+        template <bool Found, class Set, class F>
+        void probe_batched(const Set& from, const Set& in, F&& f) {
+            constexpr size_t kSetOpBatch = 16;
+            const typename Set::value_type* elems[kSetOpBatch];
+            size_t hashes[kSetOpBatch];
+            size_t n = 0;
+            auto flush = [&]() {
+                // hash the batch, then prefetch, then probe (see phmap::hash_batch)
+                for (size_t i = 0; i < n; ++i)
+                    hashes[i] = in.hash(*elems[i]);
+                for (size_t i = 0; i < n; ++i)
+                    in.prefetch_hash(hashes[i]);
+                for (size_t i = 0; i < n; ++i)
+                    if (in.contains(*elems[i], hashes[i]) == Found)
+                        f(*elems[i], hashes[i]);
+                n = 0;
+            };
+            for (const auto& v : from) {
+                elems[n] = &v;
+                if (++n == kSetOpBatch)
+                    flush();
+            }
+            flush();
+        }
+
+        template <class Set>
+        size_t intersection_size(const Set& a, const Set& b) {
+            const Set& small = a.size() <= b.size() ? a : b;
+            const Set& large = a.size() <= b.size() ? b : a;
+            size_t cnt = 0;
+            probe_batched<true>(small, large, [&cnt](const typename Set::value_type&, size_t) { ++cnt; });
+            return cnt;
+        }
+
+        template <class Set>
+        void set_intersection(const Set& a, const Set& b, Set& out) {
+            const Set& small = a.size() <= b.size() ? a : b;
+            const Set& large = a.size() <= b.size() ? b : a;
+            out.reserve(out.size() + small.size());
+            probe_batched<true>(small, large, [&out](const typename Set::value_type& v, size_t hashval) {
+                out.emplace_with_hash(hashval, v);
+            });
+        }
+
+        template <class Set>
+        void set_union(const Set& a, const Set& b, Set& out) {
+            const Set& small = a.size() <= b.size() ? a : b;
+            const Set& large = a.size() <= b.size() ? b : a;
+            out.reserve(out.size() + a.size() + b.size());
+            for (const auto& v : large)
+                out.insert(v);
+            probe_batched<false>(small, large, [&out](const typename Set::value_type& v, size_t hashval) {
+                out.emplace_with_hash(hashval, v);
+            });
+        }
+
+        template <class Set>
+        void set_difference(const Set& a, const Set& b, Set& out) {
+            if (b.size() < a.size() && out.empty()) {
+                // fewer lookups if we start from a copy of `a` and erase `b`
+                out = a;
+                probe_batched<true>(b, a, [&out](const typename Set::value_type& v, size_t hashval) {
+                    out.erase(out.find(v, hashval));
+                });
+            } else {
+                out.reserve(out.size() + a.size());
+                probe_batched<false>(a, b, [&out](const typename Set::value_type& v, size_t hashval) {
+                    out.emplace_with_hash(hashval, v);
+                });
+            }
+        }
+
+        template <class PSet, class F>
+        void for_each_submap(const PSet& a, const PSet& b, PSet& out, F&& f) {
+            using Embedded = typename PSet::EmbeddedSet;
+            for (size_t i = 0; i < a.subcnt(); ++i) {
+                a.with_submap(i, [&](const Embedded& sa) {
+                    b.with_submap(i, [&](const Embedded& sb) {
+                        out.with_submap_m(i, [&](Embedded& so) { f(sa, sb, so); });
+                    });
+                });
+            }
+        }
+
+#if __cplusplus >= 201703L
+        template <size_t NumSubmaps, class ExecutionPolicy, class PSet, class F>
+        void for_each_submap(ExecutionPolicy&& policy, const PSet& a, const PSet& b, PSet& out, F&& f) {
+            using Embedded = typename PSet::EmbeddedSet;
+            std::array<size_t, NumSubmaps> idx;
+            for (size_t i = 0; i < idx.size(); ++i)
+                idx[i] = i;
+            std::for_each(std::forward<ExecutionPolicy>(policy), idx.begin(), idx.end(), [&](size_t i) {
+                a.with_submap(i, [&](const Embedded& sa) {
+                    b.with_submap(i, [&](const Embedded& sb) {
+                        out.with_submap_m(i, [&](Embedded& so) { f(sa, sb, so); });
+                    });
+                });
+            });
+        }
+#endif
+    }  // namespace priv
+
+    // ---------------------------------------------------------------------------
+    template <class T, class Hash, class Eq, class Alloc>
+    size_t intersection_size(const phmap::flat_hash_set<T, Hash, Eq, Alloc>& a,
+                             const phmap::flat_hash_set<T, Hash, Eq, Alloc>& b) {
+        return &a == &b ? a.size() : phmap::priv::intersection_size(a, b);
+    }
+
+    template <class T, class Hash, class Eq, class Alloc>
+    phmap::flat_hash_set<T, Hash, Eq, Alloc> set_intersection(const phmap::flat_hash_set<T, Hash, Eq, Alloc>& a,
+                                                              const phmap::flat_hash_set<T, Hash, Eq, Alloc>& b) {
+        phmap::flat_hash_set<T, Hash, Eq, Alloc> res(0, a.hash_function(), a.key_eq(), a.get_allocator());
+        phmap::priv::set_intersection(a, b, res);
+        return res;
+    }
+
+    template <class T, class Hash, class Eq, class Alloc>
+    phmap::flat_hash_set<T, Hash, Eq, Alloc> set_union(const phmap::flat_hash_set<T, Hash, Eq, Alloc>& a,
+                                                       const phmap::flat_hash_set<T, Hash, Eq, Alloc>& b) {
+        phmap::flat_hash_set<T, Hash, Eq, Alloc> res(0, a.hash_function(), a.key_eq(), a.get_allocator());
+        phmap::priv::set_union(a, b, res);
+        return res;
+    }
+
+    // returns the elements of `a` which are not in `b`
+    template <class T, class Hash, class Eq, class Alloc>
+    phmap::flat_hash_set<T, Hash, Eq, Alloc> set_difference(const phmap::flat_hash_set<T, Hash, Eq, Alloc>& a,
+                                                            const phmap::flat_hash_set<T, Hash, Eq, Alloc>& b) {
+        phmap::flat_hash_set<T, Hash, Eq, Alloc> res(0, a.hash_function(), a.key_eq(), a.get_allocator());
+        if (&a != &b)
+            phmap::priv::set_difference(a, b, res);
+        return res;
+    }
+
+    // ---------------------------------------------------------------------------
+    template <class T, class Hash, class Eq, class Alloc, size_t N, class Mtx_>
+    size_t intersection_size(const phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>& a,
+                             const phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>& b) {
+        if (&a == &b)
+            return a.size();
+        using Embedded = typename phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>::EmbeddedSet;
+        size_t cnt = 0;
+        for (size_t i = 0; i < a.subcnt(); ++i)
+            a.with_submap(i, [&](const Embedded& sa) {
+                b.with_submap(i, [&](const Embedded& sb) { cnt += phmap::priv::intersection_size(sa, sb); });
+            });
+        return cnt;
+    }
+
+    template <class T, class Hash, class Eq, class Alloc, size_t N, class Mtx_>
+    phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_> 
+    set_intersection(const phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>& a,
+                     const phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>& b) {
+        using Set = phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>;
+        if (&a == &b)
+            return a;
+        Set res(0, a.hash_function(), a.key_eq(), a.get_allocator());
+        phmap::priv::for_each_submap(a, b, res, [](const typename Set::EmbeddedSet& sa, 
+                                                   const typename Set::EmbeddedSet& sb,
+                                                   typename Set::EmbeddedSet& so) {
+            phmap::priv::set_intersection(sa, sb, so);
+        });
+        return res;
+    }
+
+    template <class T, class Hash, class Eq, class Alloc, size_t N, class Mtx_>
+    phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_> 
+    set_union(const phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>& a,
+              const phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>& b) {
+        using Set = phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>;
+        if (&a == &b)
+            return a;
+        Set res(0, a.hash_function(), a.key_eq(), a.get_allocator());
+        phmap::priv::for_each_submap(a, b, res, [](const typename Set::EmbeddedSet& sa, 
+                                                   const typename Set::EmbeddedSet& sb,
+                                                   typename Set::EmbeddedSet& so) {
+            phmap::priv::set_union(sa, sb, so);
+        });
+        return res;
+    }
+
+    // returns the elements of `a` which are not in `b`
+    template <class T, class Hash, class Eq, class Alloc, size_t N, class Mtx_>
+    phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_> 
+    set_difference(const phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>& a,
+                   const phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>& b) {
+        using Set = phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>;
+        Set res(0, a.hash_function(), a.key_eq(), a.get_allocator());
+        if (&a == &b)
+            return res;
+        phmap::priv::for_each_submap(a, b, res, [](const typename Set::EmbeddedSet& sa, 
+                                                   const typename Set::EmbeddedSet& sb,
+                                                   typename Set::EmbeddedSet& so) {
+            phmap::priv::set_difference(sa, sb, so);
+        });
+        return res;
+    }
+
+#if __cplusplus >= 201703L
+    // same as above, but the submaps are processed according to `policy`, for
+    // example concurrently with `std::execution::par`.
+    // ---------------------------------------------------------------------------
+    template <class ExecutionPolicy, class T, class Hash, class Eq, class Alloc, size_t N, class Mtx_>
+    size_t intersection_size(ExecutionPolicy&& policy,
+                             const phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>& a,
+                             const phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>& b) {
+        using Set = phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>;
+        if (&a == &b)
+            return a.size();
+        std::array<size_t, (size_t(1) << N)> cnt;
+        std::array<size_t, (size_t(1) << N)> idx;
+        for (size_t i = 0; i < idx.size(); ++i)
+            idx[i] = i;
+        std::for_each(std::forward<ExecutionPolicy>(policy), idx.begin(), idx.end(), [&](size_t i) {
+            a.with_submap(i, [&](const typename Set::EmbeddedSet& sa) {
+                b.with_submap(i, [&](const typename Set::EmbeddedSet& sb) { 
+                    cnt[i] = phmap::priv::intersection_size(sa, sb); 
+                });
+            });
+        });
+        size_t res = 0;
+        for (auto c : cnt)
+            res += c;
+        return res;
+    }
+
+    template <class ExecutionPolicy, class T, class Hash, class Eq, class Alloc, size_t N, class Mtx_>
+    phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_> 
+    set_intersection(ExecutionPolicy&& policy,
+                     const phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>& a,
+                     const phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>& b) {
+        using Set = phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>;
+        if (&a == &b)
+            return a;
+        Set res(0, a.hash_function(), a.key_eq(), a.get_allocator());
+        phmap::priv::for_each_submap<(size_t(1) << N)>(std::forward<ExecutionPolicy>(policy), a, b, res, 
+                                     [](const auto& sa, const auto& sb, auto& so) {
+                                         phmap::priv::set_intersection(sa, sb, so);
+                                     });
+        return res;
+    }
+
+    template <class ExecutionPolicy, class T, class Hash, class Eq, class Alloc, size_t N, class Mtx_>
+    phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_> 
+    set_union(ExecutionPolicy&& policy,
+              const phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>& a,
+              const phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>& b) {
+        using Set = phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>;
+        if (&a == &b)
+            return a;
+        Set res(0, a.hash_function(), a.key_eq(), a.get_allocator());
+        phmap::priv::for_each_submap<(size_t(1) << N)>(std::forward<ExecutionPolicy>(policy), a, b, res, 
+                                     [](const auto& sa, const auto& sb, auto& so) {
+                                         phmap::priv::set_union(sa, sb, so);
+                                     });
+        return res;
+    }
+
+    template <class ExecutionPolicy, class T, class Hash, class Eq, class Alloc, size_t N, class Mtx_>
+    phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_> 
+    set_difference(ExecutionPolicy&& policy,
+                   const phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>& a,
+                   const phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>& b) {
+        using Set = phmap::parallel_flat_hash_set<T, Hash, Eq, Alloc, N, Mtx_>;
+        Set res(0, a.hash_function(), a.key_eq(), a.get_allocator());
+        if (&a == &b)
+            return res;
+        phmap::priv::for_each_submap<(size_t(1) << N)>(std::forward<ExecutionPolicy>(policy), a, b, res, 
+                                     [](const auto& sa, const auto& sb, auto& so) {
+                                         phmap::priv::set_difference(sa, sb, so);
+                                     });
+        return res;
+    }
+#endif
+
 } // phmap
 
 #ifdef _MSC_VER
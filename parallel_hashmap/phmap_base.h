@@ -49,6 +49,7 @@
 #include <mutex> // for std::lock
 
 #include "phmap_config.h"
+#include "phmap_utils.h"
 
 #ifdef PHMAP_HAVE_SHARED_MUTEX
     #include <shared_mutex>  // after "phmap_config.h"
@@ -548,6 +549,20 @@ public:
         return P::apply(std::forward<F>(f), std::forward<Ts>(ts)...);
     }
 
+    // Calls `f(k)` where `k` is the key of the element in `slot`, and returns the
+    // result. Used by lookups and rehashing, which only need the key.
+    //
+    // OPTIONAL: policies storing their elements out-of-line can provide
+    // `probe_key(slot)`, returning a copy of the key kept in the slot itself, so
+    // that the element does not need to be dereferenced. Defaults to:
+    //
+    //     apply(f, element(slot))
+    template <class F, class P = Policy>
+    static auto apply_key(F&& f, slot_type* slot)
+        -> decltype(P::apply(std::forward<F>(f), element(slot))) {
+        return apply_key_impl(std::forward<F>(f), slot, 0);
+    }
+
     // Returns the "key" portion of the slot.
     // Used for node handle manipulation.
     template <class P = Policy>
@@ -565,6 +580,19 @@ public:
 
 private:
 
+    // Use auto -> decltype as an enabler.
+    template <class F, class P = Policy>
+    static auto apply_key_impl(F&& f, slot_type* slot, int)
+        -> decltype(std::forward<F>(f)(P::probe_key(slot))) {
+        return std::forward<F>(f)(P::probe_key(slot));
+    }
+
+    template <class F>
+    static auto apply_key_impl(F&& f, slot_type* slot, char)
+        -> decltype(Policy::apply(std::forward<F>(f), element(slot))) {
+        return Policy::apply(std::forward<F>(f), element(slot));
+    }
+
     // Use auto -> decltype as an enabler.
     template <class Alloc, class P = Policy>
     static auto transfer_impl(Alloc* alloc, slot_type* new_slot,
@@ -3689,6 +3717,16 @@ template <int&... ExplicitArgumentBarrier, typename T, size_t N>
 constexpr Span<const T> MakeConstSpan(const T (&array)[N]) noexcept {
   return Span<const T>(array, N);
 }
+
+#if !defined(PHMAP_USE_ABSL_HASH)
+// same hash as a std::vector of the same values
+template <typename T>
+struct Hash<Span<T>> {
+  size_t operator()(Span<T> s) const noexcept {
+    return priv::hash_range(s.data(), s.size());
+  }
+};
+#endif
 }  // namespace phmap
 
 // ---------------------------------------------------------------------------
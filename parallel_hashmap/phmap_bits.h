@@ -407,6 +407,21 @@ PHMAP_BASE_INTERNAL_FORCEINLINE uint32_t CountTrailingZerosNonZero32(uint32_t n)
 #endif
 }
 
+PHMAP_BASE_INTERNAL_FORCEINLINE uint32_t Popcount64Slow(uint64_t n) {
+    n = n - ((n >> 1) & 0x5555555555555555);
+    n = (n & 0x3333333333333333) + ((n >> 2) & 0x3333333333333333);
+    n = (n + (n >> 4)) & 0x0F0F0F0F0F0F0F0F;
+    return static_cast<uint32_t>((n * 0x0101010101010101) >> 56);
+}
+
+PHMAP_BASE_INTERNAL_FORCEINLINE uint32_t Popcount64(uint64_t n) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint32_t>(__builtin_popcountll(n));
+#else
+    return Popcount64Slow(n);
+#endif
+}
+
 #undef PHMAP_BASE_INTERNAL_FORCEINLINE
 
 }  // namespace base_internal
@@ -0,0 +1,1471 @@
+#if !defined(phmap_compact_h_guard_)
+#define phmap_compact_h_guard_
+
+// ---------------------------------------------------------------------------
+// Copyright (c) 2019, Gregory Popovitch - greg7mdp@gmail.com
+//
+//       node hash containers with compressed 32 bit node references
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+// IMPLEMENTATION DETAILS
+//
+// The `node` hash containers store one pointer per slot, so on 64 bit builds
+// every slot costs 8 bytes plus one control byte. The `compact_node` variants
+// instead allocate their nodes from a node arena owned by the table, and the
+// slot array holds a 32 bit reference into that arena:
+//
+//     31     28 27                                  0
+//    +---------+-------------------------------------+
+//    |   tag   |        index into the node arena    |
+//    +---------+-------------------------------------+
+//
+// The tag holds the 4 most significant bits of the (mixed) hash. On lookup,
+// the H2 match from the control bytes is first confirmed against the tag, so
+// that most false positive H2 matches are rejected without dereferencing the
+// node.
+//
+// The arena is a list of chunks of geometrically increasing size, so nodes
+// never move once allocated (pointers and references to elements stay valid
+// until the element is erased, as for `node_hash_map`). Each table can hold up
+// to 2^28 elements. The parallel variants have one arena per submap, so a
+// `parallel_compact_node_hash_map` with N=4 can hold up to 2^32 elements.
+// ---------------------------------------------------------------------------
+
+#include "phmap.h"
+
+namespace phmap {
+
+namespace priv {
+
+// --------------------------------------------------------------------------
+// Pointer-stable storage for nodes of type T, addressed by a 32 bit index.
+//
+// Chunk `c` holds `kFirstChunkSize << c` nodes, so the chunk owning an index
+// is found with a single leading zero count. Released nodes are chained in a
+// free list threaded through their (destroyed) storage, and reused first.
+// --------------------------------------------------------------------------
+template <class T>
+class NodeArena
+{
+public:
+    static constexpr uint32_t kIndexBits = 28;
+    static constexpr uint32_t kMaxNodes  = uint32_t(1) << kIndexBits;
+
+    NodeArena() {
+        for (auto& c : chunks_)
+            c = nullptr;
+    }
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    T* get(uint32_t idx) const {
+        uint32_t c = chunk_of(idx);
+        return reinterpret_cast<T*>(chunks_[c] + (idx - chunk_start(c)));
+    }
+
+    // Returns the index of an unconstructed node.
+    template <class Alloc>
+    uint32_t allocate(Alloc* alloc) {
+        if (free_ != kNoFree) {
+            uint32_t idx = free_;
+            std::memcpy(&free_, get(idx), sizeof(uint32_t));
+            return idx;
+        }
+        if (PHMAP_PREDICT_FALSE(next_ == kMaxNodes))
+            phmap::base_internal::ThrowStdLengthError("phmap: node arena is full");
+        uint32_t c = chunk_of(next_);
+        if (!chunks_[c]) {
+            chunks_[c] = static_cast<Storage*>(
+                Allocate<alignof(Storage)>(alloc, chunk_size(c) * sizeof(Storage)));
+        }
+        return next_++;
+    }
+
+    // The node must have been destroyed already.
+    void release(uint32_t idx) {
+        std::memcpy(get(idx), &free_, sizeof(uint32_t));
+        free_ = idx;
+    }
+
+    // Forgets all nodes, but keeps the chunks for reuse.
+    void reset() {
+        next_ = 0;
+        free_ = kNoFree;
+    }
+
+    // Returns all chunks to the allocator. All nodes must have been destroyed.
+    template <class Alloc>
+    void deallocate(Alloc* alloc) {
+        for (uint32_t c = 0; c < kNumChunks; ++c) {
+            if (chunks_[c]) {
+                Deallocate<alignof(Storage)>(alloc, chunks_[c], chunk_size(c) * sizeof(Storage));
+                chunks_[c] = nullptr;
+            }
+        }
+        reset();
+    }
+
+    void swap(NodeArena& o) noexcept {
+        using std::swap;
+        for (uint32_t c = 0; c < kNumChunks; ++c)
+            swap(chunks_[c], o.chunks_[c]);
+        swap(next_, o.next_);
+        swap(free_, o.free_);
+    }
+
+    size_t allocated_bytes() const {
+        size_t sz = 0;
+        for (uint32_t c = 0; c < kNumChunks; ++c)
+            if (chunks_[c])
+                sz += chunk_size(c) * sizeof(Storage);
+        return sz;
+    }
+
+private:
+    static constexpr uint32_t kFirstChunkShift = 4;
+    static constexpr uint32_t kNumChunks = kIndexBits - kFirstChunkShift + 1;
+    static constexpr uint32_t kNoFree = ~uint32_t(0);
+
+    using Storage = typename phmap::aligned_storage<
+        (sizeof(T) > sizeof(uint32_t) ? sizeof(T) : sizeof(uint32_t)), alignof(T)>::type;
+
+    static uint32_t chunk_of(uint32_t idx) {
+        return 31 - base_internal::CountLeadingZeros32((idx >> kFirstChunkShift) + 1);
+    }
+    static uint32_t chunk_start(uint32_t c) { return ((uint32_t(1) << c) - 1) << kFirstChunkShift; }
+    static size_t   chunk_size(uint32_t c)  { return size_t(1) << (c + kFirstChunkShift); }
+
+    Storage* chunks_[kNumChunks];
+    uint32_t next_ = 0;      // first never allocated index
+    uint32_t free_ = kNoFree; // head of the free list
+};
+
+// ----------------------------------------------------------------------------
+//                R A W _ C O M P A C T _ H A S H _ S E T
+// ----------------------------------------------------------------------------
+// Same probing scheme and control bytes as `raw_hash_set`, but the slots are
+// 32 bit references into a NodeArena (see implementation details above).
+//
+// The Policy is one of the node policies (NodeHashSetPolicy/NodeHashMapPolicy),
+// of which only the key extraction (`apply`) and `value` are used.
+//
+// This class also provides the internal interface used by `parallel_hash_set`,
+// so it can be used as its `RefSet` template parameter.
+// ----------------------------------------------------------------------------
+template <class Policy, class Hash, class Eq, class Alloc>
+class raw_compact_hash_set
+{
+    using PolicyTraits = hash_policy_traits<Policy>;
+    using KeyArgImpl =
+        KeyArg<IsTransparent<Eq>::value && IsTransparent<Hash>::value>;
+
+public:
+    using init_type       = typename PolicyTraits::init_type;
+    using key_type        = typename PolicyTraits::key_type;
+    using slot_type       = uint32_t;
+    using allocator_type  = Alloc;
+    using size_type       = size_t;
+    using difference_type = ptrdiff_t;
+    using hasher          = Hash;
+    using key_equal       = Eq;
+    using policy_type     = Policy;
+    using value_type      = typename PolicyTraits::value_type;
+    using reference       = value_type&;
+    using const_reference = const value_type&;
+    using pointer         = value_type*;
+    using const_pointer   = const value_type*;
+
+    template <class K>
+    using key_arg = typename KeyArgImpl::template type<K, key_type>;
+
+private:
+    using Arena = NodeArena<value_type>;
+    using Layout = phmap::priv::Layout<ctrl_t, slot_type>;
+    using AllocTraits = phmap::allocator_traits<allocator_type>;
+    using ValueAlloc = typename AllocTraits::template rebind_alloc<value_type>;
+    using ValueAllocTraits = typename AllocTraits::template rebind_traits<value_type>;
+
+    static constexpr uint32_t kIndexMask = Arena::kMaxNodes - 1;
+    static constexpr uint32_t kTagBits   = 32 - Arena::kIndexBits;
+
+    static Layout MakeLayout(size_t capacity) {
+        assert(IsValidCapacity(capacity));
+        return Layout(capacity + Group::kWidth + 1, capacity);
+    }
+
+    static uint32_t Tag(size_t hashval) {
+        return static_cast<uint32_t>(hashval >> (sizeof(size_t) * 8 - kTagBits))
+            << Arena::kIndexBits;
+    }
+
+    template <class T>
+    struct SameAsElementReference
+        : std::is_same<typename std::remove_cv<typename std::remove_reference<reference>::type>::type,
+                       typename std::remove_cv<typename std::remove_reference<T>::type>::type> {};
+
+    template <class T>
+    using RequiresInsertable = typename std::enable_if<
+        phmap::disjunction<std::is_convertible<T, init_type>,
+                           SameAsElementReference<T>>::value, int>::type;
+
+    template <class T>
+    using RequiresNotInit =
+        typename std::enable_if<!std::is_same<T, init_type>::value, int>::type;
+
+    template <class... Ts>
+    using IsDecomposable = priv::IsDecomposable<void, PolicyTraits, Hash, Eq, Ts...>;
+
+public:
+    class iterator
+    {
+        friend class raw_compact_hash_set;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename raw_compact_hash_set::value_type;
+        using reference =
+            phmap::conditional_t<PolicyTraits::constant_iterators::value,
+                                 const value_type&, value_type&>;
+        using pointer = phmap::remove_reference_t<reference>*;
+        using difference_type = typename raw_compact_hash_set::difference_type;
+
+        iterator() {}
+
+        // PRECONDITION: not an end() iterator.
+        reference operator*() const { return *arena_->get(*slot_ & kIndexMask); }
+
+        // PRECONDITION: not an end() iterator.
+        pointer operator->() const { return &operator*(); }
+
+        // PRECONDITION: not an end() iterator.
+        iterator& operator++() {
+            ++ctrl_;
+            ++slot_;
+            skip_empty_or_deleted();
+            return *this;
+        }
+
+        iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b) {
+            return a.ctrl_ == b.ctrl_;
+        }
+        friend bool operator!=(const iterator& a, const iterator& b) {
+            return !(a == b);
+        }
+
+    private:
+        iterator(ctrl_t* ctrl) : ctrl_(ctrl) {}  // for end()
+        iterator(ctrl_t* ctrl, slot_type* slot, const Arena* arena) :
+            ctrl_(ctrl), slot_(slot), arena_(arena) {}
+
+        void skip_empty_or_deleted() {
+            // as in raw_hash_set, reading past the ctrl bytes into the slots is
+            // fine since they are allocated contiguously.
+            while (IsEmptyOrDeleted(*ctrl_)) {
+                uint32_t shift = Group{ctrl_}.CountLeadingEmptyOrDeleted();
+                ctrl_ += shift;
+                slot_ += shift;
+            }
+        }
+
+        ctrl_t*      ctrl_  = nullptr;
+        slot_type*   slot_  = nullptr;
+        const Arena* arena_ = nullptr;
+    };
+
+    class const_iterator
+    {
+        friend class raw_compact_hash_set;
+
+    public:
+        using iterator_category = typename iterator::iterator_category;
+        using value_type = typename raw_compact_hash_set::value_type;
+        using reference = typename raw_compact_hash_set::const_reference;
+        using pointer = typename raw_compact_hash_set::const_pointer;
+        using difference_type = typename raw_compact_hash_set::difference_type;
+
+        const_iterator() {}
+        // Implicit construction from iterator.
+        const_iterator(iterator i) : inner_(std::move(i)) {}
+
+        reference operator*() const { return *inner_; }
+        pointer operator->() const { return inner_.operator->(); }
+
+        const_iterator& operator++() {
+            ++inner_;
+            return *this;
+        }
+        const_iterator operator++(int) { return inner_++; }
+
+        friend bool operator==(const const_iterator& a, const const_iterator& b) {
+            return a.inner_ == b.inner_;
+        }
+        friend bool operator!=(const const_iterator& a, const const_iterator& b) {
+            return !(a == b);
+        }
+
+    private:
+        iterator inner_;
+    };
+
+    // Extension API: support for lazy emplace, see raw_hash_set::constructor.
+    class constructor
+    {
+        friend class raw_compact_hash_set;
+
+    public:
+        template <class... Args>
+        void operator()(Args&&... args) const {
+            assert(*set_);
+            (*set_)->emplace_at(offset_, std::forward<Args>(args)...);
+            *set_ = nullptr;
+        }
+
+    private:
+        constructor(raw_compact_hash_set** set, size_t offset) : set_(set), offset_(offset) {}
+
+        raw_compact_hash_set** set_;
+        size_t offset_;
+    };
+
+    raw_compact_hash_set() noexcept(
+        std::is_nothrow_default_constructible<hasher>::value&&
+        std::is_nothrow_default_constructible<key_equal>::value&&
+        std::is_nothrow_default_constructible<allocator_type>::value) {}
+
+    explicit raw_compact_hash_set(size_t bucket_cnt, const hasher& hashfn = hasher(),
+                                  const key_equal& eq = key_equal(),
+                                  const allocator_type& alloc = allocator_type())
+        : settings_(0, hashfn, eq, alloc) {
+        if (bucket_cnt) {
+            size_t new_capacity = NormalizeCapacity(bucket_cnt);
+            initialize_slots(new_capacity);
+            capacity_ = new_capacity;
+        }
+    }
+
+    raw_compact_hash_set(size_t bucket_cnt, const hasher& hashfn,
+                         const allocator_type& alloc)
+        : raw_compact_hash_set(bucket_cnt, hashfn, key_equal(), alloc) {}
+
+    raw_compact_hash_set(size_t bucket_cnt, const allocator_type& alloc)
+        : raw_compact_hash_set(bucket_cnt, hasher(), key_equal(), alloc) {}
+
+    explicit raw_compact_hash_set(const allocator_type& alloc)
+        : raw_compact_hash_set(0, hasher(), key_equal(), alloc) {}
+
+    template <class InputIter>
+    raw_compact_hash_set(InputIter first, InputIter last, size_t bucket_cnt = 0,
+                         const hasher& hashfn = hasher(), const key_equal& eq = key_equal(),
+                         const allocator_type& alloc = allocator_type())
+        : raw_compact_hash_set(bucket_cnt, hashfn, eq, alloc) {
+        insert(first, last);
+    }
+
+    template <class T, RequiresNotInit<T> = 0, RequiresInsertable<T> = 0>
+    raw_compact_hash_set(std::initializer_list<T> init, size_t bucket_cnt = 0,
+                         const hasher& hashfn = hasher(), const key_equal& eq = key_equal(),
+                         const allocator_type& alloc = allocator_type())
+        : raw_compact_hash_set(init.begin(), init.end(), bucket_cnt, hashfn, eq, alloc) {}
+
+    raw_compact_hash_set(std::initializer_list<init_type> init, size_t bucket_cnt = 0,
+                         const hasher& hashfn = hasher(), const key_equal& eq = key_equal(),
+                         const allocator_type& alloc = allocator_type())
+        : raw_compact_hash_set(init.begin(), init.end(), bucket_cnt, hashfn, eq, alloc) {}
+
+    raw_compact_hash_set(const raw_compact_hash_set& that)
+        : raw_compact_hash_set(that, AllocTraits::select_on_container_copy_construction(
+                                   that.alloc_ref())) {}
+
+    raw_compact_hash_set(const raw_compact_hash_set& that, const allocator_type& a)
+        : raw_compact_hash_set(0, that.hash_ref(), that.eq_ref(), a) {
+        rehash(that.capacity());
+        // the table is empty, so we don't need to look for duplicates.
+        for (const auto& v : that) {
+            const size_t hashval = PolicyTraits::apply(HashElement{hash_ref()}, v);
+            size_t offset = find_first_non_full(hashval);
+            pending_tag_ = Tag(hashval);
+            emplace_at(offset, v);
+            set_ctrl(offset, H2(hashval));
+        }
+        size_ = that.size();
+        growth_left() -= that.size();
+    }
+
+    raw_compact_hash_set(raw_compact_hash_set&& that) noexcept(
+        std::is_nothrow_copy_constructible<hasher>::value&&
+        std::is_nothrow_copy_constructible<key_equal>::value&&
+        std::is_nothrow_copy_constructible<allocator_type>::value)
+        : ctrl_(phmap::exchange(that.ctrl_, EmptyGroup<std::true_type>())),
+          slots_(phmap::exchange(that.slots_, nullptr)),
+          size_(phmap::exchange(that.size_, 0)),
+          capacity_(phmap::exchange(that.capacity_, 0)),
+          settings_(std::move(that.settings_)) {
+        arena_.swap(that.arena_);
+        that.growth_left() = 0;
+    }
+
+    raw_compact_hash_set(raw_compact_hash_set&& that, const allocator_type& a)
+        : settings_(0, that.hash_ref(), that.eq_ref(), a) {
+        if (a == that.alloc_ref()) {
+            swap_storage(that);
+        } else {
+            reserve(that.size());
+            for (auto& elem : that)
+                insert(std::move(elem));
+        }
+    }
+
+    raw_compact_hash_set& operator=(const raw_compact_hash_set& that) {
+        raw_compact_hash_set tmp(that,
+                                 AllocTraits::propagate_on_container_copy_assignment::value
+                                 ? that.alloc_ref() : alloc_ref());
+        swap(tmp);
+        return *this;
+    }
+
+    raw_compact_hash_set& operator=(raw_compact_hash_set&& that) noexcept(
+        phmap::allocator_traits<allocator_type>::is_always_equal::value&&
+        std::is_nothrow_move_assignable<hasher>::value&&
+        std::is_nothrow_move_assignable<key_equal>::value) {
+        raw_compact_hash_set tmp(std::move(that));
+        swap(tmp);
+        return *this;
+    }
+
+    ~raw_compact_hash_set() { destroy_slots(); }
+
+    iterator begin() {
+        auto it = iterator_at(0);
+        it.skip_empty_or_deleted();
+        return it;
+    }
+    iterator end() { return {ctrl_ + capacity_}; }
+
+    const_iterator begin() const { return const_cast<raw_compact_hash_set*>(this)->begin(); }
+    const_iterator end() const   { return const_cast<raw_compact_hash_set*>(this)->end(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const   { return end(); }
+
+    bool   empty() const    { return !size(); }
+    size_t size() const     { return size_; }
+    size_t capacity() const { return capacity_; }
+    size_t max_size() const { return Arena::kMaxNodes; }
+
+    PHMAP_ATTRIBUTE_REINITIALIZES void clear() {
+        if (empty())
+            return;
+        destroy_nodes();
+        arena_.reset();
+        size_ = 0;
+        reset_ctrl(capacity_);
+        reset_growth_left(capacity_);
+    }
+
+    template <class T, RequiresInsertable<T> = 0,
+              typename std::enable_if<IsDecomposable<T>::value, int>::type = 0,
+              T* = nullptr>
+    std::pair<iterator, bool> insert(T&& value) {
+        return emplace(std::forward<T>(value));
+    }
+
+    template <class T, RequiresInsertable<T> = 0,
+              typename std::enable_if<IsDecomposable<const T&>::value, int>::type = 0>
+    std::pair<iterator, bool> insert(const T& value) {
+        return emplace(value);
+    }
+
+    std::pair<iterator, bool> insert(init_type&& value) {
+        return emplace(std::move(value));
+    }
+
+    template <class T, RequiresInsertable<T> = 0,
+              typename std::enable_if<IsDecomposable<const T&>::value, int>::type = 0>
+    iterator insert(const_iterator, const T& value) {
+        return insert(value).first;
+    }
+
+    iterator insert(const_iterator, init_type&& value) {
+        return insert(std::move(value)).first;
+    }
+
+    template <class InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first)
+            emplace(*first);
+    }
+
+    template <class T, RequiresNotInit<T> = 0, RequiresInsertable<const T&> = 0>
+    void insert(std::initializer_list<T> ilist) {
+        insert(ilist.begin(), ilist.end());
+    }
+
+    void insert(std::initializer_list<init_type> ilist) {
+        insert(ilist.begin(), ilist.end());
+    }
+
+    // This overload kicks in if we can deduce the key from args, so that no
+    // node is allocated if an entry with the same key already exists.
+    template <class... Args, typename std::enable_if<
+                                 IsDecomposable<Args...>::value, int>::type = 0>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        return PolicyTraits::apply(EmplaceDecomposable{*this},
+                                   std::forward<Args>(args)...);
+    }
+
+    // Otherwise the node is constructed first, and released if the key was
+    // already present.
+    template <class... Args, typename std::enable_if<
+                                 !IsDecomposable<Args...>::value, int>::type = 0>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        uint32_t idx = arena_.allocate(&alloc_ref());
+        value_type* node = arena_.get(idx);
+        construct_node(node, std::forward<Args>(args)...);
+        return PolicyTraits::apply(InsertNode{*this, idx}, *node);
+    }
+
+    template <class... Args>
+    iterator emplace_hint(const_iterator, Args&&... args) {
+        return emplace(std::forward<Args>(args)...).first;
+    }
+
+    template <class... Args, typename std::enable_if<IsDecomposable<Args...>::value, int>::type = 0>
+    std::pair<iterator, bool> emplace_with_hash(size_t hashval, Args&&... args) {
+        return PolicyTraits::apply(EmplaceDecomposableHashval{*this, hashval},
+                                   std::forward<Args>(args)...);
+    }
+
+    template <class K = key_type, class F>
+    iterator lazy_emplace(const key_arg<K>& key, F&& f) {
+        return lazy_emplace_with_hash(key, this->hash(key), std::forward<F>(f));
+    }
+
+    template <class K = key_type, class F>
+    iterator lazy_emplace_with_hash(const key_arg<K>& key, size_t hashval, F&& f) {
+        size_t offset = _find_key(key, hashval);
+        if (offset == (size_t)-1) {
+            offset = prepare_insert(hashval);
+            lazy_emplace_at(offset, std::forward<F>(f));
+            this->set_ctrl(offset, H2(hashval));
+        }
+        return iterator_at(offset);
+    }
+
+    template <class K = key_type, class F>
+    void lazy_emplace_at(size_t& idx, F&& f) {
+        raw_compact_hash_set* s = this;
+        std::forward<F>(f)(constructor(&s, idx));
+        assert(!s);
+    }
+
+    template <class K = key_type, class F>
+    void emplace_single_with_hash(const key_arg<K>& key, size_t hashval, F&& f) {
+        size_t offset = _find_key(key, hashval);
+        if (offset == (size_t)-1) {
+            offset = prepare_insert(hashval);
+            lazy_emplace_at(offset, std::forward<F>(f));
+            this->set_ctrl(offset, H2(hashval));
+        } else
+            _erase(iterator_at(offset));
+    }
+
+    template <class K = key_type>
+    size_type erase(const key_arg<K>& key) {
+        auto it = find(key);
+        if (it == end()) return 0;
+        _erase(it);
+        return 1;
+    }
+
+    iterator erase(const_iterator cit) { return erase(cit.inner_); }
+
+    iterator erase(iterator it) {
+        assert(it != end());
+        auto res = it;
+        ++res;
+        _erase(it);
+        return res;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        while (first != last)
+            _erase(first++);
+        return last.inner_;
+    }
+
+    void _erase(iterator it) {
+        assert(it != end());
+        uint32_t idx = *it.slot_ & kIndexMask;
+        destroy_node(arena_.get(idx));
+        arena_.release(idx);
+        erase_meta_only(it);
+    }
+    void _erase(const_iterator cit) { _erase(cit.inner_); }
+
+    void swap(raw_compact_hash_set& that) noexcept(
+        IsNoThrowSwappable<hasher>() && IsNoThrowSwappable<key_equal>() &&
+        (!AllocTraits::propagate_on_container_swap::value ||
+         IsNoThrowSwappable<allocator_type>(typename AllocTraits::propagate_on_container_swap{}))) {
+        using std::swap;
+        swap_storage(that);
+        swap(hash_ref(), that.hash_ref());
+        swap(eq_ref(), that.eq_ref());
+        SwapAlloc(alloc_ref(), that.alloc_ref(), typename AllocTraits::propagate_on_container_swap{});
+    }
+
+    void rehash(size_t n) {
+        if (n == 0 && capacity_ == 0) return;
+        if (n == 0 && size_ == 0) {
+            destroy_slots();
+            return;
+        }
+        auto m = NormalizeCapacity((std::max)(n, size()));
+        if (n == 0 || m > capacity_)
+            resize(m);
+    }
+
+    void reserve(size_t n) { rehash(GrowthToLowerboundCapacity(n)); }
+
+    template <class K = key_type>
+    size_t count(const key_arg<K>& key) const {
+        return find(key) == end() ? size_t(0) : size_t(1);
+    }
+
+    void prefetch_hash(size_t hashval) const {
+        (void)hashval;
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        auto seq = probe(hashval);
+        _mm_prefetch((const char *)(ctrl_ + seq.offset()), _MM_HINT_NTA);
+        _mm_prefetch((const char *)(slots_ + seq.offset()), _MM_HINT_NTA);
+#elif defined(__GNUC__)
+        auto seq = probe(hashval);
+        __builtin_prefetch(static_cast<const void*>(ctrl_ + seq.offset()));
+        __builtin_prefetch(static_cast<const void*>(slots_ + seq.offset()));
+#endif
+    }
+
+    template <class K = key_type>
+    void prefetch(const key_arg<K>& key) const {
+        prefetch_hash(this->hash(key));
+    }
+
+    template <class K = key_type>
+    iterator find(const key_arg<K>& key, size_t hashval) {
+        size_t offset = _find_key(key, hashval);
+        return offset == (size_t)-1 ? end() : iterator_at(offset);
+    }
+
+    template <class K = key_type>
+    iterator find(const key_arg<K>& key) {
+        return find(key, this->hash(key));
+    }
+
+    template <class K = key_type>
+    const_iterator find(const key_arg<K>& key, size_t hashval) const {
+        return const_cast<raw_compact_hash_set*>(this)->find(key, hashval);
+    }
+
+    template <class K = key_type>
+    const_iterator find(const key_arg<K>& key) const {
+        return find(key, this->hash(key));
+    }
+
+    template <class K = key_type>
+    pointer find_ptr(const key_arg<K>& key, size_t hashval) {
+        size_t offset = _find_key(key, hashval);
+        return offset == (size_t)-1 ? nullptr : node_at(offset);
+    }
+
+    template <class K = key_type>
+    bool contains(const key_arg<K>& key) const {
+        return find(key) != end();
+    }
+
+    template <class K = key_type>
+    bool contains(const key_arg<K>& key, size_t hashval) const {
+        return find(key, hashval) != end();
+    }
+
+    template <class K = key_type>
+    std::pair<iterator, iterator> equal_range(const key_arg<K>& key) {
+        auto it = find(key);
+        if (it != end()) return {it, std::next(it)};
+        return {it, it};
+    }
+
+    template <class K = key_type>
+    std::pair<const_iterator, const_iterator> equal_range(const key_arg<K>& key) const {
+        auto it = find(key);
+        if (it != end()) return {it, std::next(it)};
+        return {it, it};
+    }
+
+    size_t bucket_count() const { return capacity_; }
+    float load_factor() const {
+        return capacity_ ? static_cast<float>(static_cast<double>(size()) / capacity_) : 0.0f;
+    }
+    float max_load_factor() const { return 1.0f; }
+    void max_load_factor(float) {
+        // Does nothing.
+    }
+
+    hasher hash_function() const { return hash_ref(); }
+    key_equal key_eq() const { return eq_ref(); }
+    allocator_type get_allocator() const { return alloc_ref(); }
+
+    // Bytes allocated by the table: control bytes, slots and node arena.
+    size_t allocated_bytes() const {
+        return (capacity_ ? MakeLayout(capacity_).AllocSize() : 0) + arena_.allocated_bytes();
+    }
+
+    friend bool operator==(const raw_compact_hash_set& a, const raw_compact_hash_set& b) {
+        if (a.size() != b.size()) return false;
+        const raw_compact_hash_set* outer = &a;
+        const raw_compact_hash_set* inner = &b;
+        if (outer->capacity() > inner->capacity())
+            std::swap(outer, inner);
+        for (const value_type& elem : *outer)
+            if (!inner->has_element(elem)) return false;
+        return true;
+    }
+
+    friend bool operator!=(const raw_compact_hash_set& a, const raw_compact_hash_set& b) {
+        return !(a == b);
+    }
+
+    friend void swap(raw_compact_hash_set& a,
+                     raw_compact_hash_set& b) noexcept(noexcept(a.swap(b))) {
+        a.swap(b);
+    }
+
+    template <class K>
+    size_t hash(const K& key) const {
+        return HashElement{hash_ref()}(key);
+    }
+
+private:
+    struct HashElement
+    {
+        template <class K, class... Args>
+        size_t operator()(const K& key, Args&&...) const {
+#if PHMAP_DISABLE_MIX
+            return h(key);
+#else
+            return phmap_mix<sizeof(size_t)>()(h(key));
+#endif
+        }
+        const hasher& h;
+    };
+
+    template <class K1>
+    struct EqualElement
+    {
+        template <class K2, class... Args>
+        bool operator()(const K2& lhs, Args&&...) const {
+            return eq(lhs, rhs);
+        }
+        const K1& rhs;
+        const key_equal& eq;
+    };
+
+    template <class K, class... Args>
+    std::pair<iterator, bool> emplace_decomposable(const K& key, size_t hashval,
+                                                   Args&&... args) {
+        size_t offset = _find_key(key, hashval);
+        if (offset == (size_t)-1) {
+            offset = prepare_insert(hashval);
+            emplace_at(offset, std::forward<Args>(args)...);
+            this->set_ctrl(offset, H2(hashval));
+            return {iterator_at(offset), true};
+        }
+        return {iterator_at(offset), false};
+    }
+
+    struct EmplaceDecomposable
+    {
+        template <class K, class... Args>
+        std::pair<iterator, bool> operator()(const K& key, Args&&... args) const {
+            return s.emplace_decomposable(key, s.hash(key), std::forward<Args>(args)...);
+        }
+        raw_compact_hash_set& s;
+    };
+
+    struct EmplaceDecomposableHashval
+    {
+        template <class K, class... Args>
+        std::pair<iterator, bool> operator()(const K& key, Args&&... args) const {
+            return s.emplace_decomposable(key, hashval, std::forward<Args>(args)...);
+        }
+        raw_compact_hash_set& s;
+        size_t hashval;
+    };
+
+    // Inserts the already constructed node `idx`, or releases it if its key is
+    // already present.
+    struct InsertNode
+    {
+        template <class K, class... Args>
+        std::pair<iterator, bool> operator()(const K& key, Args&&...) const {
+            size_t hashval = s.hash(key);
+            size_t offset = s._find_key(key, hashval);
+            if (offset != (size_t)-1) {
+                s.destroy_node(s.arena_.get(idx));
+                s.arena_.release(idx);
+                return {s.iterator_at(offset), false};
+            }
+            offset = s.prepare_insert(hashval);
+            s.slots_[offset] = s.pending_tag_ | idx;
+            s.set_ctrl(offset, H2(hashval));
+            return {s.iterator_at(offset), true};
+        }
+        raw_compact_hash_set& s;
+        uint32_t idx;
+    };
+
+    template <class... Args>
+    void construct_node(value_type* node, Args&&... args) {
+        ValueAlloc value_alloc(alloc_ref());
+        ValueAllocTraits::construct(value_alloc, node, std::forward<Args>(args)...);
+    }
+
+    void destroy_node(value_type* node) {
+        ValueAlloc value_alloc(alloc_ref());
+        ValueAllocTraits::destroy(value_alloc, node);
+    }
+
+    void destroy_nodes() {
+        for (size_t i = 0; i != capacity_; ++i)
+            if (IsFull(ctrl_[i]))
+                destroy_node(node_at(i));
+    }
+
+    value_type* node_at(size_t i) const { return arena_.get(slots_[i] & kIndexMask); }
+
+    void erase_meta_only(const_iterator it) {
+        assert(IsFull(*it.inner_.ctrl_) && "erasing a dangling iterator");
+        --size_;
+        const size_t index = (size_t)(it.inner_.ctrl_ - ctrl_);
+        const size_t index_before = (index - Group::kWidth) & capacity_;
+        const auto empty_after = Group(it.inner_.ctrl_).MatchEmpty();
+        const auto empty_before = Group(ctrl_ + index_before).MatchEmpty();
+
+        // see raw_hash_set::erase_meta_only()
+        bool was_never_full =
+            empty_before && empty_after &&
+            static_cast<size_t>(empty_after.TrailingZeros() +
+                                empty_before.LeadingZeros()) < Group::kWidth;
+
+        set_ctrl(index, was_never_full ? kEmpty : kDeleted);
+        growth_left() += was_never_full;
+    }
+
+    void initialize_slots(size_t new_capacity) {
+        assert(new_capacity);
+        auto layout = MakeLayout(new_capacity);
+        char* mem = static_cast<char*>(
+            Allocate<Layout::Alignment()>(&alloc_ref(), layout.AllocSize()));
+        ctrl_ = reinterpret_cast<ctrl_t*>(layout.template Pointer<0>(mem));
+        slots_ = layout.template Pointer<1>(mem);
+        reset_ctrl(new_capacity);
+        reset_growth_left(new_capacity);
+    }
+
+    void destroy_slots() {
+        if (!capacity_) {
+            arena_.deallocate(&alloc_ref());
+            return;
+        }
+        destroy_nodes();
+        arena_.deallocate(&alloc_ref());
+        auto layout = MakeLayout(capacity_);
+        Deallocate<Layout::Alignment()>(&alloc_ref(), ctrl_, layout.AllocSize());
+        ctrl_ = EmptyGroup<std::true_type>();
+        slots_ = nullptr;
+        size_ = 0;
+        capacity_ = 0;
+        growth_left() = 0;
+    }
+
+    // Nodes don't move, only their 32 bit references do.
+    void resize(size_t new_capacity) {
+        assert(IsValidCapacity(new_capacity));
+        auto* old_ctrl = ctrl_;
+        auto* old_slots = slots_;
+        const size_t old_capacity = capacity_;
+        initialize_slots(new_capacity);
+        capacity_ = new_capacity;
+
+        for (size_t i = 0; i != old_capacity; ++i) {
+            if (IsFull(old_ctrl[i])) {
+                size_t hashval = PolicyTraits::apply(
+                    HashElement{hash_ref()}, *arena_.get(old_slots[i] & kIndexMask));
+                size_t new_i = find_first_non_full(hashval);
+                set_ctrl(new_i, H2(hashval));
+                slots_[new_i] = old_slots[i];
+            }
+        }
+        if (old_capacity) {
+            auto layout = MakeLayout(old_capacity);
+            Deallocate<Layout::Alignment()>(&alloc_ref(), old_ctrl, layout.AllocSize());
+        }
+    }
+
+    // see raw_hash_set::drop_deletes_without_resize() for the algorithm.
+    void drop_deletes_without_resize() PHMAP_ATTRIBUTE_NOINLINE {
+        assert(IsValidCapacity(capacity_));
+        ConvertDeletedToEmptyAndFullToDeleted(ctrl_, capacity_);
+        for (size_t i = 0; i != capacity_; ++i) {
+            if (!IsDeleted(ctrl_[i])) continue;
+            size_t hashval = PolicyTraits::apply(HashElement{hash_ref()}, *node_at(i));
+            size_t new_i = find_first_non_full(hashval);
+
+            const auto probe_index = [&](size_t pos) {
+                return ((pos - probe(hashval).offset()) & capacity_) / Group::kWidth;
+            };
+
+            if (PHMAP_PREDICT_TRUE(probe_index(new_i) == probe_index(i))) {
+                set_ctrl(i, H2(hashval));
+                continue;
+            }
+            if (IsEmpty(ctrl_[new_i])) {
+                set_ctrl(new_i, H2(hashval));
+                slots_[new_i] = slots_[i];
+                set_ctrl(i, kEmpty);
+            } else {
+                assert(IsDeleted(ctrl_[new_i]));
+                set_ctrl(new_i, H2(hashval));
+                std::swap(slots_[i], slots_[new_i]);
+                --i;  // repeat
+            }
+        }
+        reset_growth_left(capacity_);
+    }
+
+    void rehash_and_grow_if_necessary() {
+        if (capacity_ == 0) {
+            resize(1);
+        } else if (size() <= CapacityToGrowth(capacity()) / 2) {
+            drop_deletes_without_resize();
+        } else {
+            resize(capacity_ * 2 + 1);
+        }
+    }
+
+    bool has_element(const value_type& elem, size_t hashval) const {
+        const uint32_t tag = Tag(hashval);
+        auto seq = probe(hashval);
+        while (true) {
+            Group g{ctrl_ + seq.offset()};
+            for (uint32_t i : g.Match((h2_t)H2(hashval))) {
+                uint32_t s = slots_[seq.offset((size_t)i)];
+                if ((s & ~kIndexMask) == tag && *arena_.get(s & kIndexMask) == elem)
+                    return true;
+            }
+            if (PHMAP_PREDICT_TRUE(g.MatchEmpty())) return false;
+            seq.next();
+            assert(seq.getindex() < capacity_ && "full table!");
+        }
+        return false;
+    }
+
+    bool has_element(const value_type& elem) const {
+        size_t hashval = PolicyTraits::apply(HashElement{hash_ref()}, elem);
+        return has_element(elem, hashval);
+    }
+
+    size_t find_first_non_full(size_t hashval) {
+        auto seq = probe(hashval);
+        while (true) {
+            Group g{ctrl_ + seq.offset()};
+            auto mask = g.MatchEmptyOrDeleted();
+            if (mask)
+                return seq.offset((size_t)mask.LowestBitSet());
+            assert(seq.getindex() < capacity_ && "full table!");
+            seq.next();
+        }
+    }
+
+    void swap_storage(raw_compact_hash_set& that) {
+        using std::swap;
+        swap(ctrl_, that.ctrl_);
+        swap(slots_, that.slots_);
+        swap(size_, that.size_);
+        swap(capacity_, that.capacity_);
+        swap(growth_left(), that.growth_left());
+        arena_.swap(that.arena_);
+    }
+
+protected:
+    template <class K>
+    size_t _find_key(const K& key, size_t hashval) {
+        const uint32_t tag = Tag(hashval);
+        auto seq = probe(hashval);
+        while (true) {
+            Group g{ctrl_ + seq.offset()};
+            for (uint32_t i : g.Match((h2_t)H2(hashval))) {
+                size_t offset = seq.offset((size_t)i);
+                uint32_t s = slots_[offset];
+                if ((s & ~kIndexMask) == tag &&
+                    PHMAP_PREDICT_TRUE(PolicyTraits::apply(
+                        EqualElement<K>{key, eq_ref()}, *arena_.get(s & kIndexMask))))
+                    return offset;
+            }
+            if (PHMAP_PREDICT_TRUE(g.MatchEmpty())) break;
+            seq.next();
+        }
+        return (size_t)-1;
+    }
+
+    template <class K>
+    std::pair<size_t, bool> find_or_prepare_insert(const K& key, size_t hashval) {
+        size_t offset = _find_key(key, hashval);
+        if (offset == (size_t)-1)
+            return {prepare_insert(hashval), true};
+        return {offset, false};
+    }
+
+    // Also remembers the tag of `hashval`, which is stored in the slot by the
+    // following emplace_at().
+    size_t prepare_insert(size_t hashval) PHMAP_ATTRIBUTE_NOINLINE {
+        size_t target = find_first_non_full(hashval);
+        if (PHMAP_PREDICT_FALSE(growth_left() == 0 && !IsDeleted(ctrl_[target]))) {
+            rehash_and_grow_if_necessary();
+            target = find_first_non_full(hashval);
+        }
+        ++size_;
+        growth_left() -= IsEmpty(ctrl_[target]);
+        pending_tag_ = Tag(hashval);
+        return target;
+    }
+
+    // PRECONDITION: i is an index returned from prepare_insert().
+    template <class... Args>
+    void emplace_at(size_t i, Args&&... args) {
+        uint32_t idx = arena_.allocate(&alloc_ref());
+        construct_node(arena_.get(idx), std::forward<Args>(args)...);
+        slots_[i] = pending_tag_ | idx;
+    }
+
+    iterator iterator_at(size_t i) { return {ctrl_ + i, slots_ + i, &arena_}; }
+    const_iterator iterator_at(size_t i) const {
+        return const_cast<raw_compact_hash_set*>(this)->iterator_at(i);
+    }
+
+    void set_ctrl(size_t i, ctrl_t h) {
+        assert(i < capacity_);
+        ctrl_[i] = h;
+        ctrl_[((i - Group::kWidth) & capacity_) + 1 +
+              ((Group::kWidth - 1) & capacity_)] = h;
+    }
+
+private:
+    template <size_t N,
+              template <class, class, class, class> class RefSet,
+              class M, class P, class H, class E, class A>
+    friend class parallel_hash_set;
+
+    template <size_t N,
+              template <class, class, class, class> class RefSet,
+              class M, class P, class H, class E, class A>
+    friend class parallel_hash_map;
+
+    probe_seq<Group::kWidth> probe(size_t hashval) const {
+        return probe_seq<Group::kWidth>(H1(hashval, ctrl_), capacity_);
+    }
+
+    void reset_ctrl(size_t new_capacity) {
+        std::memset(ctrl_, kEmpty, new_capacity + Group::kWidth);
+        ctrl_[new_capacity] = kSentinel;
+    }
+
+    void reset_growth_left(size_t new_capacity) {
+        growth_left() = CapacityToGrowth(new_capacity) - size_;
+    }
+
+    size_t& growth_left() { return std::get<0>(settings_); }
+    const size_t& growth_left() const { return std::get<0>(settings_); }
+
+    hasher& hash_ref() { return std::get<1>(settings_); }
+    const hasher& hash_ref() const { return std::get<1>(settings_); }
+    key_equal& eq_ref() { return std::get<2>(settings_); }
+    const key_equal& eq_ref() const { return std::get<2>(settings_); }
+    allocator_type& alloc_ref() { return std::get<3>(settings_); }
+    const allocator_type& alloc_ref() const { return std::get<3>(settings_); }
+
+    ctrl_t*    ctrl_ = EmptyGroup<std::true_type>(); // [(capacity + 1) * ctrl_t]
+    slot_type* slots_ = nullptr;                     // [capacity * slot_type]
+    size_t     size_ = 0;                            // number of full slots
+    size_t     capacity_ = 0;                        // total number of slots
+    uint32_t   pending_tag_ = 0;                     // tag for the next emplace_at()
+    Arena      arena_;
+    std::tuple<size_t /* growth_left */, hasher, key_equal, allocator_type>
+        settings_{0, hasher{}, key_equal{}, allocator_type{}};
+};
+
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+template <class Policy, class Hash, class Eq, class Alloc>
+class raw_compact_hash_map : public raw_compact_hash_set<Policy, Hash, Eq, Alloc>
+{
+    template <class P>
+    using MappedReference = decltype(P::value(
+               std::addressof(std::declval<typename raw_compact_hash_map::reference>())));
+
+    template <class P>
+    using MappedConstReference = decltype(P::value(
+               std::addressof(std::declval<typename raw_compact_hash_map::const_reference>())));
+
+    using KeyArgImpl =
+        KeyArg<IsTransparent<Eq>::value && IsTransparent<Hash>::value>;
+
+    using Base = raw_compact_hash_set<Policy, Hash, Eq, Alloc>;
+
+public:
+    using key_type = typename Policy::key_type;
+    using mapped_type = typename Policy::mapped_type;
+    template <class K>
+    using key_arg = typename KeyArgImpl::template type<K, key_type>;
+
+    using iterator = typename Base::iterator;
+    using const_iterator = typename Base::const_iterator;
+
+    raw_compact_hash_map() {}
+    using Base::raw_compact_hash_set;
+
+    template <class K = key_type, class V = mapped_type, K* = nullptr, V* = nullptr>
+    std::pair<iterator, bool> insert_or_assign(key_arg<K>&& k, V&& v) {
+        return insert_or_assign_impl(std::forward<K>(k), std::forward<V>(v));
+    }
+
+    template <class K = key_type, class V = mapped_type, K* = nullptr>
+    std::pair<iterator, bool> insert_or_assign(key_arg<K>&& k, const V& v) {
+        return insert_or_assign_impl(std::forward<K>(k), v);
+    }
+
+    template <class K = key_type, class V = mapped_type, V* = nullptr>
+    std::pair<iterator, bool> insert_or_assign(const key_arg<K>& k, V&& v) {
+        return insert_or_assign_impl(k, std::forward<V>(v));
+    }
+
+    template <class K = key_type, class V = mapped_type>
+    std::pair<iterator, bool> insert_or_assign(const key_arg<K>& k, const V& v) {
+        return insert_or_assign_impl(k, v);
+    }
+
+    template <class K = key_type, class... Args,
+              typename std::enable_if<
+                  !std::is_convertible<K, const_iterator>::value, int>::type = 0,
+              K* = nullptr>
+    std::pair<iterator, bool> try_emplace(key_arg<K>&& k, Args&&... args) {
+        return try_emplace_impl(std::forward<K>(k), std::forward<Args>(args)...);
+    }
+
+    template <class K = key_type, class... Args,
+              typename std::enable_if<
+                  !std::is_convertible<K, const_iterator>::value, int>::type = 0>
+    std::pair<iterator, bool> try_emplace(const key_arg<K>& k, Args&&... args) {
+        return try_emplace_impl(k, std::forward<Args>(args)...);
+    }
+
+    template <class K = key_type, class... Args>
+    iterator try_emplace(const_iterator, const key_arg<K>& k, Args&&... args) {
+        return try_emplace(k, std::forward<Args>(args)...).first;
+    }
+
+    template <class K = key_type, class P = Policy>
+    MappedReference<P> at(const key_arg<K>& key) {
+        auto it = this->find(key);
+        if (it == this->end())
+            phmap::base_internal::ThrowStdOutOfRange("phmap at(): lookup non-existent key");
+        return Policy::value(&*it);
+    }
+
+    template <class K = key_type, class P = Policy>
+    MappedConstReference<P> at(const key_arg<K>& key) const {
+        auto it = this->find(key);
+        if (it == this->end())
+            phmap::base_internal::ThrowStdOutOfRange("phmap at(): lookup non-existent key");
+        return Policy::value(&*it);
+    }
+
+    template <class K = key_type, class P = Policy, K* = nullptr>
+    MappedReference<P> operator[](key_arg<K>&& key) {
+        return Policy::value(&*try_emplace(std::forward<K>(key)).first);
+    }
+
+    template <class K = key_type, class P = Policy>
+    MappedReference<P> operator[](const key_arg<K>& key) {
+        return Policy::value(&*try_emplace(key).first);
+    }
+
+private:
+    template <class K, class V>
+    std::pair<iterator, bool> insert_or_assign_impl(K&& k, V&& v) {
+        size_t hashval = this->hash(k);
+        size_t offset = this->_find_key(k, hashval);
+        if (offset == (size_t)-1) {
+            offset = this->prepare_insert(hashval);
+            this->emplace_at(offset, std::forward<K>(k), std::forward<V>(v));
+            this->set_ctrl(offset, H2(hashval));
+            return {this->iterator_at(offset), true};
+        }
+        Policy::value(&*this->iterator_at(offset)) = std::forward<V>(v);
+        return {this->iterator_at(offset), false};
+    }
+
+    template <class K = key_type, class... Args>
+    std::pair<iterator, bool> try_emplace_impl(K&& k, Args&&... args) {
+        size_t hashval = this->hash(k);
+        size_t offset = this->_find_key(k, hashval);
+        if (offset == (size_t)-1) {
+            offset = this->prepare_insert(hashval);
+            this->emplace_at(offset, std::piecewise_construct,
+                             std::forward_as_tuple(std::forward<K>(k)),
+                             std::forward_as_tuple(std::forward<Args>(args)...));
+            this->set_ctrl(offset, H2(hashval));
+            return {this->iterator_at(offset), true};
+        }
+        return {this->iterator_at(offset), false};
+    }
+};
+
+}  // namespace priv
+
+// -----------------------------------------------------------------------------
+// phmap::compact_node_hash_set
+// -----------------------------------------------------------------------------
+// Same interface and pointer stability guarantees as `phmap::node_hash_set`,
+// but slots use 4 bytes instead of 8 (see implementation details above).
+// Holds at most 2^28 elements.
+// -----------------------------------------------------------------------------
+template <class T, class Hash, class Eq, class Alloc> // default values in phmap_fwd_decl.h
+class compact_node_hash_set
+    : public phmap::priv::raw_compact_hash_set<
+          phmap::priv::NodeHashSetPolicy<T>, Hash, Eq, Alloc>
+{
+    using Base = typename compact_node_hash_set::raw_compact_hash_set;
+
+public:
+    compact_node_hash_set() {}
+    using Base::Base;
+    using Base::begin;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::end;
+    using Base::capacity;
+    using Base::empty;
+    using Base::max_size;
+    using Base::size;
+    using Base::clear;
+    using Base::erase;
+    using Base::insert;
+    using Base::emplace;
+    using Base::emplace_hint;
+    using Base::swap;
+    using Base::rehash;
+    using Base::reserve;
+    using Base::contains;
+    using Base::count;
+    using Base::equal_range;
+    using Base::find;
+    using Base::bucket_count;
+    using Base::load_factor;
+    using Base::max_load_factor;
+    using Base::get_allocator;
+    using Base::hash_function;
+    using Base::hash;
+    using Base::key_eq;
+};
+
+// -----------------------------------------------------------------------------
+// phmap::compact_node_hash_map
+// -----------------------------------------------------------------------------
+// Same interface and pointer stability guarantees as `phmap::node_hash_map`,
+// but slots use 4 bytes instead of 8 (see implementation details above).
+// Holds at most 2^28 elements.
+// -----------------------------------------------------------------------------
+template <class Key, class Value, class Hash, class Eq, class Alloc> // default values in phmap_fwd_decl.h
+class compact_node_hash_map
+    : public phmap::priv::raw_compact_hash_map<
+          phmap::priv::NodeHashMapPolicy<Key, Value>, Hash, Eq, Alloc>
+{
+    using Base = typename compact_node_hash_map::raw_compact_hash_map;
+
+public:
+    compact_node_hash_map() {}
+    using Base::Base;
+    using Base::begin;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::end;
+    using Base::capacity;
+    using Base::empty;
+    using Base::max_size;
+    using Base::size;
+    using Base::clear;
+    using Base::erase;
+    using Base::insert;
+    using Base::insert_or_assign;
+    using Base::emplace;
+    using Base::emplace_hint;
+    using Base::try_emplace;
+    using Base::swap;
+    using Base::rehash;
+    using Base::reserve;
+    using Base::at;
+    using Base::contains;
+    using Base::count;
+    using Base::equal_range;
+    using Base::find;
+    using Base::operator[];
+    using Base::bucket_count;
+    using Base::load_factor;
+    using Base::max_load_factor;
+    using Base::get_allocator;
+    using Base::hash_function;
+    using Base::hash;
+    using Base::key_eq;
+};
+
+// -----------------------------------------------------------------------------
+// phmap::parallel_compact_node_hash_set
+// -----------------------------------------------------------------------------
+template <class T, class Hash, class Eq, class Alloc, size_t N, class Mtx_> // default values in phmap_fwd_decl.h
+class parallel_compact_node_hash_set
+    : public phmap::priv::parallel_hash_set<
+             N, phmap::priv::raw_compact_hash_set, Mtx_,
+             phmap::priv::NodeHashSetPolicy<T>, Hash, Eq, Alloc>
+{
+    using Base = typename parallel_compact_node_hash_set::parallel_hash_set;
+
+public:
+    parallel_compact_node_hash_set() {}
+    using Base::Base;
+    using Base::hash;
+    using Base::subidx;
+    using Base::subcnt;
+    using Base::begin;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::end;
+    using Base::capacity;
+    using Base::empty;
+    using Base::max_size;
+    using Base::size;
+    using Base::clear;
+    using Base::erase;
+    using Base::insert;
+    using Base::emplace;
+    using Base::emplace_hint;
+    using Base::emplace_with_hash;
+    using Base::emplace_hint_with_hash;
+    using Base::swap;
+    using Base::rehash;
+    using Base::reserve;
+    using Base::contains;
+    using Base::count;
+    using Base::equal_range;
+    using Base::find;
+    using Base::bucket_count;
+    using Base::load_factor;
+    using Base::max_load_factor;
+    using Base::get_allocator;
+    using Base::hash_function;
+    using Base::key_eq;
+};
+
+// -----------------------------------------------------------------------------
+// phmap::parallel_compact_node_hash_map
+// -----------------------------------------------------------------------------
+template <class Key, class Value, class Hash, class Eq, class Alloc, size_t N, class Mtx_> // default values in phmap_fwd_decl.h
+class parallel_compact_node_hash_map
+    : public phmap::priv::parallel_hash_map<
+          N, phmap::priv::raw_compact_hash_set, Mtx_,
+          phmap::priv::NodeHashMapPolicy<Key, Value>, Hash, Eq, Alloc>
+{
+    using Base = typename parallel_compact_node_hash_map::parallel_hash_map;
+
+public:
+    parallel_compact_node_hash_map() {}
+    using Base::Base;
+    using Base::hash;
+    using Base::subidx;
+    using Base::subcnt;
+    using Base::begin;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::end;
+    using Base::capacity;
+    using Base::empty;
+    using Base::max_size;
+    using Base::size;
+    using Base::clear;
+    using Base::erase;
+    using Base::insert;
+    using Base::insert_or_assign;
+    using Base::emplace;
+    using Base::emplace_hint;
+    using Base::try_emplace;
+    using Base::emplace_with_hash;
+    using Base::emplace_hint_with_hash;
+    using Base::try_emplace_with_hash;
+    using Base::swap;
+    using Base::rehash;
+    using Base::reserve;
+    using Base::at;
+    using Base::contains;
+    using Base::count;
+    using Base::equal_range;
+    using Base::find;
+    using Base::operator[];
+    using Base::bucket_count;
+    using Base::load_factor;
+    using Base::max_load_factor;
+    using Base::get_allocator;
+    using Base::hash_function;
+    using Base::key_eq;
+};
+
+// ======== erase_if for compact node containers ===============================
+template <class T, class Hash, class Eq, class Alloc, class Pred>
+std::size_t erase_if(phmap::compact_node_hash_set<T, Hash, Eq, Alloc>& c, Pred pred) {
+    return phmap::priv::erase_if(c, std::move(pred));
+}
+
+template <class K, class V, class Hash, class Eq, class Alloc, class Pred>
+std::size_t erase_if(phmap::compact_node_hash_map<K, V, Hash, Eq, Alloc>& c, Pred pred) {
+    return phmap::priv::erase_if(c, std::move(pred));
+}
+
+template <class T, class Hash, class Eq, class Alloc, size_t N, class Mtx_, class Pred>
+std::size_t erase_if(phmap::parallel_compact_node_hash_set<T, Hash, Eq, Alloc, N, Mtx_>& c, Pred pred) {
+    return phmap::priv::erase_if(c, std::move(pred));
+}
+
+template <class K, class V, class Hash, class Eq, class Alloc, size_t N, class Mtx_, class Pred>
+std::size_t erase_if(phmap::parallel_compact_node_hash_map<K, V, Hash, Eq, Alloc, N, Mtx_>& c, Pred pred) {
+    return phmap::priv::erase_if(c, std::move(pred));
+}
+
+}  // namespace phmap
+
+#endif // phmap_compact_h_guard_
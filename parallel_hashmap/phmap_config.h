@@ -120,6 +120,13 @@
     #define PHMAP_HAVE_BUILTIN(x) 0
 #endif
 
+#if (!defined(__GNUC__) || defined(__clang__) || __GNUC__ >= 5) && \
+    ((defined(_MSVC_LANG) && _MSVC_LANG >= 201402L) || __cplusplus >= 201402L)
+    #define PHMAP_HAVE_CC14 1
+#else
+    #define PHMAP_HAVE_CC14 0
+#endif
+
 #if (!defined(__GNUC__) || defined(__clang__) || __GNUC__ >= 5) && \
     ((defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L)
     #define PHMAP_HAVE_CC17 1
@@ -630,6 +637,14 @@
     #endif
 #endif
 
+#ifndef PHMAP_HAVE_SSE42
+    #if defined(__SSE4_2__) || (defined(_MSC_VER) && defined(__AVX__))
+        #define PHMAP_HAVE_SSE42 1
+    #else
+        #define PHMAP_HAVE_SSE42 0
+    #endif
+#endif
+
 #if PHMAP_HAVE_SSSE3 && !PHMAP_HAVE_SSE2
     #error "Bad configuration!"
 #endif
@@ -642,6 +657,10 @@
     #include <tmmintrin.h>
 #endif
 
+#if PHMAP_HAVE_SSE42
+    #include <nmmintrin.h>
+#endif
+
 
 // ----------------------------------------------------------------------
 // constexpr if
@@ -0,0 +1,938 @@
+#if !defined(phmap_dense_h_guard_)
+#define phmap_dense_h_guard_
+
+// ---------------------------------------------------------------------------
+// Copyright (c) 2019, Gregory Popovitch - greg7mdp@gmail.com
+//
+//       containers for integer keys from a dense domain
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+// When the keys are integers from a small or dense domain (uint8_t, uint16_t,
+// or ids packed in [0, N)), there is no need to hash them: the key is the
+// index in a bitmap of present keys.
+//
+// - phmap::dense_int_set is a bitset of `capacity()` bits. Iteration visits
+//   the set bits in increasing key order, and the set operations (|=, &=, -=,
+//   ^=, set_union, ...) process 64 keys per word operation, in loops which
+//   the compiler vectorizes.
+//
+// - phmap::dense_int_map stores the values in an array directly indexed by the
+//   key, along with the bitmap of present keys.
+//
+// Their interface is the one of phmap::flat_hash_set and phmap::flat_hash_map
+// (without the hash and bucket related members), so they can be swapped in
+// when the key range is known. The capacity grows to include the largest key
+// inserted, so the memory used is proportional to the largest key, not to the
+// number of elements. `reserve(n)` and `rehash(n)` make room for the keys in
+// [0, n), and `rehash(0)` shrinks the capacity to the largest key present.
+//
+// Keys must not be negative. Insertions may invalidate iterators and (for
+// dense_int_map) references; erasures only invalidate the erased element.
+// ---------------------------------------------------------------------------
+
+#include <cstring>
+#include <limits>
+#include <tuple>
+
+#include "phmap.h"
+
+namespace phmap {
+
+namespace priv {
+
+// --------------------------------------------------------------------------
+// Conversions between an integral key and its index in the bitmap.
+// --------------------------------------------------------------------------
+template <class T>
+struct DenseKeyTraits
+{
+    static_assert(std::is_integral<T>::value, "dense containers require an integral key type");
+
+    using UKey = typename std::make_unsigned<T>::type;
+
+    static size_t to_index(T k) {
+        assert(non_negative(k, std::is_signed<T>()) && "negative key in dense container");
+        return static_cast<size_t>(static_cast<UKey>(k));
+    }
+
+    static T from_index(size_t i) { return static_cast<T>(static_cast<UKey>(i)); }
+
+    // number of words needed to hold all the keys of the domain
+    static size_t max_words() {
+        uint64_t w = (uint64_t((std::numeric_limits<UKey>::max)()) >> 6) + 1;
+        return static_cast<size_t>((std::min)(w, uint64_t((std::numeric_limits<size_t>::max)() / 64)));
+    }
+
+    static size_t max_size() { return max_words() * 64; }
+
+    // words needed for key `i`, growing geometrically from `cur` words
+    static size_t grow_words(size_t i, size_t cur) {
+        return (std::min)((std::max)(i / 64 + 1, 2 * cur), max_words());
+    }
+
+private:
+    static bool non_negative(T k, std::true_type) { return k >= 0; }
+    static bool non_negative(T, std::false_type) { return true; }
+};
+
+// --------------------------------------------------------------------------
+// Visits the set bits of a bitmap in increasing order.
+// --------------------------------------------------------------------------
+class DenseBitCursor
+{
+public:
+    DenseBitCursor() {}
+
+    // positioned at the first set bit >= i
+    DenseBitCursor(const uint64_t* words, size_t nwords, size_t i) :
+        words_(words), nwords_(nwords), word_(i / 64) {
+        bits_ = word_ < nwords_ ? words_[word_] & ~((uint64_t(1) << (i % 64)) - 1) : 0;
+        skip();
+    }
+
+    bool   done() const  { return word_ >= nwords_; }
+    size_t index() const { return word_ * 64 + TrailingZeros(bits_); }
+
+    void next() {
+        bits_ &= bits_ - 1;
+        skip();
+    }
+
+    friend bool operator==(const DenseBitCursor& a, const DenseBitCursor& b) {
+        return a.word_ == b.word_ && a.bits_ == b.bits_;
+    }
+
+private:
+    void skip() {
+        while (!bits_ && ++word_ < nwords_)
+            bits_ = words_[word_];
+        if (!bits_)
+            word_ = nwords_;
+    }
+
+    const uint64_t* words_  = nullptr;
+    size_t          nwords_ = 0;
+    size_t          word_   = 0;
+    uint64_t        bits_   = 0;   // bits of words_[word_] not visited yet
+};
+
+// --------------------------------------------------------------------------
+// Bitmap of present keys. Copy and assignment are done by the owning container.
+// --------------------------------------------------------------------------
+template <class Alloc>
+class DenseBitmap
+{
+    using WordAlloc = typename phmap::allocator_traits<Alloc>::template rebind_alloc<uint64_t>;
+    using WordAllocTraits = phmap::allocator_traits<WordAlloc>;
+
+public:
+    explicit DenseBitmap(const Alloc& alloc) : alloc_(alloc) {}
+
+    DenseBitmap(const DenseBitmap& o, const Alloc& alloc) : alloc_(alloc) {
+        resize(o.nwords_);
+        if (nwords_)
+            std::memcpy(words_, o.words_, nwords_ * sizeof(uint64_t));
+    }
+
+    DenseBitmap(DenseBitmap&& o) noexcept :
+        words_(phmap::exchange(o.words_, nullptr)),
+        nwords_(phmap::exchange(o.nwords_, 0)),
+        alloc_(o.alloc_) {}
+
+    DenseBitmap& operator=(const DenseBitmap&) = delete;
+
+    ~DenseBitmap() { resize(0); }
+
+    size_t          num_words() const { return nwords_; }
+    size_t          num_bits() const  { return nwords_ * 64; }
+    uint64_t*       words()           { return words_; }
+    const uint64_t* words() const     { return words_; }
+    Alloc           get_allocator() const { return Alloc(alloc_); }
+
+    bool test(size_t i) const {
+        return i < num_bits() && ((words_[i / 64] >> (i % 64)) & 1);
+    }
+    void set(size_t i)   { words_[i / 64] |= uint64_t(1) << (i % 64); }
+    void reset(size_t i) { words_[i / 64] &= ~(uint64_t(1) << (i % 64)); }
+
+    // number of set bits below i
+    size_t rank(size_t i) const {
+        size_t w = (std::min)(i / 64, nwords_);
+        size_t res = count(0, w);
+        if (w < nwords_)
+            res += base_internal::Popcount64(words_[w] & ((uint64_t(1) << (i % 64)) - 1));
+        return res;
+    }
+
+    size_t count(size_t first_word, size_t last_word) const {
+        size_t res = 0;
+        for (size_t w = first_word; w < last_word; ++w)
+            res += base_internal::Popcount64(words_[w]);
+        return res;
+    }
+    size_t count() const { return count(0, nwords_); }
+
+    // number of words up to the last non-zero one
+    size_t used_words() const {
+        size_t w = nwords_;
+        while (w && !words_[w - 1])
+            --w;
+        return w;
+    }
+
+    DenseBitCursor cursor(size_t i) const { return {words_, nwords_, i}; }
+
+    // Keeps the bits of the first `min(n, num_words())` words, and clears the
+    // others.
+    void resize(size_t n) {
+        if (n == nwords_)
+            return;
+        uint64_t* words = nullptr;
+        if (n) {
+            words = WordAllocTraits::allocate(alloc_, n);
+            size_t keep = (std::min)(n, nwords_);
+            if (keep)
+                std::memcpy(words, words_, keep * sizeof(uint64_t));
+            std::memset(words + keep, 0, (n - keep) * sizeof(uint64_t));
+        }
+        if (words_)
+            WordAllocTraits::deallocate(alloc_, words_, nwords_);
+        words_ = words;
+        nwords_ = n;
+    }
+
+    void clear() {
+        if (nwords_)
+            std::memset(words_, 0, nwords_ * sizeof(uint64_t));
+    }
+
+    void swap(DenseBitmap& o) noexcept {
+        using std::swap;
+        swap(words_, o.words_);
+        swap(nwords_, o.nwords_);
+        swap(alloc_, o.alloc_);
+    }
+
+private:
+    uint64_t* words_  = nullptr;
+    size_t    nwords_ = 0;
+    WordAlloc alloc_;
+};
+
+}  // namespace priv
+
+// -----------------------------------------------------------------------------
+// phmap::dense_int_set
+// -----------------------------------------------------------------------------
+template <class T, class Alloc> // default values in phmap_fwd_decl.h
+class dense_int_set
+{
+    using KeyTraits = priv::DenseKeyTraits<T>;
+    using Bitmap = priv::DenseBitmap<Alloc>;
+
+public:
+    using key_type        = T;
+    using value_type      = T;
+    using size_type       = size_t;
+    using difference_type = ptrdiff_t;
+    using allocator_type  = Alloc;
+    using reference       = const value_type&;
+    using const_reference = const value_type&;
+
+    // Keys are not stored, so the iterator returns them by value.
+    class const_iterator
+    {
+        friend class dense_int_set;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = typename dense_int_set::value_type;
+        using reference         = value_type;
+        using pointer           = const value_type*;
+        using difference_type   = typename dense_int_set::difference_type;
+
+        const_iterator() {}
+
+        // PRECONDITION: not an end() iterator.
+        value_type operator*() const { return KeyTraits::from_index(cur_.index()); }
+
+        const_iterator& operator++() {
+            cur_.next();
+            return *this;
+        }
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const const_iterator& a, const const_iterator& b) {
+            return a.cur_ == b.cur_;
+        }
+        friend bool operator!=(const const_iterator& a, const const_iterator& b) {
+            return !(a == b);
+        }
+
+    private:
+        explicit const_iterator(const priv::DenseBitCursor& cur) : cur_(cur) {}
+
+        priv::DenseBitCursor cur_;
+    };
+    using iterator = const_iterator;
+
+    dense_int_set() : dense_int_set(0) {}
+
+    // Makes room for the keys in [0, capacity).
+    explicit dense_int_set(size_t capacity, const allocator_type& alloc = allocator_type()) :
+        bitmap_(alloc) {
+        reserve(capacity);
+    }
+
+    explicit dense_int_set(const allocator_type& alloc) : dense_int_set(0, alloc) {}
+
+    template <class InputIter>
+    dense_int_set(InputIter first, InputIter last, size_t capacity = 0,
+                  const allocator_type& alloc = allocator_type()) :
+        dense_int_set(capacity, alloc) {
+        insert(first, last);
+    }
+
+    dense_int_set(std::initializer_list<value_type> init, size_t capacity = 0,
+                  const allocator_type& alloc = allocator_type()) :
+        dense_int_set(init.begin(), init.end(), capacity, alloc) {}
+
+    dense_int_set(const dense_int_set& o) :
+        dense_int_set(o, phmap::allocator_traits<allocator_type>::
+                      select_on_container_copy_construction(o.get_allocator())) {}
+
+    dense_int_set(const dense_int_set& o, const allocator_type& alloc) :
+        bitmap_(o.bitmap_, alloc), size_(o.size_) {}
+
+    dense_int_set(dense_int_set&& o) noexcept :
+        bitmap_(std::move(o.bitmap_)), size_(phmap::exchange(o.size_, 0)) {}
+
+    dense_int_set& operator=(const dense_int_set& o) {
+        dense_int_set tmp(o);
+        swap(tmp);
+        return *this;
+    }
+
+    dense_int_set& operator=(dense_int_set&& o) noexcept {
+        dense_int_set tmp(std::move(o));
+        swap(tmp);
+        return *this;
+    }
+
+    iterator begin() const  { return iterator(bitmap_.cursor(0)); }
+    iterator end() const    { return iterator(bitmap_.cursor(bitmap_.num_bits())); }
+    iterator cbegin() const { return begin(); }
+    iterator cend() const   { return end(); }
+
+    bool      empty() const    { return !size_; }
+    size_type size() const     { return size_; }
+    size_type max_size() const { return KeyTraits::max_size(); }
+    size_type capacity() const { return bitmap_.num_bits(); }
+    size_type bucket_count() const { return capacity(); }
+    float     load_factor() const {
+        return capacity() ? static_cast<float>(static_cast<double>(size_) / capacity()) : 0.0f;
+    }
+    float max_load_factor() const { return 1.0f; }
+    void  max_load_factor(float) {
+        // Does nothing.
+    }
+    allocator_type get_allocator() const { return bitmap_.get_allocator(); }
+
+    PHMAP_ATTRIBUTE_REINITIALIZES void clear() {
+        bitmap_.clear();
+        size_ = 0;
+    }
+
+    std::pair<iterator, bool> insert(value_type k) {
+        size_t i = KeyTraits::to_index(k);
+        if (bitmap_.test(i))
+            return {iterator_at(i), false};
+        if (i >= bitmap_.num_bits())
+            bitmap_.resize(KeyTraits::grow_words(i, bitmap_.num_words()));
+        bitmap_.set(i);
+        ++size_;
+        return {iterator_at(i), true};
+    }
+
+    iterator insert(const_iterator, value_type k) { return insert(k).first; }
+
+    template <class InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first)
+            insert(static_cast<value_type>(*first));
+    }
+
+    void insert(std::initializer_list<value_type> ilist) { insert(ilist.begin(), ilist.end()); }
+
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        return insert(value_type(std::forward<Args>(args)...));
+    }
+
+    template <class... Args>
+    iterator emplace_hint(const_iterator, Args&&... args) {
+        return emplace(std::forward<Args>(args)...).first;
+    }
+
+    size_type erase(value_type k) {
+        size_t i = KeyTraits::to_index(k);
+        if (!bitmap_.test(i))
+            return 0;
+        bitmap_.reset(i);
+        --size_;
+        return 1;
+    }
+
+    // PRECONDITION: not an end() iterator.
+    void _erase(const_iterator it) { erase(*it); }
+
+    iterator erase(const_iterator it) {
+        _erase(it++);
+        return it;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        while (first != last)
+            _erase(first++);
+        return last;
+    }
+
+    void swap(dense_int_set& o) noexcept {
+        bitmap_.swap(o.bitmap_);
+        std::swap(size_, o.size_);
+    }
+
+    // Makes room for the keys in [0, n), or shrinks to the largest key if n is 0.
+    void rehash(size_t n) {
+        if (n == 0)
+            bitmap_.resize(bitmap_.used_words());
+        else if (n > capacity())
+            bitmap_.resize((std::min)((n + 63) / 64, KeyTraits::max_words()));
+    }
+
+    void reserve(size_t n) {
+        if (n)
+            rehash(n);
+    }
+
+    size_type count(value_type k) const { return contains(k) ? 1 : 0; }
+    bool contains(value_type k) const { return bitmap_.test(KeyTraits::to_index(k)); }
+
+    iterator find(value_type k) const {
+        size_t i = KeyTraits::to_index(k);
+        return bitmap_.test(i) ? iterator_at(i) : end();
+    }
+
+    std::pair<iterator, iterator> equal_range(value_type k) const {
+        auto it = find(k);
+        if (it != end()) return {it, std::next(it)};
+        return {it, it};
+    }
+
+    // number of elements smaller than `k`
+    size_type rank(value_type k) const { return bitmap_.rank(KeyTraits::to_index(k)); }
+
+    // ------------------------- set operations ----------------------------
+    dense_int_set& operator|=(const dense_int_set& o) {
+        if (o.bitmap_.num_words() > bitmap_.num_words())
+            bitmap_.resize(o.bitmap_.num_words());
+        uint64_t* w = bitmap_.words();
+        const uint64_t* ow = o.bitmap_.words();
+        for (size_t i = 0, n = o.bitmap_.num_words(); i < n; ++i)
+            w[i] |= ow[i];
+        size_ = bitmap_.count();
+        return *this;
+    }
+
+    dense_int_set& operator&=(const dense_int_set& o) {
+        size_t n = (std::min)(bitmap_.num_words(), o.bitmap_.num_words());
+        uint64_t* w = bitmap_.words();
+        const uint64_t* ow = o.bitmap_.words();
+        for (size_t i = 0; i < n; ++i)
+            w[i] &= ow[i];
+        for (size_t i = n; i < bitmap_.num_words(); ++i)
+            w[i] = 0;
+        size_ = bitmap_.count(0, n);
+        return *this;
+    }
+
+    dense_int_set& operator-=(const dense_int_set& o) {
+        size_t n = (std::min)(bitmap_.num_words(), o.bitmap_.num_words());
+        uint64_t* w = bitmap_.words();
+        const uint64_t* ow = o.bitmap_.words();
+        for (size_t i = 0; i < n; ++i)
+            w[i] &= ~ow[i];
+        size_ = bitmap_.count();
+        return *this;
+    }
+
+    dense_int_set& operator^=(const dense_int_set& o) {
+        if (o.bitmap_.num_words() > bitmap_.num_words())
+            bitmap_.resize(o.bitmap_.num_words());
+        uint64_t* w = bitmap_.words();
+        const uint64_t* ow = o.bitmap_.words();
+        for (size_t i = 0, n = o.bitmap_.num_words(); i < n; ++i)
+            w[i] ^= ow[i];
+        size_ = bitmap_.count();
+        return *this;
+    }
+
+    // number of elements in both `a` and `b`, without building the intersection
+    friend size_t intersection_size(const dense_int_set& a, const dense_int_set& b) {
+        size_t n = (std::min)(a.bitmap_.num_words(), b.bitmap_.num_words());
+        const uint64_t* aw = a.bitmap_.words();
+        const uint64_t* bw = b.bitmap_.words();
+        size_t res = 0;
+        for (size_t i = 0; i < n; ++i)
+            res += base_internal::Popcount64(aw[i] & bw[i]);
+        return res;
+    }
+
+    friend bool operator==(const dense_int_set& a, const dense_int_set& b) {
+        if (a.size_ != b.size_)
+            return false;
+        size_t n = (std::min)(a.bitmap_.num_words(), b.bitmap_.num_words());
+        // the words beyond `n` are all zero, as the sizes are equal
+        return n == 0 || std::memcmp(a.bitmap_.words(), b.bitmap_.words(), n * sizeof(uint64_t)) == 0;
+    }
+
+    friend bool operator!=(const dense_int_set& a, const dense_int_set& b) {
+        return !(a == b);
+    }
+
+    friend void swap(dense_int_set& a, dense_int_set& b) noexcept { a.swap(b); }
+
+private:
+    iterator iterator_at(size_t i) const { return iterator(bitmap_.cursor(i)); }
+
+    Bitmap bitmap_;
+    size_t size_ = 0;
+};
+
+// -----------------------------------------------------------------------------
+// phmap::dense_int_map
+// -----------------------------------------------------------------------------
+template <class Key, class Value, class Alloc> // default values in phmap_fwd_decl.h
+class dense_int_map
+{
+    using KeyTraits = priv::DenseKeyTraits<Key>;
+    using Bitmap = priv::DenseBitmap<Alloc>;
+    using AllocTraits = phmap::allocator_traits<Alloc>;
+
+public:
+    using key_type        = Key;
+    using mapped_type     = Value;
+    using value_type      = std::pair<const Key, Value>;
+    using init_type       = std::pair<Key, Value>;
+    using size_type       = size_t;
+    using difference_type = ptrdiff_t;
+    using allocator_type  = Alloc;
+    using reference       = value_type&;
+    using const_reference = const value_type&;
+    using pointer         = value_type*;
+    using const_pointer   = const value_type*;
+
+    class iterator
+    {
+        friend class dense_int_map;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = typename dense_int_map::value_type;
+        using reference         = value_type&;
+        using pointer           = value_type*;
+        using difference_type   = typename dense_int_map::difference_type;
+
+        iterator() {}
+
+        // PRECONDITION: not an end() iterator.
+        reference operator*() const { return slots_[cur_.index()]; }
+        pointer operator->() const { return &operator*(); }
+
+        iterator& operator++() {
+            cur_.next();
+            return *this;
+        }
+        iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b) { return a.cur_ == b.cur_; }
+        friend bool operator!=(const iterator& a, const iterator& b) { return !(a == b); }
+
+    private:
+        iterator(const priv::DenseBitCursor& cur, value_type* slots) : cur_(cur), slots_(slots) {}
+
+        priv::DenseBitCursor cur_;
+        value_type*          slots_ = nullptr;
+    };
+
+    class const_iterator
+    {
+        friend class dense_int_map;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = typename dense_int_map::value_type;
+        using reference         = const value_type&;
+        using pointer           = const value_type*;
+        using difference_type   = typename dense_int_map::difference_type;
+
+        const_iterator() {}
+        // Implicit construction from iterator.
+        const_iterator(iterator i) : inner_(std::move(i)) {}
+
+        reference operator*() const { return *inner_; }
+        pointer operator->() const { return inner_.operator->(); }
+
+        const_iterator& operator++() {
+            ++inner_;
+            return *this;
+        }
+        const_iterator operator++(int) { return inner_++; }
+
+        friend bool operator==(const const_iterator& a, const const_iterator& b) {
+            return a.inner_ == b.inner_;
+        }
+        friend bool operator!=(const const_iterator& a, const const_iterator& b) {
+            return !(a == b);
+        }
+
+    private:
+        iterator inner_;
+    };
+
+    dense_int_map() : dense_int_map(0) {}
+
+    // Makes room for the keys in [0, capacity).
+    explicit dense_int_map(size_t capacity, const allocator_type& alloc = allocator_type()) :
+        bitmap_(alloc), alloc_(alloc) {
+        reserve(capacity);
+    }
+
+    explicit dense_int_map(const allocator_type& alloc) : dense_int_map(0, alloc) {}
+
+    template <class InputIter>
+    dense_int_map(InputIter first, InputIter last, size_t capacity = 0,
+                  const allocator_type& alloc = allocator_type()) :
+        dense_int_map(capacity, alloc) {
+        insert(first, last);
+    }
+
+    dense_int_map(std::initializer_list<value_type> init, size_t capacity = 0,
+                  const allocator_type& alloc = allocator_type()) :
+        dense_int_map(init.begin(), init.end(), capacity, alloc) {}
+
+    dense_int_map(const dense_int_map& o) :
+        dense_int_map(o, AllocTraits::select_on_container_copy_construction(o.alloc_)) {}
+
+    dense_int_map(const dense_int_map& o, const allocator_type& alloc) :
+        bitmap_(o.bitmap_, alloc), alloc_(alloc) {
+        if (!bitmap_.num_bits())
+            return;
+        slots_ = AllocTraits::allocate(alloc_, bitmap_.num_bits());
+        for (auto cur = bitmap_.cursor(0); !cur.done(); cur.next()) {
+            size_t i = cur.index();
+            AllocTraits::construct(alloc_, slots_ + i, o.slots_[i]);
+            ++size_;
+        }
+    }
+
+    dense_int_map(dense_int_map&& o) noexcept :
+        bitmap_(std::move(o.bitmap_)),
+        slots_(phmap::exchange(o.slots_, nullptr)),
+        size_(phmap::exchange(o.size_, 0)),
+        alloc_(o.alloc_) {}
+
+    dense_int_map& operator=(const dense_int_map& o) {
+        dense_int_map tmp(o);
+        swap(tmp);
+        return *this;
+    }
+
+    dense_int_map& operator=(dense_int_map&& o) noexcept {
+        dense_int_map tmp(std::move(o));
+        swap(tmp);
+        return *this;
+    }
+
+    ~dense_int_map() {
+        clear();
+        resize(0);
+    }
+
+    iterator begin() { return {bitmap_.cursor(0), slots_}; }
+    iterator end()   { return {bitmap_.cursor(bitmap_.num_bits()), slots_}; }
+    const_iterator begin() const  { return const_cast<dense_int_map*>(this)->begin(); }
+    const_iterator end() const    { return const_cast<dense_int_map*>(this)->end(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const   { return end(); }
+
+    bool      empty() const    { return !size_; }
+    size_type size() const     { return size_; }
+    size_type max_size() const { return KeyTraits::max_size(); }
+    size_type capacity() const { return bitmap_.num_bits(); }
+    size_type bucket_count() const { return capacity(); }
+    float     load_factor() const {
+        return capacity() ? static_cast<float>(static_cast<double>(size_) / capacity()) : 0.0f;
+    }
+    float max_load_factor() const { return 1.0f; }
+    void  max_load_factor(float) {
+        // Does nothing.
+    }
+    allocator_type get_allocator() const { return alloc_; }
+
+    PHMAP_ATTRIBUTE_REINITIALIZES void clear() {
+        for (auto cur = bitmap_.cursor(0); !cur.done(); cur.next())
+            AllocTraits::destroy(alloc_, slots_ + cur.index());
+        bitmap_.clear();
+        size_ = 0;
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(key_type k, Args&&... args) {
+        size_t i = KeyTraits::to_index(k);
+        if (bitmap_.test(i))
+            return {iterator_at(i), false};
+        if (i >= bitmap_.num_bits())
+            resize(KeyTraits::grow_words(i, bitmap_.num_words()));
+        AllocTraits::construct(alloc_, slots_ + i, std::piecewise_construct,
+                               std::forward_as_tuple(k),
+                               std::forward_as_tuple(std::forward<Args>(args)...));
+        bitmap_.set(i);
+        ++size_;
+        return {iterator_at(i), true};
+    }
+
+    template <class... Args>
+    iterator try_emplace(const_iterator, key_type k, Args&&... args) {
+        return try_emplace(k, std::forward<Args>(args)...).first;
+    }
+
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(key_type k, M&& v) {
+        auto res = try_emplace(k, std::forward<M>(v));
+        if (!res.second)
+            res.first->second = std::forward<M>(v);
+        return res;
+    }
+
+    std::pair<iterator, bool> insert(const value_type& v) { return try_emplace(v.first, v.second); }
+    std::pair<iterator, bool> insert(value_type&& v) { return try_emplace(v.first, std::move(v.second)); }
+
+    template <class P, typename std::enable_if<
+                           std::is_constructible<value_type, P&&>::value, int>::type = 0>
+    std::pair<iterator, bool> insert(P&& p) {
+        return emplace(std::forward<P>(p));
+    }
+
+    iterator insert(const_iterator, const value_type& v) { return insert(v).first; }
+    iterator insert(const_iterator, value_type&& v) { return insert(std::move(v)).first; }
+
+    template <class InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first)
+            emplace(*first);
+    }
+
+    void insert(std::initializer_list<value_type> ilist) { insert(ilist.begin(), ilist.end()); }
+
+    template <class K, class V>
+    std::pair<iterator, bool> emplace(K&& k, V&& v) {
+        return try_emplace(static_cast<key_type>(k), std::forward<V>(v));
+    }
+
+    // The value is constructed first, to find its key.
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        value_type v(std::forward<Args>(args)...);
+        return try_emplace(v.first, std::move(v.second));
+    }
+
+    template <class... Args>
+    iterator emplace_hint(const_iterator, Args&&... args) {
+        return emplace(std::forward<Args>(args)...).first;
+    }
+
+    mapped_type& operator[](key_type k) { return try_emplace(k).first->second; }
+
+    mapped_type& at(key_type k) {
+        size_t i = KeyTraits::to_index(k);
+        if (!bitmap_.test(i))
+            phmap::base_internal::ThrowStdOutOfRange("phmap at(): lookup non-existent key");
+        return slots_[i].second;
+    }
+
+    const mapped_type& at(key_type k) const {
+        return const_cast<dense_int_map*>(this)->at(k);
+    }
+
+    size_type erase(key_type k) {
+        size_t i = KeyTraits::to_index(k);
+        if (!bitmap_.test(i))
+            return 0;
+        AllocTraits::destroy(alloc_, slots_ + i);
+        bitmap_.reset(i);
+        --size_;
+        return 1;
+    }
+
+    // PRECONDITION: not an end() iterator.
+    void _erase(iterator it) { erase(it->first); }
+    void _erase(const_iterator cit) { _erase(cit.inner_); }
+
+    iterator erase(iterator it) {
+        _erase(it++);
+        return it;
+    }
+    iterator erase(const_iterator cit) { return erase(cit.inner_); }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        while (first != last)
+            _erase(first++);
+        return last.inner_;
+    }
+
+    void swap(dense_int_map& o) noexcept {
+        using std::swap;
+        bitmap_.swap(o.bitmap_);
+        swap(slots_, o.slots_);
+        swap(size_, o.size_);
+        swap(alloc_, o.alloc_);
+    }
+
+    // Makes room for the keys in [0, n), or shrinks to the largest key if n is 0.
+    void rehash(size_t n) {
+        if (n == 0)
+            resize(bitmap_.used_words());
+        else if (n > capacity())
+            resize((std::min)((n + 63) / 64, KeyTraits::max_words()));
+    }
+
+    void reserve(size_t n) {
+        if (n)
+            rehash(n);
+    }
+
+    size_type count(key_type k) const { return contains(k) ? 1 : 0; }
+    bool contains(key_type k) const { return bitmap_.test(KeyTraits::to_index(k)); }
+
+    iterator find(key_type k) {
+        size_t i = KeyTraits::to_index(k);
+        return bitmap_.test(i) ? iterator_at(i) : end();
+    }
+    const_iterator find(key_type k) const { return const_cast<dense_int_map*>(this)->find(k); }
+
+    std::pair<iterator, iterator> equal_range(key_type k) {
+        auto it = find(k);
+        if (it != end()) return {it, std::next(it)};
+        return {it, it};
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(key_type k) const {
+        auto it = find(k);
+        if (it != end()) return {it, std::next(it)};
+        return {it, it};
+    }
+
+    friend bool operator==(const dense_int_map& a, const dense_int_map& b) {
+        if (a.size_ != b.size_)
+            return false;
+        for (const auto& e : a) {
+            auto it = b.find(e.first);
+            if (it == b.end() || !(it->second == e.second))
+                return false;
+        }
+        return true;
+    }
+
+    friend bool operator!=(const dense_int_map& a, const dense_int_map& b) {
+        return !(a == b);
+    }
+
+    friend void swap(dense_int_map& a, dense_int_map& b) noexcept { a.swap(b); }
+
+private:
+    iterator iterator_at(size_t i) { return {bitmap_.cursor(i), slots_}; }
+
+    // Moves the elements to an array of `nwords * 64` slots.
+    // PRECONDITION: nwords >= bitmap_.used_words()
+    void resize(size_t nwords) {
+        if (nwords == bitmap_.num_words())
+            return;
+        value_type* slots = nwords ? AllocTraits::allocate(alloc_, nwords * 64) : nullptr;
+        for (auto cur = bitmap_.cursor(0); !cur.done(); cur.next()) {
+            size_t i = cur.index();
+            AllocTraits::construct(alloc_, slots + i, std::move(slots_[i]));
+            AllocTraits::destroy(alloc_, slots_ + i);
+        }
+        if (slots_)
+            AllocTraits::deallocate(alloc_, slots_, bitmap_.num_bits());
+        slots_ = slots;
+        bitmap_.resize(nwords);
+    }
+
+    Bitmap         bitmap_;
+    value_type*    slots_ = nullptr;   // [capacity()], constructed where the bit is set
+    size_t         size_ = 0;
+    allocator_type alloc_;
+};
+
+// ======== set operations for dense_int_set ===================================
+template <class T, class Alloc>
+dense_int_set<T, Alloc> set_intersection(const dense_int_set<T, Alloc>& a,
+                                         const dense_int_set<T, Alloc>& b) {
+    dense_int_set<T, Alloc> res(a.size() <= b.size() ? a : b);
+    res &= (a.size() <= b.size() ? b : a);
+    return res;
+}
+
+template <class T, class Alloc>
+dense_int_set<T, Alloc> set_union(const dense_int_set<T, Alloc>& a,
+                                  const dense_int_set<T, Alloc>& b) {
+    dense_int_set<T, Alloc> res(a.capacity() >= b.capacity() ? a : b);
+    res |= (a.capacity() >= b.capacity() ? b : a);
+    return res;
+}
+
+template <class T, class Alloc>
+dense_int_set<T, Alloc> set_difference(const dense_int_set<T, Alloc>& a,
+                                       const dense_int_set<T, Alloc>& b) {
+    dense_int_set<T, Alloc> res(a);
+    res -= b;
+    return res;
+}
+
+// ======== erase_if for dense containers ======================================
+template <class T, class Alloc, class Pred>
+std::size_t erase_if(phmap::dense_int_set<T, Alloc>& c, Pred pred) {
+    return phmap::priv::erase_if(c, std::move(pred));
+}
+
+template <class K, class V, class Alloc, class Pred>
+std::size_t erase_if(phmap::dense_int_map<K, V, Alloc>& c, Pred pred) {
+    return phmap::priv::erase_if(c, std::move(pred));
+}
+
+}  // namespace phmap
+
+#endif // phmap_dense_h_guard_
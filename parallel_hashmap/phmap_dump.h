@@ -19,10 +19,30 @@
 // limitations under the License.
 // ---------------------------------------------------------------------------
 
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
 #include <iostream>
 #include <fstream>
 #include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 #include "phmap.h"
+
+#if PHMAP_HAVE_MMAP
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
 namespace phmap
 {
 
@@ -46,31 +66,316 @@ namespace priv {
 
 static constexpr size_t s_version_base = std::numeric_limits<size_t>::max() - 10;
 static constexpr size_t s_version = s_version_base;
+static constexpr size_t s_version_blob = s_version_base + 1;      // elements in a blob section
+static constexpr size_t s_version_chunked = s_version_base + 2;   // phmap_dump_chunked() header
+static constexpr size_t s_version_delta = s_version_base + 3;     // dump_delta() header
+
+// ------------------------------------------------------------------------
+// Serialization of the elements of the tables which are not trivially
+// copyable: trivially copyable values are copied as they are, strings and
+// vectors are stored as their length followed by their elements, pairs as
+// their two members.
+// ------------------------------------------------------------------------
+template <class T, class Enable = void>
+struct BlobTraits;   // not defined: the type cannot be dumped
+
+// appends to the blob section, in chunks
+template <class OutputArchive>
+class BlobWriter
+{
+public:
+    explicit BlobWriter(OutputArchive& ar) : ar_(ar) {}
+    ~BlobWriter() { flush(); }
+
+    void write(const void* p, size_t n) {
+        if (used_ + n > sizeof(buf_)) {
+            flush();
+            if (n > sizeof(buf_)) {
+                ar_.saveBinary(p, n);
+                return;
+            }
+        }
+        std::memcpy(buf_ + used_, p, n);
+        used_ += n;
+    }
+
+    void flush() {
+        if (used_)
+            ar_.saveBinary(buf_, used_);
+        used_ = 0;
+    }
+
+private:
+    OutputArchive& ar_;
+    size_t         used_ = 0;
+    char           buf_[64 * 1024];
+};
+
+// reads from the blob section, loaded in a single buffer
+class BlobReader
+{
+public:
+    BlobReader(const char* p, size_t n) : p_(p), end_(p + n) {}
+
+    bool ok() const { return ok_; }
+    bool done() const { return p_ == end_; }
+
+    // returns a pointer to the next `n` bytes, or nullptr if truncated
+    const char* read(size_t n) {
+        if (static_cast<size_t>(end_ - p_) < n) {
+            ok_ = false;
+            p_ = end_;
+            return nullptr;
+        }
+        const char* res = p_;
+        p_ += n;
+        return res;
+    }
+
+    size_t read_length(size_t elem_size) {
+        uint64_t len = 0;
+        if (const char* p = read(sizeof(len)))
+            std::memcpy(&len, p, sizeof(len));
+        if (len > static_cast<uint64_t>(end_ - p_) / elem_size) {   // cannot be valid
+            ok_ = false;
+            p_ = end_;
+            return 0;
+        }
+        return static_cast<size_t>(len);
+    }
+
+private:
+    const char* p_;
+    const char* end_;
+    bool        ok_ = true;
+};
+
+template <class T>
+struct BlobTraits<T, typename std::enable_if<type_traits_internal::IsTriviallyCopyable<T>::value>::type>
+{
+    static size_t size(const T&) { return sizeof(T); }
+
+    template <class W>
+    static void save(W& w, const T& v) { w.write(&v, sizeof(T)); }
+
+    static T load(BlobReader& r) {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        const char* p = r.read(sizeof(T));
+        if (p)
+            std::memcpy(&storage, p, sizeof(T));
+        else
+            std::memset(&storage, 0, sizeof(T));
+        return *reinterpret_cast<T*>(&storage);
+    }
+};
+
+template <class C, class Tr, class A>
+struct BlobTraits<std::basic_string<C, Tr, A>,
+                  typename std::enable_if<type_traits_internal::IsTriviallyCopyable<C>::value>::type>
+{
+    using S = std::basic_string<C, Tr, A>;
+
+    static size_t size(const S& v) { return sizeof(uint64_t) + v.size() * sizeof(C); }
+
+    template <class W>
+    static void save(W& w, const S& v) {
+        uint64_t len = v.size();
+        w.write(&len, sizeof(len));
+        w.write(v.data(), v.size() * sizeof(C));
+    }
+
+    static S load(BlobReader& r) {
+        size_t len = r.read_length(sizeof(C));
+        S res;
+        if (len) {
+            res.resize(len);
+            std::memcpy(&res[0], r.read(len * sizeof(C)), len * sizeof(C));
+        }
+        return res;
+    }
+};
+
+template <class E, class A>
+struct BlobTraits<std::vector<E, A>, phmap::void_t<decltype(BlobTraits<E>::size(std::declval<const E&>()))>>
+{
+    using V = std::vector<E, A>;
+
+    static size_t size(const V& v) {
+        size_t res = sizeof(uint64_t);
+        PHMAP_IF_CONSTEXPR (type_traits_internal::IsTriviallyCopyable<E>::value) {
+            res += v.size() * sizeof(E);
+        } else {
+            for (const auto& e : v)
+                res += BlobTraits<E>::size(e);
+        }
+        return res;
+    }
+
+    template <class W>
+    static void save(W& w, const V& v) {
+        uint64_t len = v.size();
+        w.write(&len, sizeof(len));
+        PHMAP_IF_CONSTEXPR (type_traits_internal::IsTriviallyCopyable<E>::value) {
+            if (len)
+                w.write(v.data(), v.size() * sizeof(E));
+        } else {
+            for (const auto& e : v)
+                BlobTraits<E>::save(w, e);
+        }
+    }
+
+    static V load(BlobReader& r) {
+        size_t len = r.read_length(type_traits_internal::IsTriviallyCopyable<E>::value ? sizeof(E) : 1);
+        V res;
+        PHMAP_IF_CONSTEXPR (type_traits_internal::IsTriviallyCopyable<E>::value) {
+            if (len) {
+                res.resize(len);
+                std::memcpy(static_cast<void*>(res.data()), r.read(len * sizeof(E)), len * sizeof(E));
+            }
+        } else {
+            res.reserve(len);
+            for (size_t i = 0; i < len && r.ok(); ++i)
+                res.push_back(BlobTraits<E>::load(r));
+        }
+        return res;
+    }
+};
+
+// also used for the pair<const K, V> of the maps, loaded as a pair<K, V>
+template <class T1, class T2>
+struct BlobTraits<std::pair<T1, T2>,
+                  typename std::enable_if<!type_traits_internal::IsTriviallyCopyable<std::pair<T1, T2>>::value,
+                      phmap::void_t<decltype(BlobTraits<T1>::size(std::declval<const T1&>())),
+                                    decltype(BlobTraits<T2>::size(std::declval<const T2&>()))>>::type>
+{
+    template <class P>
+    static size_t size(const P& v) { return BlobTraits<T1>::size(v.first) + BlobTraits<T2>::size(v.second); }
+
+    template <class W, class P>
+    static void save(W& w, const P& v) {
+        BlobTraits<T1>::save(w, v.first);
+        BlobTraits<T2>::save(w, v.second);
+    }
+
+    static std::pair<T1, T2> load(BlobReader& r) {
+        return std::pair<T1, T2>{ BlobTraits<T1>::load(r), BlobTraits<T2>::load(r) };  // in order
+    }
+};
+
+// Calls ar.loadBinary(), and returns its result if it reports errors (the
+// cereal archives return void).
+template <class InputArchive>
+auto LoadChecked(InputArchive& ar, void* p, size_t n, int)
+    -> decltype(static_cast<bool>(ar.loadBinary(p, n))) {
+    return static_cast<bool>(ar.loadBinary(p, n));
+}
+
+template <class InputArchive>
+bool LoadChecked(InputArchive& ar, void* p, size_t n, long) {
+    ar.loadBinary(p, n);
+    return true;
+}
+
+// Saves the control bytes and the slots of a flat table. The archives which
+// define saveTable() (CompressedOutputArchive) get the whole table, so that
+// they can skip its empty slots.
+template <class OutputArchive>
+auto SaveTable(OutputArchive& ar, const ctrl_t* ctrl, size_t ctrl_size,
+               const void* slots, size_t slot_size, size_t capacity, int)
+    -> decltype(ar.saveTable(ctrl, ctrl_size, slots, slot_size, capacity), void()) {
+    ar.saveTable(ctrl, ctrl_size, slots, slot_size, capacity);
+}
+
+template <class OutputArchive>
+void SaveTable(OutputArchive& ar, const ctrl_t* ctrl, size_t ctrl_size,
+               const void* slots, size_t slot_size, size_t capacity, long) {
+    ar.saveBinary(ctrl, ctrl_size);
+    ar.saveBinary(slots, slot_size * capacity);
+}
+
+template <class InputArchive>
+auto LoadTable(InputArchive& ar, ctrl_t* ctrl, size_t ctrl_size,
+               void* slots, size_t slot_size, size_t capacity, int)
+    -> decltype(static_cast<bool>(ar.loadTable(ctrl, ctrl_size, slots, slot_size, capacity))) {
+    return static_cast<bool>(ar.loadTable(ctrl, ctrl_size, slots, slot_size, capacity));
+}
+
+template <class InputArchive>
+bool LoadTable(InputArchive& ar, ctrl_t* ctrl, size_t ctrl_size,
+               void* slots, size_t slot_size, size_t capacity, long) {
+    ar.loadBinary(ctrl, ctrl_size);
+    ar.loadBinary(slots, slot_size * capacity);
+    return true;
+}
+
+}  // namespace priv
+
+namespace type_traits_internal {
+
+// true if the elements can be dumped: trivially copyable, or supported by BlobTraits
+template <class T, class = void>
+struct IsDumpable : std::false_type {};
+
+template <class T>
+struct IsDumpable<T, phmap::void_t<decltype(priv::BlobTraits<T>::size(std::declval<const T&>()))>>
+    : std::true_type {};
+
+}  // namespace type_traits_internal
+
+namespace priv {
+
 // ------------------------------------------------------------------------
 // dump/load for raw_hash_set
+//
+// The flat tables of trivially copyable values are dumped as their arrays of
+// control bytes and slots. For the other ones (including the node tables),
+// the control bytes are followed by a blob section with the serialized
+// elements in slot order: the load allocates the table with its original
+// capacity, reads the blob in a single buffer, and constructs each element
+// (or node) in its slot, without hashing.
 // ------------------------------------------------------------------------
 template <class Policy, class Hash, class Eq, class Alloc>
 template<typename OutputArchive>
 bool raw_hash_set<Policy, Hash, Eq, Alloc>::phmap_dump(OutputArchive& ar) const {
-    static_assert(type_traits_internal::IsTriviallyCopyable<value_type>::value,
-                    "value_type should be trivially copyable");
+    using blob_type = typename PolicyTraits::init_type;
+    static_assert(type_traits_internal::IsDumpable<blob_type>::value,
+                  "value_type should be trivially copyable, or made of strings, vectors and pairs");
+    const bool blob = !std::is_same<typename Policy::is_flat, std::true_type>::value ||
+                      !type_traits_internal::IsTriviallyCopyable<value_type>::value;
 
-    ar.saveBinary(&s_version, sizeof(size_t));
+    ar.saveBinary(blob ? &s_version_blob : &s_version, sizeof(size_t));
     ar.saveBinary(&size_, sizeof(size_t));
     ar.saveBinary(&capacity_, sizeof(size_t));
     if (size_ == 0)
         return true;
+    if (!blob) {
+        SaveTable(ar, ctrl_, sizeof(ctrl_t) * (capacity_ + Group::kWidth + 1),
+                  slots_, sizeof(slot_type), capacity_, 0);
+        ar.saveBinary(&growth_left(), sizeof(size_t));
+        return true;
+    }
+
     ar.saveBinary(ctrl_,  sizeof(ctrl_t) * (capacity_ + Group::kWidth + 1));
-    ar.saveBinary(slots_, sizeof(slot_type) * capacity_);
     ar.saveBinary(&growth_left(), sizeof(size_t));
+    size_t blob_size = 0;
+    for (size_t i = 0; i != capacity_; ++i)
+        if (IsFull(ctrl_[i]))
+            blob_size += BlobTraits<blob_type>::size(PolicyTraits::element(slots_ + i));
+    ar.saveBinary(&blob_size, sizeof(size_t));
+
+    BlobWriter<OutputArchive> writer(ar);
+    for (size_t i = 0; i != capacity_; ++i)
+        if (IsFull(ctrl_[i]))
+            BlobTraits<blob_type>::save(writer, PolicyTraits::element(slots_ + i));
     return true;
 }
 
 template <class Policy, class Hash, class Eq, class Alloc>
 template<typename InputArchive>
 bool raw_hash_set<Policy, Hash, Eq, Alloc>::phmap_load(InputArchive& ar) {
-    static_assert(type_traits_internal::IsTriviallyCopyable<value_type>::value,
-                    "value_type should be trivially copyable");
+    using blob_type = typename PolicyTraits::init_type;
+    static_assert(type_traits_internal::IsDumpable<blob_type>::value,
+                  "value_type should be trivially copyable, or made of strings, vectors and pairs");
     raw_hash_set<Policy, Hash, Eq, Alloc>().swap(*this); // clear any existing content
 
     size_t version = 0;
@@ -83,19 +388,59 @@ bool raw_hash_set<Policy, Hash, Eq, Alloc>::phmap_load(InputArchive& ar) {
     }
     ar.loadBinary(&capacity_, sizeof(size_t));
 
+    const bool blob = version == s_version_blob;
+    if (!blob && (!std::is_same<typename Policy::is_flat, std::true_type>::value ||
+                  !type_traits_internal::IsTriviallyCopyable<value_type>::value)) {
+        size_ = capacity_ = 0;
+        return false;         // not dumped by this kind of table
+    }
+
     if (capacity_) {
         // allocate memory for ctrl_ and slots_
         initialize_slots(capacity_);
     }
     if (size_ == 0)
         return true;
+    if (!blob) {
+        if (!LoadTable(ar, ctrl_, sizeof(ctrl_t) * (capacity_ + Group::kWidth + 1),
+                       slots_, sizeof(slot_type), capacity_, 0)) {
+            clear();
+            return false;
+        }
+        if (version >= s_version_base) {
+            // growth_left should be restored after calling initialize_slots() which resets it.
+            ar.loadBinary(&growth_left(), sizeof(size_t));
+        } else {
+           drop_deletes_without_resize();
+        }
+        return true;
+    }
+
     ar.loadBinary(ctrl_,  sizeof(ctrl_t) * (capacity_ + Group::kWidth + 1));
-    ar.loadBinary(slots_, sizeof(slot_type) * capacity_);
-    if (version >= s_version_base) {
-        // growth_left should be restored after calling initialize_slots() which resets it.
-        ar.loadBinary(&growth_left(), sizeof(size_t));
-    } else {
-       drop_deletes_without_resize();
+    ar.loadBinary(&growth_left(), sizeof(size_t));
+    size_t blob_size = 0;
+    ar.loadBinary(&blob_size, sizeof(size_t));
+    std::unique_ptr<char[]> buf(new char[blob_size ? blob_size : 1]);
+    bool loaded = LoadChecked(ar, buf.get(), blob_size, 0);
+
+    BlobReader reader(buf.get(), loaded ? blob_size : 0);
+    size_t i = 0;
+    for (; i != capacity_ && reader.ok(); ++i) {
+        if (IsFull(ctrl_[i])) {
+            blob_type v = BlobTraits<blob_type>::load(reader);
+            if (reader.ok())
+                PolicyTraits::construct(&alloc_ref(), slots_ + i, std::move(v));
+            else
+                break;
+        }
+    }
+    if (!reader.ok() || !reader.done()) {
+        // truncated or invalid: the elements not constructed are dropped
+        for (; i != capacity_; ++i)
+            if (IsFull(ctrl_[i]))
+                set_ctrl(i, kEmpty);
+        clear();
+        return false;
     }
     return true;
 }
@@ -109,8 +454,8 @@ template <size_t N,
           class Policy, class Hash, class Eq, class Alloc>
 template<typename OutputArchive>
 bool parallel_hash_set<N, RefSet, Mtx_, Policy, Hash, Eq, Alloc>::phmap_dump(OutputArchive& ar) const {
-    static_assert(type_traits_internal::IsTriviallyCopyable<value_type>::value,
-                  "value_type should be trivially copyable");
+    static_assert(type_traits_internal::IsDumpable<typename PolicyTraits::init_type>::value,
+                  "value_type should be trivially copyable, or made of strings, vectors and pairs");
 
     size_t submap_count = subcnt();
     ar.saveBinary(&submap_count, sizeof(size_t));
@@ -131,8 +476,8 @@ template <size_t N,
           class Policy, class Hash, class Eq, class Alloc>
 template<typename InputArchive>
 bool parallel_hash_set<N, RefSet, Mtx_, Policy, Hash, Eq, Alloc>::phmap_load(InputArchive& ar) {
-    static_assert(type_traits_internal::IsTriviallyCopyable<value_type>::value,
-                  "value_type should be trivially copyable");
+    static_assert(type_traits_internal::IsDumpable<typename PolicyTraits::init_type>::value,
+                  "value_type should be trivially copyable, or made of strings, vectors and pairs");
 
     size_t submap_count = 0;
     ar.loadBinary(&submap_count, sizeof(size_t));
@@ -144,6 +489,7 @@ bool parallel_hash_set<N, RefSet, Mtx_, Policy, Hash, Eq, Alloc>::phmap_load(Inp
     for (size_t i = 0; i < submap_count; ++i) {            
         auto& inner = sets_[i];
         typename Lockable::UniqueLock m(const_cast<Inner&>(inner));
+        set_modified(inner);
         if (!inner.set_.phmap_load(ar)) {
             std::cerr << "Failed to load submap " << i << std::endl;
             return false;
@@ -152,6 +498,160 @@ bool parallel_hash_set<N, RefSet, Mtx_, Policy, Hash, Eq, Alloc>::phmap_load(Inp
     return true;
 }
 
+// ------------------------------------------------------------------------
+// Background dump of a live parallel_hash_set: each submap is serialized to
+// a memory buffer while its lock is held (in shared mode when the mutex
+// supports it), and the buffer is written to the archive after the lock is
+// released, so that the writers to the other submaps are never blocked.
+// Every submap is consistent, but they are copied at different times.
+// The map and the archive must outlive the returned future. The output is
+// the one of phmap_dump(), and can be read by phmap_load().
+// ------------------------------------------------------------------------
+class MemoryOutputArchive
+{
+public:
+    bool saveBinary(const void* p, size_t sz) {
+        const char* s = static_cast<const char*>(p);
+        buf_.insert(buf_.end(), s, s + sz);
+        return true;
+    }
+
+    void        clear()       { buf_.clear(); }
+    const char* data() const  { return buf_.data(); }
+    size_t      size() const  { return buf_.size(); }
+
+private:
+    std::vector<char> buf_;
+};
+
+template <size_t N,
+          template <class, class, class, class> class RefSet,
+          class Mtx_,
+          class Policy, class Hash, class Eq, class Alloc>
+template<typename OutputArchive>
+std::future<bool> parallel_hash_set<N, RefSet, Mtx_, Policy, Hash, Eq, Alloc>::dump_async(
+    OutputArchive& ar,
+    std::function<void(size_t, size_t)> progress,
+    std::function<void(bool)> done) const {
+    static_assert(type_traits_internal::IsDumpable<typename PolicyTraits::init_type>::value,
+                  "value_type should be trivially copyable, or made of strings, vectors and pairs");
+
+    return std::async(std::launch::async, [this, &ar, progress, done]() {
+        bool ok = true;
+        PHMAP_INTERNAL_TRY {
+            size_t submap_count = subcnt();
+            ar.saveBinary(&submap_count, sizeof(size_t));
+
+            MemoryOutputArchive buf;     // reused: sized for the largest submap
+            for (size_t i = 0; i < submap_count && ok; ++i) {
+                auto& inner = sets_[i];
+                buf.clear();
+                {
+                    typename Lockable::SharedLock m(const_cast<Inner&>(inner));
+                    ok = inner.set_.phmap_dump(buf);
+                }
+                ok = ok && ar.saveBinary(buf.data(), buf.size());
+                if (!ok)
+                    std::cerr << "Failed to dump submap " << i << std::endl;
+                else if (progress)
+                    progress(i + 1, submap_count);
+            }
+        }
+        PHMAP_INTERNAL_CATCH_ANY {
+            if (done)
+                done(false);
+            PHMAP_INTERNAL_RETHROW;
+        }
+        if (done)
+            done(ok);
+        return ok;
+    });
+}
+
+// ------------------------------------------------------------------------
+// Delta dumps of parallel_hash_set: only the submaps modified since an
+// epoch are written, and load_deltas() replaces them in a map loaded from
+// the base dump.
+// ------------------------------------------------------------------------
+//    size_t since = m.advance_epoch();
+//    m.phmap_dump(base_ar);
+//    ...
+//    size_t next = m.advance_epoch();
+//    m.dump_delta(delta_ar, since);      // modified after the base dump
+//    since = next;
+//
+// A delta holds the version tag, the submap count, then the index and the
+// record of each modified submap, and ends with an index of -1. The input
+// archive should report read errors (as the archives of this file do), so
+// that the end of the input is detected.
+// ------------------------------------------------------------------------
+template <size_t N,
+          template <class, class, class, class> class RefSet,
+          class Mtx_,
+          class Policy, class Hash, class Eq, class Alloc>
+template<typename OutputArchive>
+bool parallel_hash_set<N, RefSet, Mtx_, Policy, Hash, Eq, Alloc>::dump_delta(OutputArchive& ar,
+                                                                          size_t since_epoch) const {
+    static_assert(type_traits_internal::IsDumpable<typename PolicyTraits::init_type>::value,
+                  "value_type should be trivially copyable, or made of strings, vectors and pairs");
+
+    size_t submap_count = subcnt();
+    ar.saveBinary(&s_version_delta, sizeof(size_t));
+    ar.saveBinary(&submap_count, sizeof(size_t));
+    for (size_t i = 0; i < submap_count; ++i) {
+        auto& inner = sets_[i];
+        typename Lockable::SharedLock m(const_cast<Inner&>(inner));
+        if (inner.modified_ < since_epoch)
+            continue;
+        ar.saveBinary(&i, sizeof(size_t));
+        if (!inner.set_.phmap_dump(ar)) {
+            std::cerr << "Failed to dump submap " << i << std::endl;
+            return false;
+        }
+    }
+    const size_t end = static_cast<size_t>(-1);
+    ar.saveBinary(&end, sizeof(size_t));
+    return true;
+}
+
+template <size_t N,
+          template <class, class, class, class> class RefSet,
+          class Mtx_,
+          class Policy, class Hash, class Eq, class Alloc>
+template<typename InputArchive>
+bool parallel_hash_set<N, RefSet, Mtx_, Policy, Hash, Eq, Alloc>::load_deltas(InputArchive& ar) {
+    static_assert(type_traits_internal::IsDumpable<typename PolicyTraits::init_type>::value,
+                  "value_type should be trivially copyable, or made of strings, vectors and pairs");
+
+    for (size_t deltas = 0; ; ++deltas) {
+        size_t version = 0, submap_count = 0;
+        if (!LoadChecked(ar, &version, sizeof(size_t), 0))
+            return deltas > 0;                      // end of the input
+        if (version != s_version_delta ||
+            !LoadChecked(ar, &submap_count, sizeof(size_t), 0) || submap_count != subcnt()) {
+            std::cerr << "Invalid delta " << deltas << std::endl;
+            return false;
+        }
+        for (;;) {
+            size_t i = submap_count;
+            if (!LoadChecked(ar, &i, sizeof(size_t), 0) ||
+                (i >= submap_count && i != static_cast<size_t>(-1))) {
+                std::cerr << "Invalid delta " << deltas << std::endl;
+                return false;
+            }
+            if (i == static_cast<size_t>(-1))
+                break;
+            auto& inner = sets_[i];
+            typename Lockable::UniqueLock m(inner);
+            set_modified(inner);
+            if (!inner.set_.phmap_load(ar)) {
+                std::cerr << "Failed to load submap " << i << " of delta " << deltas << std::endl;
+                return false;
+            }
+        }
+    }
+}
+
 #endif // !defined(PHMAP_NON_DETERMINISTIC) && !defined(PHMAP_DISABLE_DUMP)
 
 } // namespace priv
@@ -230,7 +730,7 @@ public:
 
     bool loadBinary(void* p, size_t sz) {
         is_->read(reinterpret_cast<char*>(p),  (std::streamsize)sz);
-        return true;
+        return !is_->fail();
     }
 
     template<typename V>
@@ -251,6 +751,1325 @@ private:
     std::function<void()> destruct_;
 };
 
+// ------------------------------------------------------------------------
+// CompressedArchive
+//       Adapters compressing the data written to (or read from) another
+//       archive, in blocks, with a pluggable codec.
+// ------------------------------------------------------------------------
+//    phmap::BinaryOutputArchive file_out("./dump.data");
+//    {
+//        phmap::CompressedOutputArchive<phmap::BinaryOutputArchive> ar_out(file_out);
+//        m.phmap_dump(ar_out);
+//    }                                              // flushed when destroyed
+//    phmap::BinaryInputArchive file_in("./dump.data");
+//    phmap::CompressedInputArchive<phmap::BinaryInputArchive> ar_in(file_in);
+//    m2.phmap_load(ar_in);
+//
+// phmap_dump() gives the flat tables of trivially copyable values to the
+// adapter as a whole (see priv::SaveTable()), which writes only their full
+// slots, packed, after the control bytes: mostly empty tables are stored in
+// proportion of their size, not of their capacity. The load puts back each
+// slot at its place, without hashing.
+//
+// A codec encodes blocks of records of `width` bytes (1 for the control
+// bytes and the other data, the slot size for the packed slots):
+//
+//    struct Codec {
+//        // appends the encoding of [p, p + n) to out
+//        void encode(const char* p, size_t n, size_t width, std::vector<char>& out) const;
+//        // decodes exactly out_size bytes from [p, p + n), returns false if invalid
+//        bool decode(const char* p, size_t n, char* out, size_t out_size, size_t width) const;
+//    };
+//
+// The default PlaneRleCodec has no dependency. Each block is stored as: a tag,
+// its raw size, the size of its encoded parts, and the encoded parts.
+// ------------------------------------------------------------------------
+
+// Splits the records in byte planes (the first byte of all the records, then
+// the second one...), and run-length encodes each plane: the high bytes of
+// small integer keys and values, and the empty control bytes, are mostly long
+// runs. The lengths of the runs and of the literal sequences are varints.
+class PlaneRleCodec
+{
+public:
+    void encode(const char* p, size_t n, size_t width, std::vector<char>& out) const {
+        if (width == 0 || n % width)
+            width = 1;
+        const size_t count = n / width;
+        for (size_t b = 0; b < width; ++b) {
+            const char* plane = p + b;
+            size_t i = 0, literal = 0;    // [i - literal, i) not written yet
+            while (i < count) {
+                const char c = plane[i * width];
+                size_t run = 1;
+                while (i + run < count && plane[(i + run) * width] == c)
+                    ++run;
+                if (run >= kMinRun) {
+                    put_literal(plane + (i - literal) * width, literal, width, out);
+                    literal = 0;
+                    put_varint((uint64_t(run) << 1) | 1, out);
+                    out.push_back(c);
+                } else {
+                    literal += run;
+                }
+                i += run;
+            }
+            put_literal(plane + (i - literal) * width, literal, width, out);
+        }
+    }
+
+    bool decode(const char* p, size_t n, char* out, size_t out_size, size_t width) const {
+        if (width == 0 || out_size % width)
+            width = 1;
+        const size_t count = out_size / width;
+        const char* end = p + n;
+        for (size_t b = 0; b < width; ++b) {
+            char* plane = out + b;
+            for (size_t i = 0; i < count; ) {
+                uint64_t token;
+                if (!get_varint(p, end, token))
+                    return false;
+                const uint64_t len = token >> 1;
+                if (len == 0 || len > count - i)
+                    return false;
+                if (token & 1) {
+                    if (p == end)
+                        return false;
+                    const char c = *p++;
+                    for (size_t j = 0; j < len; ++j)
+                        plane[(i + j) * width] = c;
+                } else {
+                    if (static_cast<uint64_t>(end - p) < len)
+                        return false;
+                    for (size_t j = 0; j < len; ++j)
+                        plane[(i + j) * width] = *p++;
+                }
+                i += static_cast<size_t>(len);
+            }
+        }
+        return p == end;
+    }
+
+private:
+    static constexpr size_t kMinRun = 4;
+
+    static void put_varint(uint64_t v, std::vector<char>& out) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<char>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<char>(v));
+    }
+
+    static bool get_varint(const char*& p, const char* end, uint64_t& v) {
+        v = 0;
+        for (int shift = 0; shift < 64 && p != end; shift += 7) {
+            const uint8_t c = static_cast<uint8_t>(*p++);
+            v |= uint64_t(c & 0x7f) << shift;
+            if (c < 0x80)
+                return true;
+        }
+        return false;
+    }
+
+    static void put_literal(const char* p, size_t len, size_t width, std::vector<char>& out) {
+        if (len == 0)
+            return;
+        put_varint(uint64_t(len) << 1, out);
+        for (size_t j = 0; j < len; ++j)
+            out.push_back(p[j * width]);
+    }
+};
+
+namespace priv {
+
+// block tags of the compressed archives
+enum : uint64_t { kCompressedBytes = 1, kCompressedTable = 2 };
+
+}  // namespace priv
+
+template <class Archive, class Codec = PlaneRleCodec>
+class CompressedOutputArchive {
+public:
+    // The data is encoded in blocks of `block_size` bytes (for the tables,
+    // of slots covering at most `block_size` bytes).
+    explicit CompressedOutputArchive(Archive& ar, size_t block_size = size_t(1) << 20,
+                                     Codec codec = Codec()) :
+        ar_(ar), codec_(std::move(codec)), block_size_(block_size ? block_size : 1)
+    {}
+
+    ~CompressedOutputArchive() { flush(); }
+
+    CompressedOutputArchive(const CompressedOutputArchive&) = delete;
+    CompressedOutputArchive& operator=(const CompressedOutputArchive&) = delete;
+
+    bool saveBinary(const void *p, size_t sz) {
+        const char* s = static_cast<const char*>(p);
+        while (sz) {
+            size_t n = std::min(sz, block_size_ - bytes_.size());
+            bytes_.insert(bytes_.end(), s, s + n);
+            s  += n;
+            sz -= n;
+            if (bytes_.size() == block_size_)
+                flush_bytes();
+        }
+        return ok_;
+    }
+
+    template<typename V>
+    typename std::enable_if<type_traits_internal::IsTriviallyCopyable<V>::value, bool>::type
+    saveBinary(const V& v) {
+        return saveBinary(&v, sizeof(V));
+    }
+
+    template<typename Map>
+    auto saveBinary(const Map& v) -> decltype(v.phmap_dump(*this), bool())
+    {
+        return v.phmap_dump(*this);
+    }
+
+    // Called by phmap_dump() with the control bytes and the slots of a flat
+    // table: only the full slots are written.
+    bool saveTable(const priv::ctrl_t* ctrl, size_t ctrl_size,
+                   const void* slots, size_t slot_size, size_t capacity) {
+        flush_bytes();
+        const char* s = static_cast<const char*>(slots);
+        const size_t step = slot_size < block_size_ ? block_size_ / slot_size : 1;
+        for (size_t b = 0; b < ctrl_size; b += step) {
+            const size_t e = std::min(ctrl_size, b + step);
+            packed_.clear();
+            for (size_t i = b; i < std::min(e, capacity); ++i)
+                if (priv::IsFull(ctrl[i]))
+                    packed_.insert(packed_.end(), s + i * slot_size, s + (i + 1) * slot_size);
+            enc_.clear();
+            codec_.encode(reinterpret_cast<const char*>(ctrl + b), e - b, 1, enc_);
+            const size_t ctrl_enc = enc_.size();
+            codec_.encode(packed_.data(), packed_.size(), slot_size, enc_);
+            write_block(priv::kCompressedTable, e - b, ctrl_enc);
+        }
+        return ok_;
+    }
+
+    // writes the pending data to the underlying archive
+    bool flush() {
+        flush_bytes();
+        return ok_;
+    }
+
+    bool good() const { return ok_; }
+
+private:
+    void flush_bytes() {
+        if (bytes_.empty())
+            return;
+        enc_.clear();
+        codec_.encode(bytes_.data(), bytes_.size(), 1, enc_);
+        write_block(priv::kCompressedBytes, bytes_.size(), enc_.size());
+        bytes_.clear();
+    }
+
+    void write_block(uint64_t tag, size_t raw_size, size_t first_size) {
+        uint64_t header[4] = { tag, raw_size, first_size, enc_.size() - first_size };
+        ok_ = ar_.saveBinary(header, sizeof(header)) && ok_;
+        ok_ = ar_.saveBinary(enc_.data(), enc_.size()) && ok_;
+    }
+
+    Archive&          ar_;
+    Codec             codec_;
+    size_t            block_size_;
+    std::vector<char> bytes_;     // pending data of saveBinary()
+    std::vector<char> packed_;    // full slots of a table block
+    std::vector<char> enc_;
+    bool              ok_ = true;
+};
+
+template <class Archive, class Codec = PlaneRleCodec>
+class CompressedInputArchive {
+public:
+    explicit CompressedInputArchive(Archive& ar, Codec codec = Codec()) :
+        ar_(ar), codec_(std::move(codec))
+    {}
+
+    CompressedInputArchive(const CompressedInputArchive&) = delete;
+    CompressedInputArchive& operator=(const CompressedInputArchive&) = delete;
+
+    bool loadBinary(void* p, size_t sz) {
+        char* d = static_cast<char*>(p);
+        while (sz && ok_) {
+            if (pos_ == bytes_.size() && !read_bytes())
+                break;
+            size_t n = std::min(sz, bytes_.size() - pos_);
+            std::memcpy(d, bytes_.data() + pos_, n);
+            pos_ += n;
+            d    += n;
+            sz   -= n;
+        }
+        return ok_;
+    }
+
+    template<typename V>
+    typename std::enable_if<type_traits_internal::IsTriviallyCopyable<V>::value, bool>::type
+    loadBinary(V* v) {
+        return loadBinary(static_cast<void*>(v), sizeof(V));
+    }
+
+    template<typename Map>
+    auto loadBinary(Map* v) -> decltype(v->phmap_load(*this), bool())
+    {
+        return v->phmap_load(*this);
+    }
+
+    // Called by phmap_load() for the flat tables. The empty slots are not
+    // written. A table stored as plain data (dump_async() for example) is
+    // read as such.
+    bool loadTable(priv::ctrl_t* ctrl, size_t ctrl_size,
+                   void* slots, size_t slot_size, size_t capacity) {
+        char* d = static_cast<char*>(slots);
+        for (size_t b = 0; b < ctrl_size && ok_; ) {
+            if (b == 0 && pos_ != bytes_.size())
+                break;
+            if (!read_block())
+                return false;
+            if (b == 0 && header_[0] == priv::kCompressedBytes) {
+                if (!decode_bytes())
+                    return false;
+                break;
+            }
+            const size_t raw = static_cast<size_t>(header_[1]);
+            if (header_[0] != priv::kCompressedTable || raw == 0 || header_[1] > ctrl_size - b ||
+                !codec_.decode(enc_.data(), static_cast<size_t>(header_[2]),
+                               reinterpret_cast<char*>(ctrl + b), raw, 1))
+                return ok_ = false;
+
+            const size_t e = std::min(b + raw, capacity);
+            size_t full = 0;
+            for (size_t i = b; i < e; ++i)
+                full += priv::IsFull(ctrl[i]) ? 1 : 0;
+            packed_.resize(full * slot_size);
+            if (!codec_.decode(enc_.data() + header_[2], static_cast<size_t>(header_[3]),
+                               packed_.data(), packed_.size(), slot_size))
+                return ok_ = false;
+            const char* s = packed_.data();
+            for (size_t i = b; i < e; ++i) {
+                if (priv::IsFull(ctrl[i])) {
+                    std::memcpy(d + i * slot_size, s, slot_size);
+                    s += slot_size;
+                }
+            }
+            b += raw;
+            if (b == ctrl_size)
+                return ok_;
+        }
+        return loadBinary(ctrl, ctrl_size) && loadBinary(slots, slot_size * capacity);
+    }
+
+    bool good() const { return ok_; }
+
+private:
+    bool read_block() {
+        if (!priv::LoadChecked(ar_, header_, sizeof(header_), 0) ||
+            header_[2] > header_[2] + header_[3])
+            return ok_ = false;
+        enc_.resize(static_cast<size_t>(header_[2] + header_[3]));
+        return ok_ = priv::LoadChecked(ar_, enc_.data(), enc_.size(), 0);
+    }
+
+    bool decode_bytes() {
+        bytes_.resize(static_cast<size_t>(header_[1]));
+        pos_ = 0;
+        if (header_[3] != 0 ||
+            !codec_.decode(enc_.data(), enc_.size(), bytes_.data(), bytes_.size(), 1)) {
+            bytes_.clear();
+            return ok_ = false;
+        }
+        return true;
+    }
+
+    bool read_bytes() {
+        if (!read_block() || header_[0] != priv::kCompressedBytes)
+            return ok_ = false;
+        return decode_bytes();
+    }
+
+    Archive&          ar_;
+    Codec             codec_;
+    uint64_t          header_[4];
+    std::vector<char> bytes_;     // decoded data of the current block
+    size_t            pos_ = 0;
+    std::vector<char> packed_;
+    std::vector<char> enc_;
+    bool              ok_ = true;
+};
+
+#if PHMAP_HAVE_MMAP
+
+// ------------------------------------------------------------------------
+// FdArchive
+//       Binary archives on a POSIX file descriptor, for dumps of many GB:
+//       the data is gathered in a large aligned buffer, written with
+//       pwrite() and read with pread() at explicit file offsets.
+// ------------------------------------------------------------------------
+//    phmap::FdOutputArchive ar_out("./dump.data", true);   // O_DIRECT
+//    m.phmap_dump(ar_out);
+//
+// With `direct`, the file is opened with O_DIRECT (buffered I/O is used when
+// the file system does not support it): the data is written in whole blocks,
+// bypassing the page cache, and the padding of the last block is truncated
+// when the archive is closed. The input archive tells the kernel that the
+// file is read sequentially, and requests the readahead of the next buffer
+// while the current one is consumed.
+//
+// An archive can also use a file descriptor which is already open (and which
+// it does not close), starting at a given offset: several archives can then
+// write, or read, disjoint ranges of the same file concurrently (one per
+// submap for example). Only the archives opening their file use O_DIRECT.
+// ------------------------------------------------------------------------
+namespace priv {
+
+class FdBuffer
+{
+public:
+    static constexpr size_t kAlignment = 4096;
+
+    explicit FdBuffer(size_t size) :
+        size_(size < kAlignment ? kAlignment : (size + kAlignment - 1) & ~(kAlignment - 1))
+    {
+        void* p = nullptr;
+        if (::posix_memalign(&p, kAlignment, size_) != 0)
+            phmap::base_internal::ThrowStdBadAlloc();
+        data_ = static_cast<char*>(p);
+    }
+
+    ~FdBuffer() { ::free(data_); }
+
+    FdBuffer(const FdBuffer&) = delete;
+    FdBuffer& operator=(const FdBuffer&) = delete;
+
+    char*  data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    size_t size_;
+    char*  data_;
+};
+
+// Opens `path`, with O_DIRECT when requested and supported (then `is_direct`
+// is set, and the transfers must be aligned on FdBuffer::kAlignment).
+inline int FdOpen(const char* path, int flags, bool direct, bool& is_direct) {
+    is_direct = false;
+    int fd = -1;
+#if defined(O_DIRECT)
+    if (direct) {
+        fd = ::open(path, flags | O_DIRECT, 0644);
+        is_direct = fd >= 0;
+    }
+#endif
+    if (fd < 0)
+        fd = ::open(path, flags, 0644);
+    if (fd < 0)
+        phmap::base_internal::ThrowStdRuntimeError(std::string("phmap: cannot open ") + path);
+#if !defined(O_DIRECT) && defined(F_NOCACHE)
+    if (direct)
+        ::fcntl(fd, F_NOCACHE, 1);      // no alignment constraint
+#endif
+    return fd;
+}
+
+// Some file systems accept O_DIRECT at open(), and refuse the transfers with
+// EINVAL: the descriptor then falls back to buffered I/O.
+inline bool FdDropDirect(int fd, bool& is_direct) {
+#if defined(O_DIRECT)
+    if (is_direct && errno == EINVAL) {
+        int flags = ::fcntl(fd, F_GETFL);
+        if (flags != -1 && ::fcntl(fd, F_SETFL, flags & ~O_DIRECT) == 0) {
+            is_direct = false;
+            return true;
+        }
+    }
+#else
+    (void)fd; (void)is_direct;
+#endif
+    return false;
+}
+
+inline bool FdWriteAt(int fd, const char* p, size_t n, uint64_t offset, bool& is_direct) {
+    while (n > 0) {
+        ssize_t w = ::pwrite(fd, p, n, static_cast<off_t>(offset));
+        if (w < 0) {
+            if (errno == EINTR || FdDropDirect(fd, is_direct))
+                continue;
+            return false;
+        }
+        p += w;
+        n -= static_cast<size_t>(w);
+        offset += static_cast<uint64_t>(w);
+    }
+    return true;
+}
+
+// returns the number of bytes read (less than `n` at the end of the file), or -1
+inline ssize_t FdReadAt(int fd, char* p, size_t n, uint64_t offset, bool& is_direct) {
+    size_t done = 0;
+    while (done < n) {
+        ssize_t r = ::pread(fd, p + done, n - done, static_cast<off_t>(offset + done));
+        if (r < 0) {
+            if (errno == EINTR || FdDropDirect(fd, is_direct))
+                continue;
+            return -1;
+        }
+        if (r == 0)
+            break;
+        done += static_cast<size_t>(r);
+    }
+    return static_cast<ssize_t>(done);
+}
+
+} // namespace priv
+
+// ------------------------------------------------------------------------
+// ------------------------------------------------------------------------
+class FdOutputArchive {
+public:
+    static constexpr size_t kDefaultBufferSize = size_t(8) << 20;
+
+    // creates (or truncates) the file
+    FdOutputArchive(const char* file_path, bool direct = false,
+                    size_t buffer_size = kDefaultBufferSize) :
+        buf_(buffer_size),
+        fd_(priv::FdOpen(file_path, O_WRONLY | O_CREAT | O_TRUNC, direct, direct_)),
+        own_fd_(true)
+    {}
+
+    // writes to `fd` from `offset`, and leaves it open
+    FdOutputArchive(int fd, uint64_t offset, size_t buffer_size = kDefaultBufferSize) :
+        buf_(buffer_size), fd_(fd), pos_(offset)
+    {}
+
+    ~FdOutputArchive() { close(); }
+
+    FdOutputArchive(const FdOutputArchive&) = delete;
+    FdOutputArchive& operator=(const FdOutputArchive&) = delete;
+
+    bool saveBinary(const void *p, size_t sz) {
+        const char* s = static_cast<const char*>(p);
+        while (sz > 0 && good_) {
+            if (used_ == 0 && !direct_ && sz >= buf_.size()) {
+                // large write: no copy in the buffer
+                good_ = priv::FdWriteAt(fd_, s, sz, pos_, direct_);
+                pos_ += sz;
+                break;
+            }
+            size_t n = (std::min)(sz, buf_.size() - used_);
+            memcpy(buf_.data() + used_, s, n);
+            used_ += n;
+            s += n;
+            sz -= n;
+            if (used_ == buf_.size())
+                flush();
+        }
+        return good_;
+    }
+
+    template<typename V>
+    typename std::enable_if<type_traits_internal::IsTriviallyCopyable<V>::value, bool>::type
+    saveBinary(const V& v) {
+        return saveBinary(&v, sizeof(V));
+    }
+
+    template<typename Map>
+    auto saveBinary(const Map& v) -> decltype(v.phmap_dump(*this), bool())
+    {
+        return v.phmap_dump(*this);
+    }
+
+    // Writes the buffered data. With O_DIRECT, a partial last block stays in
+    // the buffer until close().
+    bool flush() {
+        size_t n = direct_ ? (used_ & ~(priv::FdBuffer::kAlignment - 1)) : used_;
+        if (n == 0 || !good_)
+            return good_;
+        good_ = priv::FdWriteAt(fd_, buf_.data(), n, pos_, direct_);
+        pos_ += n;
+        used_ -= n;
+        memmove(buf_.data(), buf_.data() + n, used_);
+        return good_;
+    }
+
+    // Writes the remaining data, and closes the file if the archive opened it.
+    // Returns false if any write failed.
+    bool close() {
+        if (fd_ < 0)
+            return good_;
+        flush();
+        if (used_ > 0 && good_) {
+            // O_DIRECT: pad the last block, then cut the file to its size
+            const size_t align = priv::FdBuffer::kAlignment;
+            size_t n = (used_ + align - 1) & ~(align - 1);
+            memset(buf_.data() + used_, 0, n - used_);
+            good_ = priv::FdWriteAt(fd_, buf_.data(), n, pos_, direct_) &&
+                    ::ftruncate(fd_, static_cast<off_t>(pos_ + used_)) == 0;
+            pos_ += used_;
+            used_ = 0;
+        }
+        if (own_fd_ && ::close(fd_) != 0)
+            good_ = false;
+        fd_ = -1;
+        return good_;
+    }
+
+    bool     good() const   { return good_; }
+    bool     direct() const { return direct_; }
+    uint64_t offset() const { return pos_ + used_; }  // where the next byte is written
+
+private:
+    priv::FdBuffer buf_;
+    bool           direct_ = false;
+    int            fd_;
+    bool           own_fd_ = false;
+    bool           good_ = true;
+    uint64_t       pos_ = 0;       // file offset of buf_.data()
+    size_t         used_ = 0;
+};
+
+
+class FdInputArchive {
+public:
+    static constexpr size_t kDefaultBufferSize = size_t(8) << 20;
+
+    FdInputArchive(const char* file_path, bool direct = false,
+                   size_t buffer_size = kDefaultBufferSize) :
+        buf_(buffer_size),
+        fd_(priv::FdOpen(file_path, O_RDONLY, direct, direct_)),
+        own_fd_(true)
+    {
+        advise();
+    }
+
+    // reads `fd` from `offset`, and leaves it open
+    FdInputArchive(int fd, uint64_t offset, size_t buffer_size = kDefaultBufferSize) :
+        buf_(buffer_size), fd_(fd), pos_(offset)
+    {
+        advise();
+    }
+
+    ~FdInputArchive() {
+        if (own_fd_)
+            ::close(fd_);
+    }
+
+    FdInputArchive(const FdInputArchive&) = delete;
+    FdInputArchive& operator=(const FdInputArchive&) = delete;
+
+    bool loadBinary(void* p, size_t sz) {
+        char* d = static_cast<char*>(p);
+        while (sz > 0 && good_) {
+            if (next_ == end_) {
+                if (!direct_ && sz >= buf_.size()) {
+                    // large read: no copy from the buffer
+                    good_ = priv::FdReadAt(fd_, d, sz, pos_, direct_) == static_cast<ssize_t>(sz);
+                    pos_ += sz;
+                    prefetch();
+                    break;
+                }
+                fill();
+                continue;
+            }
+            size_t n = (std::min)(sz, end_ - next_);
+            memcpy(d, buf_.data() + next_, n);
+            next_ += n;
+            d += n;
+            sz -= n;
+        }
+        return good_;
+    }
+
+    template<typename V>
+    typename std::enable_if<type_traits_internal::IsTriviallyCopyable<V>::value, bool>::type
+    loadBinary(V* v) {
+        return loadBinary(static_cast<void*>(v), sizeof(V));
+    }
+
+    template<typename Map>
+    auto loadBinary(Map* v) -> decltype(v->phmap_load(*this), bool())
+    {
+        return v->phmap_load(*this);
+    }
+
+    bool     good() const   { return good_; }
+    bool     direct() const { return direct_; }
+    uint64_t offset() const { return pos_ - (end_ - next_); } // where the next byte is read
+
+private:
+    void fill() {
+        ssize_t r = priv::FdReadAt(fd_, buf_.data(), buf_.size(), pos_, direct_);
+        good_ = r > 0;
+        next_ = 0;
+        end_  = good_ ? static_cast<size_t>(r) : 0;
+        pos_ += end_;
+        prefetch();
+    }
+
+    void advise() {
+#if defined(POSIX_FADV_SEQUENTIAL)
+        if (!direct_)
+            ::posix_fadvise(fd_, static_cast<off_t>(pos_), 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    }
+
+    void prefetch() {
+#if defined(POSIX_FADV_WILLNEED)
+        if (!direct_)
+            ::posix_fadvise(fd_, static_cast<off_t>(pos_), static_cast<off_t>(buf_.size()),
+                            POSIX_FADV_WILLNEED);
+#endif
+    }
+
+    priv::FdBuffer buf_;
+    bool           direct_ = false;
+    int            fd_;
+    bool           own_fd_ = false;
+    bool           good_ = true;
+    uint64_t       pos_ = 0;       // file offset of the end of the buffered data
+    size_t         next_ = 0;
+    size_t         end_ = 0;
+};
+
+#endif // PHMAP_HAVE_MMAP
+
+#if PHMAP_HAVE_MMAP && !defined(PHMAP_NON_DETERMINISTIC) && !defined(PHMAP_DISABLE_DUMP)
+
+// ------------------------------------------------------------------------
+// Chunked dump/load of parallel_hash_set, one thread per submap
+// ------------------------------------------------------------------------
+//    m.phmap_dump_chunked("./dump.data");
+//    m2.phmap_load_chunked("./dump.data");    // m2 may have a different N
+//
+// The file starts with a header giving the offset of each submap record
+// (the records are the ones written by phmap_dump()), so that the threads
+// write and read their submaps concurrently with positional I/O. All the
+// submaps are locked during the dump (or the load).
+//
+// When the number of submaps differs, the records are loaded in temporary
+// tables, and their elements are moved (without copy) to the submaps they
+// belong to: this needs 16 bytes of temporary memory per element.
+// ------------------------------------------------------------------------
+namespace priv {
+
+// Calls f(i) for each i in [0, n), on num_threads threads (0: one per core).
+// An exception thrown by f is rethrown once all the threads have stopped.
+template <class F>
+void ParallelFor(size_t n, size_t num_threads, const F& f) {
+    if (num_threads == 0)
+        num_threads = std::thread::hardware_concurrency();
+    num_threads = (std::max)(size_t(1), (std::min)(num_threads, n));
+
+    std::atomic<size_t> next(0);
+    std::vector<std::exception_ptr> errors(num_threads);
+    auto work = [&](size_t t) {
+        PHMAP_INTERNAL_TRY {
+            for (size_t i = next++; i < n; i = next++)
+                f(i);
+        }
+        PHMAP_INTERNAL_CATCH_ANY {
+            errors[t] = std::current_exception();
+            next = n;
+        }
+        (void)t;
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < num_threads; ++t)
+        threads.emplace_back(work, t);
+    work(0);
+    for (auto& th : threads)
+        th.join();
+#if PHMAP_HAVE_EXCEPTIONS
+    for (auto& e : errors)
+        if (e)
+            std::rethrow_exception(e);
+#endif
+}
+
+// counts the bytes of a dump, without writing them
+class CountingArchive
+{
+public:
+    bool saveBinary(const void*, size_t sz) {
+        size_ += sz;
+        return true;
+    }
+
+    size_t size() const { return size_; }
+
+private:
+    size_t size_ = 0;
+};
+
+struct FdCloser
+{
+    ~FdCloser() { ::close(fd); }
+    int fd;
+};
+
+static constexpr size_t s_chunk_buffer_size = size_t(1) << 20;   // per thread
+
+template <size_t N,
+          template <class, class, class, class> class RefSet,
+          class Mtx_,
+          class Policy, class Hash, class Eq, class Alloc>
+bool parallel_hash_set<N, RefSet, Mtx_, Policy, Hash, Eq, Alloc>::phmap_dump_chunked(
+    const char* file_path, size_t num_threads) const {
+    static_assert(type_traits_internal::IsDumpable<typename PolicyTraits::init_type>::value,
+                  "value_type should be trivially copyable, or made of strings, vectors and pairs");
+
+    std::deque<typename Lockable::UniqueLock> locks;
+    for (auto& inner : sets_)
+        locks.emplace_back(const_cast<Inner&>(inner));
+
+    // header: version, submap count, and the offsets of the records and of the end
+    const size_t submap_count = subcnt();
+    std::vector<size_t> offsets(submap_count + 1);
+    ParallelFor(submap_count, num_threads, [&](size_t i) {
+        CountingArchive ar;
+        sets_[i].set_.phmap_dump(ar);
+        offsets[i + 1] = ar.size();
+    });
+    offsets[0] = (submap_count + 3) * sizeof(size_t);
+    for (size_t i = 0; i < submap_count; ++i)
+        offsets[i + 1] += offsets[i];
+
+    bool direct;
+    FdCloser fd { FdOpen(file_path, O_WRONLY | O_CREAT | O_TRUNC, false, direct) };
+    {
+        FdOutputArchive ar(fd.fd, 0, offsets[0]);
+        ar.saveBinary(&s_version_chunked, sizeof(size_t));
+        ar.saveBinary(&submap_count, sizeof(size_t));
+        ar.saveBinary(offsets.data(), sizeof(size_t) * offsets.size());
+        if (!ar.close()) {
+            std::cerr << "Failed to write " << file_path << std::endl;
+            return false;
+        }
+    }
+
+    std::vector<char> done(submap_count, 0);
+    ParallelFor(submap_count, num_threads, [&](size_t i) {
+        FdOutputArchive ar(fd.fd, offsets[i], s_chunk_buffer_size);
+        done[i] = sets_[i].set_.phmap_dump(ar) && ar.close() && ar.offset() == offsets[i + 1];
+    });
+    for (size_t i = 0; i < submap_count; ++i) {
+        if (!done[i]) {
+            std::cerr << "Failed to dump submap " << i << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+template <size_t N,
+          template <class, class, class, class> class RefSet,
+          class Mtx_,
+          class Policy, class Hash, class Eq, class Alloc>
+bool parallel_hash_set<N, RefSet, Mtx_, Policy, Hash, Eq, Alloc>::phmap_load_chunked(
+    const char* file_path, size_t num_threads) {
+    static_assert(type_traits_internal::IsDumpable<typename PolicyTraits::init_type>::value,
+                  "value_type should be trivially copyable, or made of strings, vectors and pairs");
+
+    bool direct;
+    FdCloser fd { FdOpen(file_path, O_RDONLY, false, direct) };
+    struct stat st;
+    size_t version = 0, submap_count = 0;
+    std::vector<size_t> offsets;
+    {
+        FdInputArchive ar(fd.fd, 0, 4096);
+        if (::fstat(fd.fd, &st) != 0 ||
+            !ar.loadBinary(&version) || version != s_version_chunked ||
+            !ar.loadBinary(&submap_count) || submap_count == 0 ||
+            submap_count > static_cast<size_t>(st.st_size) / sizeof(size_t)) {
+            std::cerr << file_path << " is not a chunked dump" << std::endl;
+            return false;
+        }
+        offsets.resize(submap_count + 1);
+        if (!ar.loadBinary(offsets.data(), sizeof(size_t) * offsets.size()) ||
+            offsets[0] != ar.offset() || offsets[submap_count] != static_cast<size_t>(st.st_size) ||
+            !std::is_sorted(offsets.begin(), offsets.end())) {
+            std::cerr << "Invalid chunked dump header in " << file_path << std::endl;
+            return false;
+        }
+    }
+
+    std::deque<typename Lockable::UniqueLock> locks;
+    for (auto& inner : sets_) {
+        locks.emplace_back(inner);
+        set_modified(inner);
+    }
+
+    std::vector<char> done(submap_count, 0);
+    bool ok = true;
+    if (submap_count == subcnt()) {
+        ParallelFor(submap_count, num_threads, [&](size_t i) {
+            FdInputArchive ar(fd.fd, offsets[i], s_chunk_buffer_size);
+            done[i] = sets_[i].set_.phmap_load(ar) && ar.offset() == offsets[i + 1];
+        });
+    } else {
+        // load the records in temporary tables, and find where their elements go:
+        // parts[i * subcnt() + j] holds the (slot, hash) of the elements of
+        // record i which belong to submap j
+        std::vector<EmbeddedSet> tmp;
+        tmp.reserve(submap_count);
+        for (size_t i = 0; i < submap_count; ++i)
+            tmp.emplace_back(0, hash_ref(), eq_ref(), alloc_ref());
+        std::vector<std::vector<std::pair<size_t, size_t>>> parts(submap_count * subcnt());
+
+        ParallelFor(submap_count, num_threads, [&](size_t i) {
+            FdInputArchive ar(fd.fd, offsets[i], s_chunk_buffer_size);
+            EmbeddedSet& set = tmp[i];
+            if (!set.phmap_load(ar) || ar.offset() != offsets[i + 1])
+                return;
+            for (size_t k = 0; k != set.capacity_; ++k) {
+                if (IsFull(set.ctrl_[k])) {
+                    size_t hashval = PolicyTraits::apply_key(HashElement{hash_ref()}, set.slots_ + k);
+                    parts[i * subcnt() + subidx(hashval)].emplace_back(k, hashval);
+                }
+            }
+            done[i] = 1;
+        });
+
+        if (std::find(done.begin(), done.end(), 0) == done.end()) {
+            // size the submaps first, so that moving the elements cannot fail
+            ParallelFor(subcnt(), num_threads, [&](size_t j) {
+                size_t n = 0;
+                for (size_t i = 0; i < submap_count; ++i)
+                    n += parts[i * subcnt() + j].size();
+                EmbeddedSet& set = sets_[j].set_;
+                set.clear();
+                set.reserve(n);
+            });
+            ParallelFor(subcnt(), num_threads, [&](size_t j) {
+                EmbeddedSet& set = sets_[j].set_;
+                for (size_t i = 0; i < submap_count; ++i) {
+                    for (const auto& e : parts[i * subcnt() + j]) {
+                        size_t offset = set.prepare_insert(e.second);
+                        set.set_ctrl(offset, H2(e.second));
+                        PolicyTraits::transfer(&set.alloc_ref(), set.slots_ + offset,
+                                               tmp[i].slots_ + e.first);
+                    }
+                }
+            });
+            // the temporary tables now only release their memory
+            for (auto& set : tmp) {
+                if (set.capacity_) {
+                    set.reset_ctrl(set.capacity_);
+                    set.size_ = 0;
+                    set.reset_growth_left(set.capacity_);
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < submap_count; ++i) {
+        if (!done[i]) {
+            std::cerr << "Failed to load submap " << i << std::endl;
+            ok = false;
+            break;
+        }
+    }
+    if (!ok) {
+        for (auto& inner : sets_)
+            inner.set_.clear();
+    }
+    return ok;
+}
+
+} // namespace priv
+
+// ------------------------------------------------------------------------
+// Read-only views of dumped flat tables, used in place in the mapped file
+// ------------------------------------------------------------------------
+//    phmap::mapped_flat_hash_map<uint64_t, uint32_t> m("./dump.data");
+//    auto it = m.find(42);
+//
+// The file written by phmap_dump() (of a flat_hash_map for example) is mapped
+// read-only, and the lookups probe its control bytes and slots directly: the
+// load is O(1), the pages are read on demand, and the processes mapping the
+// same file share a single copy in the page cache.
+//
+// The view must use the same hash and equality functions as the dumped table,
+// and (for the parallel views) the same number of submaps. A slot array which
+// is not suitably aligned in the file is copied; this only happens for tables
+// of capacity < 7, or for slots aligned on more than 8 bytes.
+// ------------------------------------------------------------------------
+namespace priv {
+
+class MappedFile
+{
+public:
+    explicit MappedFile(const char* path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            phmap::base_internal::ThrowStdRuntimeError(std::string("phmap: cannot open ") + path);
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            size_ = static_cast<size_t>(st.st_size);
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+            data_ = p == MAP_FAILED ? nullptr : static_cast<const char*>(p);
+        }
+        ::close(fd);
+        if (!data_)
+            phmap::base_internal::ThrowStdRuntimeError(std::string("phmap: cannot map ") + path);
+    }
+
+    ~MappedFile() { ::munmap(const_cast<char*>(data_), size_); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t      size() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t      size_ = 0;
+};
+
+// ------------------------------------------------------------------------
+// control bytes and slots of one dumped raw_hash_set
+// ------------------------------------------------------------------------
+template <class Policy>
+struct MappedTable
+{
+    using PolicyTraits = hash_policy_traits<Policy>;
+    using slot_type    = typename Policy::slot_type;
+
+    static_assert(alignof(slot_type) <= alignof(std::max_align_t), "unsupported slot alignment");
+
+    // Parses the raw_hash_set::phmap_dump() record at `p`, and advances `p`
+    // past it. Returns false if the record is invalid or truncated.
+    bool parse(const char*& p, const char* end) {
+        size_t version = 0;
+        if (!read(p, end, &version))
+            return false;
+        if (version < s_version_base)
+            size = version;         // old format without version
+        else if (version != s_version || !read(p, end, &size))
+            return false;
+        if (!read(p, end, &capacity))
+            return false;
+        if (size == 0) {            // nothing else was dumped
+            capacity = 0;
+            return true;
+        }
+        if (!IsValidCapacity(capacity) || size > capacity ||
+            capacity > (std::numeric_limits<size_t>::max)() / sizeof(slot_type))
+            return false;
+
+        size_t ctrl_bytes = sizeof(ctrl_t) * (capacity + Group::kWidth + 1);
+        size_t slot_bytes = sizeof(slot_type) * capacity;
+        size_t tail_bytes = version >= s_version_base ? sizeof(size_t) : 0;   // growth_left
+        if (static_cast<size_t>(end - p) < ctrl_bytes ||
+            static_cast<size_t>(end - p) - ctrl_bytes < slot_bytes + tail_bytes)
+            return false;
+
+        ctrl = reinterpret_cast<const ctrl_t*>(p);
+        if (ctrl[capacity] != kSentinel)
+            return false;
+        p += ctrl_bytes;
+        if (reinterpret_cast<uintptr_t>(p) % alignof(slot_type) != 0) {
+            copy.reset(new char[slot_bytes]);
+            std::memcpy(copy.get(), p, slot_bytes);
+            slots = reinterpret_cast<const slot_type*>(copy.get());
+        } else {
+            slots = reinterpret_cast<const slot_type*>(p);
+        }
+        p += slot_bytes + tail_bytes;
+        return true;
+    }
+
+    template <class EqualElement>
+    const slot_type* find(size_t hashval, const EqualElement& eq) const {
+        if (!capacity)
+            return nullptr;
+        probe_seq<Group::kWidth> seq(H1(hashval, ctrl), capacity);
+        while (true) {
+            Group g{ ctrl + seq.offset() };
+            for (uint32_t i : g.Match((h2_t)H2(hashval))) {
+                const slot_type* slot = slots + seq.offset((size_t)i);
+                if (PHMAP_PREDICT_TRUE(PolicyTraits::apply_key(eq, const_cast<slot_type*>(slot))))
+                    return slot;
+            }
+            if (PHMAP_PREDICT_TRUE(g.MatchEmpty()))
+                return nullptr;
+            seq.next();
+        }
+    }
+
+    static bool read(const char*& p, const char* end, size_t* v) {
+        if (static_cast<size_t>(end - p) < sizeof(size_t))
+            return false;
+        std::memcpy(v, p, sizeof(size_t));
+        p += sizeof(size_t);
+        return true;
+    }
+
+    const ctrl_t*           ctrl = nullptr;
+    const slot_type*        slots = nullptr;
+    size_t                  size = 0;
+    size_t                  capacity = 0;
+    std::unique_ptr<char[]> copy;           // slots, when not aligned in the file
+};
+
+// ------------------------------------------------------------------------
+// Read-only view of the dump of a flat raw_hash_set (`Parallel` false), or
+// of a parallel_hash_set with 2**N submaps.
+// ------------------------------------------------------------------------
+template <class Policy, class Hash, class Eq, size_t N, bool Parallel>
+class raw_mapped_hash_set
+{
+    using PolicyTraits = hash_policy_traits<Policy>;
+    using Table        = MappedTable<Policy>;
+    using slot_type    = typename Policy::slot_type;
+    using KeyArgImpl   = KeyArg<IsTransparent<Eq>::value && IsTransparent<Hash>::value>;
+
+    static constexpr size_t num_tables = Parallel ? (size_t(1) << N) : 1;
+    static constexpr size_t mask = num_tables - 1;
+
+public:
+    using key_type        = typename PolicyTraits::key_type;
+    using value_type      = typename PolicyTraits::value_type;
+    using size_type       = size_t;
+    using difference_type = ptrdiff_t;
+    using hasher          = Hash;
+    using key_equal       = Eq;
+    using reference       = const value_type&;
+    using const_reference = const value_type&;
+    using pointer         = const value_type*;
+    using const_pointer   = const value_type*;
+
+    template <class K>
+    using key_arg = typename KeyArgImpl::template type<K, key_type>;
+
+    static_assert(type_traits_internal::IsTriviallyCopyable<value_type>::value,
+                  "value_type should be trivially copyable");
+
+    class const_iterator
+    {
+        friend class raw_mapped_hash_set;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = typename raw_mapped_hash_set::value_type;
+        using reference         = const value_type&;
+        using pointer           = const value_type*;
+        using difference_type   = typename raw_mapped_hash_set::difference_type;
+
+        const_iterator() {}
+
+        reference operator*() const {
+            return PolicyTraits::element(const_cast<slot_type*>(&tables_[t_].slots[i_]));
+        }
+        pointer operator->() const { return &operator*(); }
+
+        const_iterator& operator++() {
+            ++i_;
+            skip_empty_slots();
+            return *this;
+        }
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const const_iterator& a, const const_iterator& b) {
+            return a.t_ == b.t_ && a.i_ == b.i_;
+        }
+        friend bool operator!=(const const_iterator& a, const const_iterator& b) {
+            return !(a == b);
+        }
+
+    private:
+        const_iterator(const Table* tables, size_t t, size_t i) : tables_(tables), t_(t), i_(i) {}
+
+        void skip_empty_slots() {
+            for (; t_ < num_tables; ++t_, i_ = 0) {
+                const Table& table = tables_[t_];
+                for (; i_ < table.capacity; ++i_)
+                    if (IsFull(table.ctrl[i_]))
+                        return;
+            }
+            i_ = 0;
+        }
+
+        const Table* tables_ = nullptr;
+        size_t       t_ = num_tables;
+        size_t       i_ = 0;
+    };
+
+    using iterator = const_iterator;
+
+    // Maps the file at `path`, written by phmap_dump(). Throws
+    // std::runtime_error if the file cannot be mapped or is not a valid dump.
+    explicit raw_mapped_hash_set(const char* path, const hasher& hash = hasher(),
+                                 const key_equal& eq = key_equal()) :
+        file_(path), hash_(hash), eq_(eq) {
+        const char* p = file_.data();
+        const char* end = p + file_.size();
+        size_t submap_count = 1;
+        if (Parallel && (!Table::read(p, end, &submap_count) || submap_count != num_tables))
+            phmap::base_internal::ThrowStdRuntimeError(
+                std::string("phmap: submap count mismatch in ") + path);
+        for (auto& table : tables_) {
+            if (!table.parse(p, end))
+                phmap::base_internal::ThrowStdRuntimeError(std::string("phmap: invalid dump ") + path);
+            size_ += table.size;
+        }
+    }
+
+    raw_mapped_hash_set(const raw_mapped_hash_set&) = delete;
+    raw_mapped_hash_set& operator=(const raw_mapped_hash_set&) = delete;
+
+    const_iterator begin() const {
+        const_iterator it(tables_.data(), 0, 0);
+        it.skip_empty_slots();
+        return it;
+    }
+    const_iterator end() const { return const_iterator(tables_.data(), num_tables, 0); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    bool   empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+
+    size_t capacity() const {
+        size_t res = 0;
+        for (const auto& table : tables_)
+            res += table.capacity;
+        return res;
+    }
+
+    // true if no slot array had to be copied out of the file
+    bool in_place() const {
+        for (const auto& table : tables_)
+            if (table.copy)
+                return false;
+        return true;
+    }
+
+    hasher    hash_function() const { return hash_; }
+    key_equal key_eq() const { return eq_; }
+
+    template <class K = key_type>
+    size_t hash(const key_arg<K>& key) const {
+#if PHMAP_DISABLE_MIX
+        return hash_(key);
+#else
+        return phmap_mix<sizeof(size_t)>()(hash_(key));
+#endif
+    }
+
+    template <class K = key_type>
+    const_iterator find(const key_arg<K>& key) const {
+        size_t hashval = hash(key);
+        size_t t = Parallel ? (((hashval >> 8) ^ (hashval >> 16) ^ (hashval >> 24)) & mask) : 0;
+        const Table& table = tables_[t];
+        const slot_type* slot = table.find(hashval, EqualElement<K>{key, eq_});
+        return slot ? const_iterator(tables_.data(), t, static_cast<size_t>(slot - table.slots)) : end();
+    }
+
+    template <class K = key_type>
+    bool contains(const key_arg<K>& key) const { return find(key) != end(); }
+
+    template <class K = key_type>
+    size_t count(const key_arg<K>& key) const { return contains(key) ? 1 : 0; }
+
+private:
+    template <class K1>
+    struct EqualElement
+    {
+        template <class K2, class... Args>
+        bool operator()(const K2& lhs, Args&&...) const {
+            return eq(lhs, rhs);
+        }
+        const K1& rhs;
+        const key_equal& eq;
+    };
+
+    MappedFile                     file_;
+    std::array<Table, num_tables>  tables_;
+    size_t                         size_ = 0;
+    hasher                         hash_;
+    key_equal                      eq_;
+};
+
+template <class Policy, class Hash, class Eq, size_t N, bool Parallel>
+class raw_mapped_hash_map : public raw_mapped_hash_set<Policy, Hash, Eq, N, Parallel>
+{
+    using Base = raw_mapped_hash_set<Policy, Hash, Eq, N, Parallel>;
+
+public:
+    using mapped_type = typename Policy::mapped_type;
+
+    template <class K>
+    using key_arg = typename Base::template key_arg<K>;
+
+    using Base::Base;
+
+    template <class K = typename Base::key_type>
+    const mapped_type& at(const key_arg<K>& key) const {
+        auto it = this->find(key);
+        if (it == this->end())
+            phmap::base_internal::ThrowStdOutOfRange("phmap at(): lookup non-existent key");
+        return it->second;
+    }
+};
+
+} // namespace priv
+
+// ------------------------------------------------------------------------
+// views of the dumps of flat_hash_set, flat_hash_map, parallel_flat_hash_set
+// and parallel_flat_hash_map
+// ------------------------------------------------------------------------
+template <class T, class Hash, class Eq> // default values in phmap_fwd_decl.h
+class mapped_flat_hash_set
+    : public priv::raw_mapped_hash_set<priv::FlatHashSetPolicy<T>, Hash, Eq, 0, false>
+{
+    using Base = typename mapped_flat_hash_set::raw_mapped_hash_set;
+
+public:
+    using Base::Base;
+};
+
+template <class K, class V, class Hash, class Eq> // default values in phmap_fwd_decl.h
+class mapped_flat_hash_map
+    : public priv::raw_mapped_hash_map<priv::FlatHashMapPolicy<K, V>, Hash, Eq, 0, false>
+{
+    using Base = typename mapped_flat_hash_map::raw_mapped_hash_map;
+
+public:
+    using Base::Base;
+};
+
+template <class T, class Hash, class Eq, size_t N> // default values in phmap_fwd_decl.h
+class mapped_parallel_flat_hash_set
+    : public priv::raw_mapped_hash_set<priv::FlatHashSetPolicy<T>, Hash, Eq, N, true>
+{
+    using Base = typename mapped_parallel_flat_hash_set::raw_mapped_hash_set;
+
+public:
+    using Base::Base;
+};
+
+template <class K, class V, class Hash, class Eq, size_t N> // default values in phmap_fwd_decl.h
+class mapped_parallel_flat_hash_map
+    : public priv::raw_mapped_hash_map<priv::FlatHashMapPolicy<K, V>, Hash, Eq, N, true>
+{
+    using Base = typename mapped_parallel_flat_hash_map::raw_mapped_hash_map;
+
+public:
+    using Base::Base;
+};
+
+#endif // PHMAP_HAVE_MMAP && !defined(PHMAP_NON_DETERMINISTIC) && !defined(PHMAP_DISABLE_DUMP)
+
 } // namespace phmap
 
 
@@ -94,6 +94,13 @@ namespace phmap {
                             phmap::priv::Pair<const Key, Value>>> // alias for std::allocator
         class node_hash_map;
 
+    template <class Key, class Value,
+              class Hash  = phmap::priv::hash_default_hash<Key>,
+              class Eq    = phmap::priv::hash_default_eq<Key>,
+              class Alloc = phmap::priv::Allocator<
+                            phmap::priv::Pair<const Key, Value>>> // alias for std::allocator
+        class adaptive_hash_map;
+
     template <class T,
               class Hash  = phmap::priv::hash_default_hash<T>,
               class Eq    = phmap::priv::hash_default_eq<T>,
@@ -128,6 +135,154 @@ namespace phmap {
               class Mutex = phmap::NullMutex>   // use std::mutex to enable internal locks
         class parallel_node_hash_map;
 
+    // ------------- compact node containers (phmap_compact.h) --------------------------------
+    template <class T,
+              class Hash  = phmap::priv::hash_default_hash<T>,
+              class Eq    = phmap::priv::hash_default_eq<T>,
+              class Alloc = phmap::priv::Allocator<T>> // alias for std::allocator
+        class compact_node_hash_set;
+
+    template <class Key, class Value,
+              class Hash  = phmap::priv::hash_default_hash<Key>,
+              class Eq    = phmap::priv::hash_default_eq<Key>,
+              class Alloc = phmap::priv::Allocator<
+                            phmap::priv::Pair<const Key, Value>>> // alias for std::allocator
+        class compact_node_hash_map;
+
+    template <class T,
+              class Hash  = phmap::priv::hash_default_hash<T>,
+              class Eq    = phmap::priv::hash_default_eq<T>,
+              class Alloc = phmap::priv::Allocator<T>, // alias for std::allocator
+              size_t N    = 4,                  // 2**N submaps
+              class Mutex = phmap::NullMutex>   // use std::mutex to enable internal locks
+        class parallel_compact_node_hash_set;
+
+    template <class Key, class Value,
+              class Hash  = phmap::priv::hash_default_hash<Key>,
+              class Eq    = phmap::priv::hash_default_eq<Key>,
+              class Alloc = phmap::priv::Allocator<
+                            phmap::priv::Pair<const Key, Value>>, // alias for std::allocator
+              size_t N    = 4,                  // 2**N submaps
+              class Mutex = phmap::NullMutex>   // use std::mutex to enable internal locks
+        class parallel_compact_node_hash_map;
+
+    // ------------- multi-valued containers (phmap_multimap.h) -------------------------------
+    template <class Key, class Value,
+              class Hash  = phmap::priv::hash_default_hash<Key>,
+              class Eq    = phmap::priv::hash_default_eq<Key>,
+              class Alloc = phmap::priv::Allocator<
+                            phmap::priv::Pair<const Key, Value>>> // alias for std::allocator
+        class flat_hash_multimap;
+
+    template <class T,
+              class Hash  = phmap::priv::hash_default_hash<T>,
+              class Eq    = phmap::priv::hash_default_eq<T>,
+              class Alloc = phmap::priv::Allocator<T>> // alias for std::allocator
+        class flat_hash_multiset;
+
+    template <class Key, class Value,
+              class Hash  = phmap::priv::hash_default_hash<Key>,
+              class Eq    = phmap::priv::hash_default_eq<Key>,
+              class Alloc = phmap::priv::Allocator<
+                            phmap::priv::Pair<const Key, Value>>, // alias for std::allocator
+              size_t N    = 4,                  // 2**N submaps
+              class Mutex = phmap::NullMutex>   // use std::mutex to enable internal locks
+        class parallel_flat_hash_multimap;
+
+    // ------------- insertion-ordered map (phmap_ordered.h) ----------------------------------
+    template <class Key, class Value,
+              class Hash  = phmap::priv::hash_default_hash<Key>,
+              class Eq    = phmap::priv::hash_default_eq<Key>,
+              class Alloc = phmap::priv::Allocator<
+                            phmap::priv::Pair<const Key, Value>>> // alias for std::allocator
+        class ordered_flat_hash_map;
+
+    // ------------- sparse containers (phmap_sparse.h) ---------------------------------------
+    template <class T,
+              class Hash  = phmap::priv::hash_default_hash<T>,
+              class Eq    = phmap::priv::hash_default_eq<T>,
+              class Alloc = phmap::priv::Allocator<T>> // alias for std::allocator
+        class sparse_hash_set;
+
+    template <class Key, class Value,
+              class Hash  = phmap::priv::hash_default_hash<Key>,
+              class Eq    = phmap::priv::hash_default_eq<Key>,
+              class Alloc = phmap::priv::Allocator<
+                            phmap::priv::Pair<const Key, Value>>> // alias for std::allocator
+        class sparse_hash_map;
+
+    template <class T,
+              class Hash  = phmap::priv::hash_default_hash<T>,
+              class Eq    = phmap::priv::hash_default_eq<T>,
+              class Alloc = phmap::priv::Allocator<T>, // alias for std::allocator
+              size_t N    = 4,                  // 2**N submaps
+              class Mutex = phmap::NullMutex>   // use std::mutex to enable internal locks
+        class parallel_sparse_hash_set;
+
+    template <class Key, class Value,
+              class Hash  = phmap::priv::hash_default_hash<Key>,
+              class Eq    = phmap::priv::hash_default_eq<Key>,
+              class Alloc = phmap::priv::Allocator<
+                            phmap::priv::Pair<const Key, Value>>, // alias for std::allocator
+              size_t N    = 4,                  // 2**N submaps
+              class Mutex = phmap::NullMutex>   // use std::mutex to enable internal locks
+        class parallel_sparse_hash_map;
+
+    // ------------- dense integer-key containers (phmap_dense.h) -----------------------------
+    template <class T,
+              class Alloc = phmap::priv::Allocator<T>> // alias for std::allocator
+        class dense_int_set;
+
+    template <class Key, class Value,
+              class Alloc = phmap::priv::Allocator<
+                            phmap::priv::Pair<const Key, Value>>> // alias for std::allocator
+        class dense_int_map;
+
+    // ------------- compile-time map (phmap_static.h) ----------------------------------------
+    template <class T> struct StaticHash;
+    template <class T> struct StaticEqualTo;
+
+    template <class Key, class Value, size_t N,
+              class Hash  = phmap::StaticHash<Key>,
+              class Eq    = phmap::StaticEqualTo<Key>>
+        class static_flat_map;
+
+    // ------------- string interning (phmap_string_pool.h) -----------------------------------
+    template <size_t N    = 4,                  // 2**N submaps
+              class Mutex = std::mutex>         // phmap::NullMutex for single threaded use
+        class string_pool;
+
+    // ------------- read-only views of dumped flat tables (phmap_dump.h) ---------------------
+    template <class T,
+              class Hash  = phmap::priv::hash_default_hash<T>,
+              class Eq    = phmap::priv::hash_default_eq<T>>
+        class mapped_flat_hash_set;
+
+    template <class K, class V,
+              class Hash  = phmap::priv::hash_default_hash<K>,
+              class Eq    = phmap::priv::hash_default_eq<K>>
+        class mapped_flat_hash_map;
+
+    template <class T,
+              class Hash  = phmap::priv::hash_default_hash<T>,
+              class Eq    = phmap::priv::hash_default_eq<T>,
+              size_t N    = 4>                  // 2**N submaps, as in the dumped table
+        class mapped_parallel_flat_hash_set;
+
+    template <class K, class V,
+              class Hash  = phmap::priv::hash_default_hash<K>,
+              class Eq    = phmap::priv::hash_default_eq<K>,
+              size_t N    = 4>                  // 2**N submaps, as in the dumped table
+        class mapped_parallel_flat_hash_map;
+
+    // ------------- memory-mapped file allocator (phmap_mmap.h) -----------------------------
+    template <class T> class offset_ptr;
+    template <class T> class mmap_file_allocator;
+    class mmap_file;
+
+    // ------------- write-ahead log (phmap_wal.h) ----------------------------------------
+    template <class Map> class mutation_log;
+
     // -----------------------------------------------------------------------------
     // phmap::parallel_*_hash_* using std::mutex by default
     // -----------------------------------------------------------------------------
@@ -0,0 +1,603 @@
+#if !defined(phmap_mmap_h_guard_)
+#define phmap_mmap_h_guard_
+
+// ---------------------------------------------------------------------------
+// Copyright (c) 2019, Gregory Popovitch - greg7mdp@gmail.com
+//
+//       hash maps persisted in memory-mapped files
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+// phmap::mmap_file maps a file in memory, and allocates memory from it with
+// phmap::mmap_file_allocator<T>. A container using this allocator lives
+// entirely in the file, and is available again with no load time when the
+// file is reopened, for example after a restart:
+//
+//    using Alloc = phmap::mmap_file_allocator<std::pair<const uint64_t, uint64_t>>;
+//    using Map   = phmap::flat_hash_map<uint64_t, uint64_t, phmap::Hash<uint64_t>,
+//                                       phmap::EqualTo<uint64_t>, Alloc>;
+//
+//    phmap::mmap_file file("map.dat", size_t(64) << 30);   // created if needed
+//    Map* m = file.find_or_construct<Map>("my_map", file.get_allocator<Map::value_type>());
+//    (*m)[42] = 1;                                           // stored in the file
+//
+// The pointer type of the allocator is phmap::offset_ptr<T>, which stores the
+// distance from itself to its target, so that the allocator itself and the
+// containers using `allocator_traits<A>::pointer` (std::vector for example)
+// are position independent. The hash tables however keep plain pointers to
+// their arrays, so the file is always mapped at the address where it was
+// created; if this address is not available anymore, the constructor throws
+// std::runtime_error.
+//
+// The size of the file is fixed when it is mapped (it is a sparse file, disk
+// space is only used for the pages written): allocations beyond it throw
+// std::bad_alloc. A larger size can be passed when reopening the file.
+//
+// Small blocks are recycled by power of 2 size classes, large blocks (over
+// 64 KiB) are page aligned and recycled first-fit, without coalescing: calling
+// reserve() with the final size avoids keeping the blocks of the smaller
+// tables of a growing container.
+//
+// Only one mmap_file may be open on a given file at a time. The allocator is
+// thread safe, so parallel_flat_hash_map with a mutex can be used from many
+// threads. Elements must not contain pointers to memory outside the file
+// (such as a std::string with the default allocator).
+// ---------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <string>
+#include <thread>
+
+#include "phmap.h"
+
+#if PHMAP_HAVE_MMAP
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace phmap {
+
+// -----------------------------------------------------------------------------
+// Pointer storing the offset of its target from its own address, so that it
+// stays valid when the memory containing both is mapped at another address.
+// As in boost::interprocess, an offset of 1 is used for nullptr.
+// -----------------------------------------------------------------------------
+template <class T>
+class offset_ptr
+{
+    template <class U> friend class offset_ptr;
+
+    using ref_t = typename std::add_lvalue_reference<T>::type;
+
+public:
+    using element_type      = T;
+    using pointer           = offset_ptr;
+    using value_type        = typename std::remove_cv<T>::type;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = ref_t;
+    using iterator_category = std::random_access_iterator_tag;
+
+    template <class U>
+    using rebind = offset_ptr<U>;
+
+    offset_ptr() noexcept : off_(kNull) {}
+    offset_ptr(std::nullptr_t) noexcept : off_(kNull) {}
+    offset_ptr(T* p) noexcept { set(p); }
+    offset_ptr(const offset_ptr& o) noexcept { set(o.get()); }
+
+    template <class U,
+              typename std::enable_if<std::is_convertible<U*, T*>::value, int>::type = 0>
+    offset_ptr(const offset_ptr<U>& o) noexcept { set(o.get()); }
+
+    // static_cast from offset_ptr<void>
+    template <class U,
+              typename std::enable_if<!std::is_convertible<U*, T*>::value &&
+                                      std::is_void<U>::value, int>::type = 0>
+    explicit offset_ptr(const offset_ptr<U>& o) noexcept { set(static_cast<T*>(o.get())); }
+
+    offset_ptr& operator=(const offset_ptr& o) noexcept { set(o.get()); return *this; }
+    offset_ptr& operator=(T* p) noexcept { set(p); return *this; }
+
+    T* get() const noexcept {
+        return off_ == kNull ? nullptr
+                             : reinterpret_cast<T*>(self() + static_cast<uintptr_t>(off_));
+    }
+
+    ref_t operator*() const noexcept { return *get(); }
+    T* operator->() const noexcept { return get(); }
+    ref_t operator[](difference_type i) const noexcept { return get()[i]; }
+
+    explicit operator bool() const noexcept { return off_ != kNull; }
+
+    template <class U = T>
+    static offset_ptr pointer_to(typename std::add_lvalue_reference<U>::type r) noexcept {
+        return offset_ptr(std::addressof(r));
+    }
+
+    offset_ptr& operator+=(difference_type n) noexcept { set(get() + n); return *this; }
+    offset_ptr& operator-=(difference_type n) noexcept { set(get() - n); return *this; }
+    offset_ptr& operator++() noexcept { return *this += 1; }
+    offset_ptr& operator--() noexcept { return *this -= 1; }
+    offset_ptr operator++(int) noexcept { offset_ptr tmp(*this); ++*this; return tmp; }
+    offset_ptr operator--(int) noexcept { offset_ptr tmp(*this); --*this; return tmp; }
+
+    friend offset_ptr operator+(offset_ptr p, difference_type n) noexcept { return p += n; }
+    friend offset_ptr operator+(difference_type n, offset_ptr p) noexcept { return p += n; }
+    friend offset_ptr operator-(offset_ptr p, difference_type n) noexcept { return p -= n; }
+    friend difference_type operator-(const offset_ptr& a, const offset_ptr& b) noexcept {
+        return a.get() - b.get();
+    }
+
+    friend bool operator==(const offset_ptr& a, const offset_ptr& b) noexcept { return a.get() == b.get(); }
+    friend bool operator!=(const offset_ptr& a, const offset_ptr& b) noexcept { return a.get() != b.get(); }
+    friend bool operator<(const offset_ptr& a, const offset_ptr& b) noexcept  { return a.get() < b.get(); }
+    friend bool operator>(const offset_ptr& a, const offset_ptr& b) noexcept  { return a.get() > b.get(); }
+    friend bool operator<=(const offset_ptr& a, const offset_ptr& b) noexcept { return a.get() <= b.get(); }
+    friend bool operator>=(const offset_ptr& a, const offset_ptr& b) noexcept { return a.get() >= b.get(); }
+
+private:
+    static constexpr std::ptrdiff_t kNull = 1;
+
+    // The arithmetic is done on integers: computed from `this`, a pointer
+    // would be assumed by the compiler to point inside the offset_ptr.
+    uintptr_t self() const noexcept { return reinterpret_cast<uintptr_t>(this); }
+
+    void set(const volatile void* p) noexcept {
+        off_ = p ? static_cast<std::ptrdiff_t>(reinterpret_cast<uintptr_t>(p) - self()) : kNull;
+    }
+
+    std::ptrdiff_t off_;
+};
+
+namespace priv {
+
+// --------------------------------------------------------------------------
+// Header of a phmap::mmap_file, at offset 0 of the file. All the offsets are
+// relative to the start of the file; an offset of 0 means none.
+// --------------------------------------------------------------------------
+class MmapSegment
+{
+public:
+    static constexpr uint64_t kMagic      = 0x70686d61706d6d31ULL;   // "phmapmm1"
+    static constexpr uint32_t kVersion    = 1;
+    static constexpr size_t   kMinClass   = 4;                       // 16 bytes
+    static constexpr size_t   kMaxClass   = 16;                      // 64 KiB
+    static constexpr size_t   kPageSize   = 4096;
+    static constexpr size_t   kMaxRoots   = 32;
+    static constexpr size_t   kMaxNameLen = 47;
+
+    struct Root
+    {
+        char     name[kMaxNameLen + 1];
+        uint64_t offset;
+        uint64_t size;       // sizeof the object, checked by find()
+    };
+
+    // Sets up a new segment of `size` bytes mapped at `this`.
+    void init(size_t size) {
+        magic_       = kMagic;
+        version_     = kVersion;
+        header_size_ = static_cast<uint32_t>(sizeof(MmapSegment));
+        base_        = reinterpret_cast<uintptr_t>(this);
+        size_        = size;
+        top_         = align_up(sizeof(MmapSegment), 64);
+        used_        = 0;
+        free_large_  = 0;
+        for (auto& f : free_small_)
+            f = 0;
+        for (auto& r : roots_)
+            r = Root{};
+        new (&lock_) std::atomic<uint32_t>(0);
+    }
+
+    bool valid() const {
+        return magic_ == kMagic && version_ == kVersion && header_size_ == sizeof(MmapSegment);
+    }
+
+    uintptr_t base() const { return static_cast<uintptr_t>(base_); }
+    size_t    size() const { return static_cast<size_t>(size_); }
+    size_t    used_bytes() const { return static_cast<size_t>(used_); }
+
+    // called when the file is opened: the lock may have been held by a
+    // process which did not terminate cleanly
+    void reopen(size_t size) {
+        size_ = size;
+        lock_.store(0, std::memory_order_relaxed);
+    }
+
+    void* allocate(size_t n, size_t align) {
+        assert(align <= 64 && "mmap_file_allocator: unsupported alignment");
+        (void)align;
+        if (n == 0)
+            n = 1;
+        if (n > size_)
+            phmap::base_internal::ThrowStdBadAlloc();
+        lock_guard guard(lock_);
+        uint64_t off = n <= (size_t(1) << kMaxClass) ? allocate_small(size_class(n))
+                                                     : allocate_large(align_up(n, kPageSize));
+        if (!off)
+            phmap::base_internal::ThrowStdBadAlloc();
+        return at(off);
+    }
+
+    void deallocate(void* p, size_t n) noexcept {
+        if (!p)
+            return;
+        if (n == 0)
+            n = 1;
+        uint64_t off = static_cast<uint64_t>(static_cast<char*>(p) - reinterpret_cast<char*>(this));
+        lock_guard guard(lock_);
+        if (n <= (size_t(1) << kMaxClass)) {
+            size_t c = size_class(n);
+            *static_cast<uint64_t*>(p) = free_small_[c - kMinClass];
+            free_small_[c - kMinClass] = off;
+            used_ -= size_t(1) << c;
+        } else {
+            uint64_t sz = align_up(n, kPageSize);
+            used_ -= sz;
+            if (off + sz == top_) {
+                top_ = off;
+            } else {
+                uint64_t* blk = static_cast<uint64_t*>(p);
+                blk[0] = free_large_;
+                blk[1] = sz;
+                free_large_ = off;
+            }
+        }
+    }
+
+    Root* find_root(const char* name) {
+        for (auto& r : roots_)
+            if (r.offset && std::strncmp(r.name, name, kMaxNameLen + 1) == 0)
+                return &r;
+        return nullptr;
+    }
+
+    Root* new_root(const char* name) {
+        if (std::strlen(name) > kMaxNameLen)
+            phmap::base_internal::ThrowStdInvalidArgument("phmap mmap_file: object name too long");
+        for (auto& r : roots_) {
+            if (!r.offset) {
+                std::strncpy(r.name, name, kMaxNameLen);
+                r.name[kMaxNameLen] = 0;
+                return &r;
+            }
+        }
+        phmap::base_internal::ThrowStdLengthError("phmap mmap_file: too many named objects");
+        return nullptr;
+    }
+
+    void* at(uint64_t off) { return reinterpret_cast<char*>(this) + off; }
+
+private:
+    class lock_guard
+    {
+    public:
+        explicit lock_guard(std::atomic<uint32_t>& l) : l_(l) {
+            while (l_.exchange(1, std::memory_order_acquire))
+                std::this_thread::yield();
+        }
+        ~lock_guard() { l_.store(0, std::memory_order_release); }
+
+    private:
+        std::atomic<uint32_t>& l_;
+    };
+
+    static uint64_t align_up(uint64_t v, uint64_t a) { return (v + a - 1) & ~(a - 1); }
+
+    static size_t size_class(size_t n) {
+        size_t c = kMinClass;
+        while ((size_t(1) << c) < n)
+            ++c;
+        return c;
+    }
+
+    // bump allocation, returns 0 when the file is full
+    uint64_t allocate_top(uint64_t n, uint64_t align) {
+        uint64_t off = align_up(top_, align);
+        if (off + n > size_)
+            return 0;
+        top_ = off + n;
+        return off;
+    }
+
+    // blocks of a size class are aligned on their size (up to 64 bytes)
+    uint64_t allocate_small(size_t c) {
+        uint64_t& head = free_small_[c - kMinClass];
+        uint64_t off = head;
+        if (off)
+            head = *static_cast<uint64_t*>(at(off));
+        else
+            off = allocate_top(uint64_t(1) << c, (std::min)(uint64_t(1) << c, uint64_t(64)));
+        if (off)
+            used_ += uint64_t(1) << c;
+        return off;
+    }
+
+    // smallest free block large enough, split if larger
+    uint64_t allocate_large(uint64_t n) {
+        uint64_t* best_prev = nullptr;
+        uint64_t  best_size = 0;
+        for (uint64_t* prev = &free_large_; *prev; prev = static_cast<uint64_t*>(at(*prev))) {
+            uint64_t sz = static_cast<uint64_t*>(at(*prev))[1];
+            if (sz >= n && (!best_prev || sz < best_size)) {
+                best_prev = prev;
+                best_size = sz;
+            }
+        }
+        uint64_t off = 0;
+        if (best_prev) {
+            off = *best_prev;
+            uint64_t next = static_cast<uint64_t*>(at(off))[0];
+            if (best_size > n) {
+                uint64_t* rest = static_cast<uint64_t*>(at(off + n));
+                rest[0] = next;
+                rest[1] = best_size - n;
+                next = off + n;
+            }
+            *best_prev = next;
+        } else {
+            off = allocate_top(n, kPageSize);
+        }
+        if (off)
+            used_ += n;
+        return off;
+    }
+
+    uint64_t              magic_;
+    uint32_t              version_;
+    uint32_t              header_size_;
+    uint64_t              base_;          // address where the file is mapped
+    uint64_t              size_;          // size of the file
+    uint64_t              top_;           // end of the allocated blocks
+    uint64_t              used_;          // bytes allocated and not freed
+    uint64_t              free_small_[kMaxClass - kMinClass + 1];
+    uint64_t              free_large_;    // blocks of {next, size, ...}
+    std::atomic<uint32_t> lock_;
+    Root                  roots_[kMaxRoots];
+};
+
+}  // namespace priv
+
+// -----------------------------------------------------------------------------
+// Allocator of memory in a phmap::mmap_file
+// -----------------------------------------------------------------------------
+template <class T>
+class mmap_file_allocator
+{
+public:
+    using value_type         = T;
+    using pointer            = offset_ptr<T>;
+    using const_pointer      = offset_ptr<const T>;
+    using void_pointer       = offset_ptr<void>;
+    using const_void_pointer = offset_ptr<const void>;
+    using size_type          = size_t;
+    using difference_type    = std::ptrdiff_t;
+
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+    using is_always_equal                        = std::false_type;
+
+    template <class U>
+    struct rebind { using other = mmap_file_allocator<U>; };
+
+    // a default constructed allocator cannot allocate; it is only assigned
+    mmap_file_allocator() noexcept = default;
+
+    explicit mmap_file_allocator(priv::MmapSegment* seg) noexcept : seg_(seg) {}
+
+    mmap_file_allocator(const mmap_file_allocator& o) noexcept : seg_(o.segment()) {}
+
+    template <class U>
+    mmap_file_allocator(const mmap_file_allocator<U>& o) noexcept : seg_(o.segment()) {}
+
+    mmap_file_allocator& operator=(const mmap_file_allocator& o) noexcept {
+        seg_ = o.segment();
+        return *this;
+    }
+
+    pointer allocate(size_t n) {
+        if (n > (std::numeric_limits<size_t>::max)() / sizeof(T))
+            phmap::base_internal::ThrowStdBadAlloc();
+        assert(seg_ && "mmap_file_allocator: default constructed allocator");
+        return pointer(static_cast<T*>(seg_->allocate(n * sizeof(T), alignof(T))));
+    }
+
+    void deallocate(pointer p, size_t n) noexcept {
+        seg_->deallocate(const_cast<typename std::remove_cv<T>::type*>(p.get()), n * sizeof(T));
+    }
+
+    priv::MmapSegment* segment() const noexcept { return seg_.get(); }
+
+    template <class U>
+    bool operator==(const mmap_file_allocator<U>& o) const noexcept { return segment() == o.segment(); }
+
+    template <class U>
+    bool operator!=(const mmap_file_allocator<U>& o) const noexcept { return segment() != o.segment(); }
+
+private:
+    offset_ptr<priv::MmapSegment> seg_;
+};
+
+// -----------------------------------------------------------------------------
+// A memory-mapped file, with named objects allocated in it
+// -----------------------------------------------------------------------------
+class mmap_file
+{
+public:
+    // Opens the file at `path`, or creates it with `size` bytes. An existing
+    // file smaller than `size` is grown to `size`. A new file is mapped at
+    // `addr` if not null, otherwise at an address chosen by the system.
+    mmap_file(const std::string& path, size_t size, void* addr = nullptr) {
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0)
+            phmap::base_internal::ThrowStdRuntimeError("phmap mmap_file: cannot open " + path);
+
+        struct stat st;
+        if (::fstat(fd_, &st) != 0) {
+            close_fd();
+            phmap::base_internal::ThrowStdRuntimeError("phmap mmap_file: cannot stat " + path);
+        }
+        size_t file_size = static_cast<size_t>(st.st_size);
+        created_ = file_size == 0;
+
+        priv::MmapSegment hdr;
+        if (!created_) {
+            if (file_size < sizeof(hdr) ||
+                ::pread(fd_, &hdr, sizeof(hdr), 0) != static_cast<ssize_t>(sizeof(hdr)) ||
+                !hdr.valid()) {
+                close_fd();
+                phmap::base_internal::ThrowStdRuntimeError("phmap mmap_file: invalid file " + path);
+            }
+            addr = reinterpret_cast<void*>(hdr.base());
+        } else if (size < sizeof(priv::MmapSegment) + 4096) {
+            close_fd();
+            phmap::base_internal::ThrowStdInvalidArgument("phmap mmap_file: size too small");
+        }
+
+        size_ = (std::max)(size, file_size);
+        if (size_ > file_size && ::ftruncate(fd_, static_cast<off_t>(size_)) != 0) {
+            close_fd();
+            phmap::base_internal::ThrowStdRuntimeError("phmap mmap_file: cannot resize " + path);
+        }
+
+        base_ = map(addr, !created_);
+        if (!base_) {
+            close_fd();
+            phmap::base_internal::ThrowStdRuntimeError(
+                "phmap mmap_file: cannot map " + path + " at its original address");
+        }
+
+        if (created_)
+            segment()->init(size_);
+        else
+            segment()->reopen(size_);
+    }
+
+    ~mmap_file() {
+        if (base_)
+            ::munmap(base_, size_);
+        close_fd();
+    }
+
+    mmap_file(const mmap_file&) = delete;
+    mmap_file& operator=(const mmap_file&) = delete;
+
+    // true if the file was created by the constructor
+    bool created() const { return created_; }
+
+    void*  base() const { return base_; }
+    size_t size() const { return size_; }
+
+    // bytes currently allocated in the file
+    size_t used_bytes() const { return segment()->used_bytes(); }
+
+    template <class T>
+    mmap_file_allocator<T> get_allocator() const { return mmap_file_allocator<T>(segment()); }
+
+    // Returns the object named `name`, or nullptr if there is none.
+    template <class T>
+    T* find(const char* name) const {
+        priv::MmapSegment::Root* r = segment()->find_root(name);
+        if (!r)
+            return nullptr;
+        if (r->size != sizeof(T))
+            phmap::base_internal::ThrowStdInvalidArgument("phmap mmap_file: object type mismatch");
+        return static_cast<T*>(segment()->at(r->offset));
+    }
+
+    // Returns the object named `name`, constructing it from `args` in the
+    // file if it does not exist.
+    template <class T, class... Args>
+    T* find_or_construct(const char* name, Args&&... args) {
+        if (T* p = find<T>(name))
+            return p;
+        auto alloc = get_allocator<T>();
+        priv::MmapSegment::Root* r = segment()->new_root(name);
+        T* p = alloc.allocate(1).get();
+        PHMAP_INTERNAL_TRY {
+            new (p) T(std::forward<Args>(args)...);
+        }
+        PHMAP_INTERNAL_CATCH_ANY {
+            alloc.deallocate(p, 1);
+            PHMAP_INTERNAL_RETHROW;
+        }
+        r->size   = sizeof(T);
+        r->offset = static_cast<uint64_t>(reinterpret_cast<char*>(p) - static_cast<char*>(base_));
+        return p;
+    }
+
+    // Destroys the object named `name`. Returns false if there is none.
+    template <class T>
+    bool destroy(const char* name) {
+        T* p = find<T>(name);
+        if (!p)
+            return false;
+        p->~T();
+        get_allocator<T>().deallocate(p, 1);
+        *segment()->find_root(name) = priv::MmapSegment::Root{};
+        return true;
+    }
+
+    // Writes the modified pages to the file.
+    void flush() {
+        if (::msync(base_, size_, MS_SYNC) != 0)
+            phmap::base_internal::ThrowStdRuntimeError("phmap mmap_file: msync failed");
+    }
+
+private:
+    priv::MmapSegment* segment() const { return static_cast<priv::MmapSegment*>(base_); }
+
+    // Maps the file at `addr`. If `fixed`, fails (returns nullptr) when the
+    // file cannot be mapped at exactly this address.
+    void* map(void* addr, bool fixed) {
+        int flags = MAP_SHARED;
+#ifdef MAP_FIXED_NOREPLACE
+        if (fixed)
+            flags |= MAP_FIXED_NOREPLACE;
+#endif
+        void* p = ::mmap(addr, size_, PROT_READ | PROT_WRITE, flags, fd_, 0);
+        if (p == MAP_FAILED)
+            return nullptr;
+        if (fixed && p != addr) {    // `addr` was only a hint
+            ::munmap(p, size_);
+            return nullptr;
+        }
+        return p;
+    }
+
+    void close_fd() {
+        if (fd_ >= 0)
+            ::close(fd_);
+        fd_ = -1;
+    }
+
+    int    fd_ = -1;
+    void*  base_ = nullptr;
+    size_t size_ = 0;
+    bool   created_ = false;
+};
+
+}  // namespace phmap
+
+#endif // PHMAP_HAVE_MMAP
+
+#endif // phmap_mmap_h_guard_
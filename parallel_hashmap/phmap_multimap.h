@@ -0,0 +1,766 @@
+#if !defined(phmap_multimap_h_guard_)
+#define phmap_multimap_h_guard_
+
+// ---------------------------------------------------------------------------
+// Copyright (c) 2019, Gregory Popovitch - greg7mdp@gmail.com
+//
+//       multi-valued hash containers
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+// IMPLEMENTATION DETAILS
+//
+// `flat_hash_multimap<K, V>` is made of a `flat_hash_map<K, Run>` index and of
+// a value arena owned by the map. The values of a key are stored contiguously
+// in the arena, in a "run" described by {offset, size, capacity}:
+//
+//    index:   "a" -> {0, 2, 2}    "b" -> {2, 3, 4}
+//    arena:   [a0 a1 | b0 b1 b2 -- | .......... ]
+//
+// Appending to a full run moves it to the end of the arena with twice the
+// capacity (or extends it in place when it is already last). The space left
+// behind is reclaimed when the arena is reallocated, which also compacts all
+// the runs. So, unlike `flat_hash_map<K, std::vector<V>>`, no allocation is
+// done per key.
+//
+// The values of a key can be accessed with `equal_range()`, which returns a
+// pair of pointers. As with `std::vector`, these pointers are invalidated by
+// any insertion into the map.
+// ---------------------------------------------------------------------------
+
+#include "phmap.h"
+
+namespace phmap {
+
+// -----------------------------------------------------------------------------
+// phmap::flat_hash_multimap
+// -----------------------------------------------------------------------------
+template <class Key, class Value, class Hash, class Eq, class Alloc> // default values in phmap_fwd_decl.h
+class flat_hash_multimap
+{
+    struct Run
+    {
+        size_t offset   = 0;
+        size_t size     = 0;
+        size_t capacity = 0;
+    };
+
+    using AllocTraits      = phmap::allocator_traits<Alloc>;
+    using IndexAlloc       = typename AllocTraits::template rebind_alloc<std::pair<const Key, Run>>;
+    using Index            = phmap::flat_hash_map<Key, Run, Hash, Eq, IndexAlloc>;
+    using ValueAlloc       = typename AllocTraits::template rebind_alloc<Value>;
+    using ValueAllocTraits = typename AllocTraits::template rebind_traits<Value>;
+
+public:
+    using key_type       = Key;
+    using mapped_type    = Value;
+    using size_type      = size_t;
+    using hasher         = Hash;
+    using key_equal      = Eq;
+    using allocator_type = Alloc;
+    using value_iterator       = Value*;
+    using const_value_iterator = const Value*;
+
+    flat_hash_multimap() {}
+
+    explicit flat_hash_multimap(size_t bucket_cnt, const hasher& hashfn = hasher(),
+                                const key_equal& eq = key_equal(),
+                                const allocator_type& alloc = allocator_type())
+        : index_(bucket_cnt, hashfn, eq, IndexAlloc(alloc)), alloc_(alloc) {}
+
+    flat_hash_multimap(std::initializer_list<std::pair<Key, Value>> init) {
+        insert(init.begin(), init.end());
+    }
+
+    flat_hash_multimap(const flat_hash_multimap& o)
+        : index_(o.index_),
+          alloc_(AllocTraits::select_on_container_copy_construction(o.alloc_)) {
+        copy_values_from(o);
+    }
+
+    flat_hash_multimap(flat_hash_multimap&& o) noexcept
+        : index_(std::move(o.index_)),
+          alloc_(o.alloc_),
+          values_(phmap::exchange(o.values_, nullptr)),
+          arena_cap_(phmap::exchange(o.arena_cap_, 0)),
+          arena_end_(phmap::exchange(o.arena_end_, 0)),
+          garbage_(phmap::exchange(o.garbage_, 0)),
+          size_(phmap::exchange(o.size_, 0)) {
+        o.index_.clear();
+    }
+
+    flat_hash_multimap& operator=(const flat_hash_multimap& o) {
+        flat_hash_multimap tmp(o);
+        swap(tmp);
+        return *this;
+    }
+
+    flat_hash_multimap& operator=(flat_hash_multimap&& o) noexcept {
+        flat_hash_multimap tmp(std::move(o));
+        swap(tmp);
+        return *this;
+    }
+
+    ~flat_hash_multimap() { destroy(); }
+
+    // number of values
+    size_t size() const     { return size_; }
+    bool   empty() const    { return size_ == 0; }
+
+    // number of distinct keys
+    size_t key_count() const { return index_.size(); }
+
+    template <class K>
+    size_t hash(const K& key) const { return index_.hash(key); }
+
+    hasher hash_function() const { return index_.hash_function(); }
+    key_equal key_eq() const { return index_.key_eq(); }
+    allocator_type get_allocator() const { return alloc_; }
+
+    // `num_values` is the total number of values, across all keys.
+    void reserve(size_t num_keys, size_t num_values = 0) {
+        index_.reserve(num_keys);
+        if (num_values > arena_cap_ - arena_end_ + garbage_)
+            reallocate(num_values - (arena_cap_ - arena_end_));
+    }
+
+    void clear() {
+        destroy_values();
+        index_.clear();
+        arena_end_ = garbage_ = size_ = 0;
+    }
+
+    void swap(flat_hash_multimap& o) noexcept {
+        using std::swap;
+        index_.swap(o.index_);
+        swap(alloc_, o.alloc_);
+        swap(values_, o.values_);
+        swap(arena_cap_, o.arena_cap_);
+        swap(arena_end_, o.arena_end_);
+        swap(garbage_, o.garbage_);
+        swap(size_, o.size_);
+    }
+
+    friend void swap(flat_hash_multimap& a, flat_hash_multimap& b) noexcept { a.swap(b); }
+
+    // ------------------------------- insertion -----------------------------------
+    // Appends a value constructed from `args...` to the values of `key`, and
+    // returns a reference to it.
+    template <class... Args>
+    Value& emplace(const key_type& key, Args&&... args) {
+        return emplace_with_hash(hash(key), key, std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    Value& emplace_with_hash(size_t hashval, const key_type& key, Args&&... args) {
+        Run& r = run_for(key, hashval);
+        Value* p = reserve_in_run(r, 1);
+        ValueAllocTraits::construct(alloc_, p, std::forward<Args>(args)...);
+        ++r.size;
+        ++size_;
+        return *p;
+    }
+
+    Value& insert(const std::pair<Key, Value>& v) { return emplace(v.first, v.second); }
+    Value& insert(std::pair<Key, Value>&& v)      { return emplace(v.first, std::move(v.second)); }
+
+    template <class InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first)
+            emplace(first->first, first->second);
+    }
+
+    // Bulk append: the run of `key` is grown once for all the values.
+    template <class ForwardIt>
+    void append(const key_type& key, ForwardIt first, ForwardIt last) {
+        append_with_hash(hash(key), key, first, last);
+    }
+
+    void append(const key_type& key, std::initializer_list<Value> values) {
+        append(key, values.begin(), values.end());
+    }
+
+    template <class ForwardIt>
+    void append_with_hash(size_t hashval, const key_type& key, ForwardIt first, ForwardIt last) {
+        size_t n = static_cast<size_t>(std::distance(first, last));
+        if (n == 0)
+            return;
+        Run& r = run_for(key, hashval);
+        Value* p = reserve_in_run(r, n);
+        for (; first != last; ++first, ++p) {
+            ValueAllocTraits::construct(alloc_, p, *first);
+            ++r.size;
+        }
+        size_ += n;
+    }
+
+    // -------------------------------- lookup -------------------------------------
+    size_t count(const key_type& key) const { return count(key, hash(key)); }
+
+    size_t count(const key_type& key, size_t hashval) const {
+        auto it = index_.find(key, hashval);
+        return it == index_.end() ? 0 : it->second.size;
+    }
+
+    bool contains(const key_type& key) const { return index_.contains(key); }
+    bool contains(const key_type& key, size_t hashval) const { return index_.contains(key, hashval); }
+
+    // Returns the contiguous range of the values of `key`, or an empty range.
+    std::pair<value_iterator, value_iterator> equal_range(const key_type& key) {
+        return equal_range(key, hash(key));
+    }
+
+    std::pair<value_iterator, value_iterator> equal_range(const key_type& key, size_t hashval) {
+        auto it = index_.find(key, hashval);
+        if (it == index_.end())
+            return { nullptr, nullptr };
+        Value* first = values_ + it->second.offset;
+        return { first, first + it->second.size };
+    }
+
+    std::pair<const_value_iterator, const_value_iterator> equal_range(const key_type& key) const {
+        return const_cast<flat_hash_multimap*>(this)->equal_range(key);
+    }
+
+    std::pair<const_value_iterator, const_value_iterator> equal_range(const key_type& key, size_t hashval) const {
+        return const_cast<flat_hash_multimap*>(this)->equal_range(key, hashval);
+    }
+
+    // Calls `f(key, value)` for every value in the map.
+    template <class F>
+    void for_each(F&& f) {
+        for (auto& kv : index_) {
+            Value* p = values_ + kv.second.offset;
+            for (size_t i = 0; i < kv.second.size; ++i)
+                f(kv.first, p[i]);
+        }
+    }
+
+    template <class F>
+    void for_each(F&& f) const {
+        for (const auto& kv : index_) {
+            const Value* p = values_ + kv.second.offset;
+            for (size_t i = 0; i < kv.second.size; ++i)
+                f(kv.first, p[i]);
+        }
+    }
+
+    // --------------------------------- erase -------------------------------------
+    // Removes all the values of `key`, and returns how many were removed.
+    size_t erase(const key_type& key) { return erase(key, hash(key)); }
+
+    size_t erase(const key_type& key, size_t hashval) {
+        auto it = index_.find(key, hashval);
+        if (it == index_.end())
+            return 0;
+        Run& r = it->second;
+        size_t n = r.size;
+        destroy_run(r);
+        garbage_ += r.capacity;
+        size_ -= n;
+        index_.erase(it);
+        return n;
+    }
+
+    friend bool operator==(const flat_hash_multimap& a, const flat_hash_multimap& b) {
+        if (a.size() != b.size() || a.key_count() != b.key_count())
+            return false;
+        for (const auto& kv : a.index_) {
+            auto rb = b.equal_range(kv.first);
+            const Value* pa = a.values_ + kv.second.offset;
+            if (static_cast<size_t>(rb.second - rb.first) != kv.second.size ||
+                !std::equal(pa, pa + kv.second.size, rb.first))
+                return false;
+        }
+        return true;
+    }
+
+    friend bool operator!=(const flat_hash_multimap& a, const flat_hash_multimap& b) {
+        return !(a == b);
+    }
+
+private:
+    static constexpr size_t kMinArena = 16;
+
+    Run& run_for(const key_type& key, size_t hashval) {
+        return index_.lazy_emplace_with_hash(key, hashval, [&](const typename Index::constructor& ctor) {
+            ctor(key, Run());
+        })->second;
+    }
+
+    // Makes room for `n` more values in `r`, and returns a pointer to the first
+    // (unconstructed) one.
+    Value* reserve_in_run(Run& r, size_t n) {
+        if (r.size + n <= r.capacity)
+            return values_ + r.offset + r.size;
+
+        size_t new_cap = (std::max)(r.capacity * 2, r.size + n);
+        if (r.capacity && r.offset + r.capacity == arena_end_ &&
+            r.offset + new_cap <= arena_cap_) {
+            // last run of the arena, grow in place
+            arena_end_ = r.offset + new_cap;
+            r.capacity = new_cap;
+            return values_ + r.offset + r.size;
+        }
+
+        if (arena_end_ + new_cap > arena_cap_) {
+            // compacts all runs, including `r`
+            reallocate(new_cap);
+            if (r.size + n <= r.capacity)
+                return values_ + r.offset + r.size;
+        }
+
+        Value* src = values_ + r.offset;
+        Value* dst = values_ + arena_end_;
+        for (size_t i = 0; i < r.size; ++i) {
+            ValueAllocTraits::construct(alloc_, dst + i, std::move(src[i]));
+            ValueAllocTraits::destroy(alloc_, src + i);
+        }
+        garbage_ += r.capacity;
+        r.offset = arena_end_;
+        r.capacity = new_cap;
+        arena_end_ += new_cap;
+        return values_ + r.offset + r.size;
+    }
+
+    // Moves all runs into a new arena with room for `extra` more values,
+    // dropping the space left by moved or erased runs.
+    void reallocate(size_t extra) {
+        size_t live = arena_end_ - garbage_;
+        size_t new_cap = (std::max)(size_t(kMinArena), 2 * (live + extra));
+        Value* new_values = ValueAllocTraits::allocate(alloc_, new_cap);
+        size_t offset = 0;
+        for (auto& kv : index_) {
+            Run& r = kv.second;
+            for (size_t i = 0; i < r.size; ++i) {
+                ValueAllocTraits::construct(alloc_, new_values + offset + i, std::move(values_[r.offset + i]));
+                ValueAllocTraits::destroy(alloc_, values_ + r.offset + i);
+            }
+            r.offset = offset;
+            offset += r.capacity;
+        }
+        if (values_)
+            ValueAllocTraits::deallocate(alloc_, values_, arena_cap_);
+        values_ = new_values;
+        arena_cap_ = new_cap;
+        arena_end_ = offset;
+        garbage_ = 0;
+    }
+
+    void copy_values_from(const flat_hash_multimap& o) {
+        size_t total = 0;
+        for (auto& kv : index_) {
+            kv.second.capacity = kv.second.size;
+            total += kv.second.size;
+        }
+        if (total == 0) {
+            size_ = 0;
+            for (auto& kv : index_)
+                kv.second.offset = 0;
+            return;
+        }
+        values_ = ValueAllocTraits::allocate(alloc_, total);
+        arena_cap_ = total;
+        for (auto& kv : index_) {
+            Run& r = kv.second;
+            const Value* src = o.values_ + r.offset;
+            r.offset = arena_end_;
+            for (size_t i = 0; i < r.size; ++i)
+                ValueAllocTraits::construct(alloc_, values_ + arena_end_ + i, src[i]);
+            arena_end_ += r.size;
+        }
+        size_ = total;
+    }
+
+    void destroy_run(const Run& r) {
+        for (size_t i = 0; i < r.size; ++i)
+            ValueAllocTraits::destroy(alloc_, values_ + r.offset + i);
+    }
+
+    void destroy_values() {
+        for (const auto& kv : index_)
+            destroy_run(kv.second);
+    }
+
+    void destroy() {
+        destroy_values();
+        if (values_)
+            ValueAllocTraits::deallocate(alloc_, values_, arena_cap_);
+        values_ = nullptr;
+        arena_cap_ = arena_end_ = garbage_ = size_ = 0;
+    }
+
+    Index      index_;
+    ValueAlloc alloc_;
+    Value*     values_    = nullptr;
+    size_t     arena_cap_ = 0;   // allocated values
+    size_t     arena_end_ = 0;   // first value not part of any run
+    size_t     garbage_   = 0;   // values in [0, arena_end_) not part of any run
+    size_t     size_      = 0;   // constructed values
+};
+
+// -----------------------------------------------------------------------------
+// phmap::flat_hash_multiset
+// -----------------------------------------------------------------------------
+// Equal elements are stored once, together with their multiplicity, so
+// inserting the same element again never allocates.
+// -----------------------------------------------------------------------------
+template <class T, class Hash, class Eq, class Alloc> // default values in phmap_fwd_decl.h
+class flat_hash_multiset
+{
+    using CountAlloc = typename phmap::allocator_traits<Alloc>::template rebind_alloc<std::pair<const T, size_t>>;
+    using Counts     = phmap::flat_hash_map<T, size_t, Hash, Eq, CountAlloc>;
+
+public:
+    using key_type       = T;
+    using value_type     = T;
+    using size_type      = size_t;
+    using hasher         = Hash;
+    using key_equal      = Eq;
+    using allocator_type = Alloc;
+
+    flat_hash_multiset() {}
+
+    explicit flat_hash_multiset(size_t bucket_cnt, const hasher& hashfn = hasher(),
+                                const key_equal& eq = key_equal(),
+                                const allocator_type& alloc = allocator_type())
+        : counts_(bucket_cnt, hashfn, eq, CountAlloc(alloc)) {}
+
+    flat_hash_multiset(std::initializer_list<T> init) { insert(init.begin(), init.end()); }
+
+    template <class InputIt>
+    flat_hash_multiset(InputIt first, InputIt last) { insert(first, last); }
+
+    // number of elements, counting duplicates
+    size_t size() const      { return size_; }
+    bool   empty() const     { return size_ == 0; }
+
+    // number of distinct elements
+    size_t key_count() const { return counts_.size(); }
+
+    template <class K>
+    size_t hash(const K& key) const { return counts_.hash(key); }
+
+    void reserve(size_t num_keys) { counts_.reserve(num_keys); }
+
+    void clear() {
+        counts_.clear();
+        size_ = 0;
+    }
+
+    void swap(flat_hash_multiset& o) noexcept {
+        counts_.swap(o.counts_);
+        std::swap(size_, o.size_);
+    }
+
+    // Inserts `n` copies of `v`, and returns the new count of `v`.
+    size_t insert(const T& v, size_t n = 1) {
+        size_ += n;
+        return counts_[v] += n;
+    }
+
+    size_t insert(T&& v, size_t n = 1) {
+        size_ += n;
+        return counts_[std::move(v)] += n;
+    }
+
+    template <class InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first)
+            insert(*first);
+    }
+
+    size_t count(const T& v) const {
+        auto it = counts_.find(v);
+        return it == counts_.end() ? 0 : it->second;
+    }
+
+    bool contains(const T& v) const { return counts_.contains(v); }
+
+    // Removes all copies of `v`, and returns how many were removed.
+    size_t erase(const T& v) {
+        auto it = counts_.find(v);
+        if (it == counts_.end())
+            return 0;
+        size_t n = it->second;
+        size_ -= n;
+        counts_.erase(it);
+        return n;
+    }
+
+    // Removes one copy of `v`, and returns true if there was one.
+    bool erase_one(const T& v) {
+        auto it = counts_.find(v);
+        if (it == counts_.end())
+            return false;
+        --size_;
+        if (--it->second == 0)
+            counts_.erase(it);
+        return true;
+    }
+
+    // Calls `f(v, count)` for each distinct element.
+    template <class F>
+    void for_each(F&& f) const {
+        for (const auto& kv : counts_)
+            f(kv.first, kv.second);
+    }
+
+    friend bool operator==(const flat_hash_multiset& a, const flat_hash_multiset& b) {
+        return a.size_ == b.size_ && a.counts_ == b.counts_;
+    }
+
+    friend bool operator!=(const flat_hash_multiset& a, const flat_hash_multiset& b) {
+        return !(a == b);
+    }
+
+private:
+    Counts counts_;
+    size_t size_ = 0;
+};
+
+// -----------------------------------------------------------------------------
+// phmap::parallel_flat_hash_multimap
+// -----------------------------------------------------------------------------
+// 2**N flat_hash_multimap submaps, each protected by its own mutex (when Mtx_
+// is not NullMutex), selected with the same hash bits as the other parallel
+// containers.
+//
+// As the value ranges of a submap are invalidated by insertions into that
+// submap, values are accessed under the submap lock through `with_values()`
+// (or `for_each()`), rather than with `equal_range()`.
+// -----------------------------------------------------------------------------
+template <class Key, class Value, class Hash, class Eq, class Alloc, size_t N, class Mtx_> // default values in phmap_fwd_decl.h
+class parallel_flat_hash_multimap
+{
+    static_assert(N <= 12, "N = 12 means 4096 hash tables!");
+    constexpr static size_t num_tables = 1 << N;
+    constexpr static size_t mask = num_tables - 1;
+
+    using Lockable   = phmap::LockableImpl<Mtx_>;
+    using UniqueLock = typename Lockable::UniqueLock;
+    using SharedLock = typename Lockable::SharedLock;
+
+public:
+    using EmbeddedMap    = phmap::flat_hash_multimap<Key, Value, Hash, Eq, Alloc>;
+    using key_type       = Key;
+    using mapped_type    = Value;
+    using size_type      = size_t;
+    using hasher         = Hash;
+    using key_equal      = Eq;
+    using allocator_type = Alloc;
+
+    parallel_flat_hash_multimap() {}
+
+    explicit parallel_flat_hash_multimap(size_t bucket_cnt, const hasher& hashfn = hasher(),
+                                         const key_equal& eq = key_equal(),
+                                         const allocator_type& alloc = allocator_type()) {
+        for (auto& inner : sets_)
+            inner.map_ = EmbeddedMap(bucket_cnt / num_tables, hashfn, eq, alloc);
+    }
+
+    parallel_flat_hash_multimap(std::initializer_list<std::pair<Key, Value>> init) {
+        insert(init.begin(), init.end());
+    }
+
+    parallel_flat_hash_multimap(const parallel_flat_hash_multimap& o) {
+        for (size_t i = 0; i < num_tables; ++i) {
+            SharedLock m(const_cast<Inner&>(o.sets_[i]));
+            sets_[i].map_ = o.sets_[i].map_;
+        }
+    }
+
+    parallel_flat_hash_multimap& operator=(const parallel_flat_hash_multimap& o) {
+        for (size_t i = 0; i < num_tables; ++i) {
+            SharedLock m(const_cast<Inner&>(o.sets_[i]));
+            UniqueLock m2(sets_[i]);
+            sets_[i].map_ = o.sets_[i].map_;
+        }
+        return *this;
+    }
+
+    static size_t subidx(size_t hashval) {
+        return ((hashval >> 8) ^ (hashval >> 16) ^ (hashval >> 24)) & mask;
+    }
+
+    static size_t subcnt() { return num_tables; }
+
+    template <class K>
+    size_t hash(const K& key) const { return sets_[0].map_.hash(key); }
+
+    size_t size() const {
+        size_t sz = 0;
+        for (const auto& inner : sets_) {
+            SharedLock m(const_cast<Inner&>(inner));
+            sz += inner.map_.size();
+        }
+        return sz;
+    }
+
+    size_t key_count() const {
+        size_t sz = 0;
+        for (const auto& inner : sets_) {
+            SharedLock m(const_cast<Inner&>(inner));
+            sz += inner.map_.key_count();
+        }
+        return sz;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    void reserve(size_t num_keys, size_t num_values = 0) {
+        for (auto& inner : sets_) {
+            UniqueLock m(inner);
+            inner.map_.reserve(num_keys / num_tables, num_values / num_tables);
+        }
+    }
+
+    void clear() {
+        for (auto& inner : sets_) {
+            UniqueLock m(inner);
+            inner.map_.clear();
+        }
+    }
+
+    // ------------------------------- insertion -----------------------------------
+    template <class... Args>
+    void emplace(const key_type& key, Args&&... args) {
+        size_t hashval = hash(key);
+        Inner& inner = sets_[subidx(hashval)];
+        UniqueLock m(inner);
+        inner.map_.emplace_with_hash(hashval, key, std::forward<Args>(args)...);
+    }
+
+    void insert(const std::pair<Key, Value>& v) { emplace(v.first, v.second); }
+    void insert(std::pair<Key, Value>&& v)      { emplace(v.first, std::move(v.second)); }
+
+    template <class InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first)
+            emplace(first->first, first->second);
+    }
+
+    template <class ForwardIt>
+    void append(const key_type& key, ForwardIt first, ForwardIt last) {
+        size_t hashval = hash(key);
+        Inner& inner = sets_[subidx(hashval)];
+        UniqueLock m(inner);
+        inner.map_.append_with_hash(hashval, key, first, last);
+    }
+
+    void append(const key_type& key, std::initializer_list<Value> values) {
+        append(key, values.begin(), values.end());
+    }
+
+    // -------------------------------- lookup -------------------------------------
+    size_t count(const key_type& key) const {
+        size_t hashval = hash(key);
+        const Inner& inner = sets_[subidx(hashval)];
+        SharedLock m(const_cast<Inner&>(inner));
+        return inner.map_.count(key, hashval);
+    }
+
+    bool contains(const key_type& key) const {
+        size_t hashval = hash(key);
+        const Inner& inner = sets_[subidx(hashval)];
+        SharedLock m(const_cast<Inner&>(inner));
+        return inner.map_.contains(key, hashval);
+    }
+
+    // Calls `f(first, last)` with the values of `key`, under the submap lock.
+    // Returns false if `key` is not present.
+    template <class F>
+    bool with_values(const key_type& key, F&& f) const {
+        size_t hashval = hash(key);
+        const Inner& inner = sets_[subidx(hashval)];
+        SharedLock m(const_cast<Inner&>(inner));
+        auto range = inner.map_.equal_range(key, hashval);
+        if (range.first == range.second)
+            return false;
+        std::forward<F>(f)(range.first, range.second);
+        return true;
+    }
+
+    // Same as above, but the values can be modified.
+    template <class F>
+    bool with_values_m(const key_type& key, F&& f) {
+        size_t hashval = hash(key);
+        Inner& inner = sets_[subidx(hashval)];
+        UniqueLock m(inner);
+        auto range = inner.map_.equal_range(key, hashval);
+        if (range.first == range.second)
+            return false;
+        std::forward<F>(f)(range.first, range.second);
+        return true;
+    }
+
+    // Calls `f(key, value)` for every value, one submap at a time.
+    template <class F>
+    void for_each(F&& f) const {
+        for (const auto& inner : sets_) {
+            SharedLock m(const_cast<Inner&>(inner));
+            inner.map_.for_each(f);
+        }
+    }
+
+    // Extension API: access internal submaps by index under lock protection.
+    template <class F>
+    void with_submap(size_t idx, F&& f) const {
+        const Inner& inner = sets_[idx];
+        SharedLock m(const_cast<Inner&>(inner));
+        f(inner.map_);
+    }
+
+    template <class F>
+    void with_submap_m(size_t idx, F&& f) {
+        Inner& inner = sets_[idx];
+        UniqueLock m(inner);
+        f(inner.map_);
+    }
+
+    // --------------------------------- erase -------------------------------------
+    size_t erase(const key_type& key) {
+        size_t hashval = hash(key);
+        Inner& inner = sets_[subidx(hashval)];
+        UniqueLock m(inner);
+        return inner.map_.erase(key, hashval);
+    }
+
+    friend bool operator==(const parallel_flat_hash_multimap& a, const parallel_flat_hash_multimap& b) {
+        for (size_t i = 0; i < num_tables; ++i) {
+            SharedLock m(const_cast<Inner&>(a.sets_[i]));
+            SharedLock m2(const_cast<Inner&>(b.sets_[i]));
+            if (a.sets_[i].map_ != b.sets_[i].map_)
+                return false;
+        }
+        return true;
+    }
+
+    friend bool operator!=(const parallel_flat_hash_multimap& a, const parallel_flat_hash_multimap& b) {
+        return !(a == b);
+    }
+
+private:
+    struct Inner : public Lockable
+    {
+        EmbeddedMap map_;
+    };
+
+    std::array<Inner, num_tables> sets_;
+};
+
+}  // namespace phmap
+
+#endif // phmap_multimap_h_guard_
@@ -0,0 +1,546 @@
+#if !defined(phmap_ordered_h_guard_)
+#define phmap_ordered_h_guard_
+
+// ---------------------------------------------------------------------------
+// Copyright (c) 2019, Gregory Popovitch - greg7mdp@gmail.com
+//
+//       insertion-ordered hash map
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+// IMPLEMENTATION DETAILS
+//
+// `ordered_flat_hash_map` stores its entries in a `std::vector` in insertion
+// order. The hash table itself only holds, for each slot, a control byte
+// (same layout and `Group` probing as `raw_hash_set`) and the 32 bit index of
+// the entry in the vector:
+//
+//    ctrl:    [ H2 | E | H2 | D | ... | S | cloned bytes ]
+//    index:   [ 1  | - | 0  | - | ... ]
+//    entries: [ {k0, v0}, {k1, v1}, ... ]     <- insertion order
+//
+// So:
+//  - iteration is a linear scan of the entries vector,
+//  - the table is small (5 bytes per slot), and growing it only rehashes the
+//    keys, without moving any entry,
+//  - the entries can be reordered (see `sort()`), after which the table is
+//    rebuilt.
+//
+// Iterators are random access iterators into the entries vector, and are
+// invalidated as for `std::vector`. Keys must not be modified through them.
+// A map holds at most 2^32 - 1 entries.
+// ---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "phmap.h"
+
+namespace phmap {
+
+// -----------------------------------------------------------------------------
+// phmap::ordered_flat_hash_map
+// -----------------------------------------------------------------------------
+template <class Key, class Value, class Hash, class Eq, class Alloc> // default values in phmap_fwd_decl.h
+class ordered_flat_hash_map
+{
+    using AllocTraits      = phmap::allocator_traits<Alloc>;
+    using EntryAlloc       = typename AllocTraits::template rebind_alloc<std::pair<Key, Value>>;
+    using IndexAlloc       = typename AllocTraits::template rebind_alloc<uint32_t>;
+    using IndexAllocTraits = typename AllocTraits::template rebind_traits<uint32_t>;
+    using Entries          = std::vector<std::pair<Key, Value>, EntryAlloc>;
+    using ctrl_t           = priv::ctrl_t;
+    using Group            = priv::Group;
+
+public:
+    using key_type        = Key;
+    using mapped_type     = Value;
+    using value_type      = std::pair<Key, Value>;
+    using size_type       = size_t;
+    using difference_type = ptrdiff_t;
+    using hasher          = Hash;
+    using key_equal       = Eq;
+    using allocator_type  = Alloc;
+    using reference       = value_type&;
+    using const_reference = const value_type&;
+    using iterator        = typename Entries::iterator;
+    using const_iterator  = typename Entries::const_iterator;
+
+    static constexpr size_t npos = size_t(-1);
+
+    ordered_flat_hash_map() {}
+
+    explicit ordered_flat_hash_map(size_t bucket_cnt, const hasher& hashfn = hasher(),
+                                   const key_equal& eq = key_equal(),
+                                   const allocator_type& alloc = allocator_type())
+        : entries_(EntryAlloc(alloc)), hash_(hashfn), eq_(eq), alloc_(alloc) {
+        if (bucket_cnt)
+            init_table(priv::NormalizeCapacity(bucket_cnt));
+    }
+
+    template <class InputIt>
+    ordered_flat_hash_map(InputIt first, InputIt last) { insert(first, last); }
+
+    ordered_flat_hash_map(std::initializer_list<value_type> init) {
+        insert(init.begin(), init.end());
+    }
+
+    ordered_flat_hash_map(const ordered_flat_hash_map& o)
+        : entries_(o.entries_), hash_(o.hash_), eq_(o.eq_),
+          alloc_(IndexAllocTraits::select_on_container_copy_construction(o.alloc_)) {
+        if (o.capacity_) {
+            init_table(o.capacity_);
+            std::memcpy(ctrl_, o.ctrl_, table_words(capacity_) * sizeof(uint32_t));
+            growth_left_ = o.growth_left_;
+        }
+    }
+
+    ordered_flat_hash_map(ordered_flat_hash_map&& o) noexcept
+        : entries_(std::move(o.entries_)), hash_(o.hash_), eq_(o.eq_), alloc_(o.alloc_),
+          ctrl_(phmap::exchange(o.ctrl_, priv::EmptyGroup<std::true_type>())),
+          index_(phmap::exchange(o.index_, nullptr)),
+          capacity_(phmap::exchange(o.capacity_, 0)),
+          growth_left_(phmap::exchange(o.growth_left_, 0)) {
+        o.entries_.clear();
+    }
+
+    ordered_flat_hash_map& operator=(const ordered_flat_hash_map& o) {
+        ordered_flat_hash_map tmp(o);
+        swap(tmp);
+        return *this;
+    }
+
+    ordered_flat_hash_map& operator=(ordered_flat_hash_map&& o) noexcept {
+        ordered_flat_hash_map tmp(std::move(o));
+        swap(tmp);
+        return *this;
+    }
+
+    ~ordered_flat_hash_map() { free_table(); }
+
+    // ------------------------------ iterators ------------------------------------
+    iterator       begin()        { return entries_.begin(); }
+    iterator       end()          { return entries_.end(); }
+    const_iterator begin() const  { return entries_.begin(); }
+    const_iterator end() const    { return entries_.end(); }
+    const_iterator cbegin() const { return entries_.begin(); }
+    const_iterator cend() const   { return entries_.end(); }
+
+    // The entries, in order, as a contiguous array.
+    const value_type* data() const { return entries_.data(); }
+
+    // -------------------------------- capacity -----------------------------------
+    bool   empty() const        { return entries_.empty(); }
+    size_t size() const         { return entries_.size(); }
+    size_t capacity() const     { return capacity_; }
+    size_t bucket_count() const { return capacity_; }
+    size_t max_size() const     { return (std::numeric_limits<uint32_t>::max)() - 1; }
+
+    float load_factor() const {
+        return capacity_ ? static_cast<float>(static_cast<double>(size()) / capacity_) : 0.0f;
+    }
+
+    void reserve(size_t n) {
+        entries_.reserve(n);
+        if (n > size() + growth_left_)
+            rebuild(priv::NormalizeCapacity(priv::GrowthToLowerboundCapacity(n)));
+    }
+
+    // Rehashes the table for `n` buckets or more. rehash(0) shrinks the table
+    // to fit the current number of entries.
+    void rehash(size_t n) {
+        size_t m = priv::NormalizeCapacity((std::max)(n, priv::GrowthToLowerboundCapacity(size())));
+        if (n == 0 && size() == 0) {
+            free_table();
+            return;
+        }
+        if (n == 0 || m > capacity_)
+            rebuild(m);
+    }
+
+    void clear() {
+        entries_.clear();
+        if (capacity_) {
+            reset_ctrl();
+            growth_left_ = priv::CapacityToGrowth(capacity_);
+        }
+    }
+
+    void swap(ordered_flat_hash_map& o) noexcept {
+        using std::swap;
+        entries_.swap(o.entries_);
+        swap(hash_, o.hash_);
+        swap(eq_, o.eq_);
+        swap(alloc_, o.alloc_);
+        swap(ctrl_, o.ctrl_);
+        swap(index_, o.index_);
+        swap(capacity_, o.capacity_);
+        swap(growth_left_, o.growth_left_);
+    }
+
+    friend void swap(ordered_flat_hash_map& a, ordered_flat_hash_map& b) noexcept { a.swap(b); }
+
+    hasher hash_function() const { return hash_; }
+    key_equal key_eq() const { return eq_; }
+    allocator_type get_allocator() const { return alloc_; }
+
+    size_t hash(const key_type& key) const {
+#if PHMAP_DISABLE_MIX
+        return hash_(key);
+#else
+        return phmap_mix<sizeof(size_t)>()(hash_(key));
+#endif
+    }
+
+    // ------------------------------- insertion -----------------------------------
+    // New entries are appended at the end; an existing entry keeps its position.
+    std::pair<iterator, bool> insert(const value_type& v) { return try_emplace(v.first, v.second); }
+    std::pair<iterator, bool> insert(value_type&& v) {
+        return try_emplace(std::move(v.first), std::move(v.second));
+    }
+
+    template <class P, typename std::enable_if<
+                           std::is_constructible<value_type, P&&>::value, int>::type = 0>
+    std::pair<iterator, bool> insert(P&& v) {
+        return emplace(std::forward<P>(v));
+    }
+
+    template <class InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first)
+            insert(*first);
+    }
+
+    void insert(std::initializer_list<value_type> ilist) { insert(ilist.begin(), ilist.end()); }
+
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        value_type v(std::forward<Args>(args)...);
+        return try_emplace(std::move(v.first), std::move(v.second));
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+        return try_emplace_impl(key, std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+        return try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+    }
+
+    template <class V>
+    std::pair<iterator, bool> insert_or_assign(const key_type& key, V&& v) {
+        auto res = try_emplace(key, std::forward<V>(v));
+        if (!res.second)
+            res.first->second = std::forward<V>(v);
+        return res;
+    }
+
+    template <class V>
+    std::pair<iterator, bool> insert_or_assign(key_type&& key, V&& v) {
+        auto res = try_emplace(std::move(key), std::forward<V>(v));
+        if (!res.second)
+            res.first->second = std::forward<V>(v);
+        return res;
+    }
+
+    Value& operator[](const key_type& key) { return try_emplace(key).first->second; }
+    Value& operator[](key_type&& key)      { return try_emplace(std::move(key)).first->second; }
+
+    // -------------------------------- lookup -------------------------------------
+    // Returns the position of `key` in insertion order, or npos.
+    size_t index_of(const key_type& key) const {
+        size_t slot = find_slot(key, hash(key));
+        return slot == npos ? npos : index_[slot];
+    }
+
+    iterator find(const key_type& key) {
+        size_t i = index_of(key);
+        return i == npos ? end() : begin() + static_cast<difference_type>(i);
+    }
+
+    const_iterator find(const key_type& key) const {
+        size_t i = index_of(key);
+        return i == npos ? end() : begin() + static_cast<difference_type>(i);
+    }
+
+    bool   contains(const key_type& key) const { return index_of(key) != npos; }
+    size_t count(const key_type& key) const    { return contains(key) ? 1 : 0; }
+
+    Value& at(const key_type& key) {
+        size_t i = index_of(key);
+        if (i == npos)
+            base_internal::ThrowStdOutOfRange("phmap at(): lookup non-existent key");
+        return entries_[i].second;
+    }
+
+    const Value& at(const key_type& key) const {
+        return const_cast<ordered_flat_hash_map*>(this)->at(key);
+    }
+
+    // --------------------------------- erase -------------------------------------
+    // erase() keeps the order of the remaining entries, and is O(size()).
+    // swap_erase() moves the last entry in place of the erased one, and is O(1).
+    size_t erase(const key_type& key) {
+        size_t slot = find_slot(key, hash(key));
+        if (slot == npos)
+            return 0;
+        erase_at(slot);
+        return 1;
+    }
+
+    iterator erase(const_iterator it) {
+        size_t i = static_cast<size_t>(it - cbegin());
+        erase_at(slot_of(i));
+        return begin() + static_cast<difference_type>(i);
+    }
+
+    iterator erase(iterator it) { return erase(const_iterator(it)); }
+
+    size_t swap_erase(const key_type& key) {
+        size_t slot = find_slot(key, hash(key));
+        if (slot == npos)
+            return 0;
+        swap_erase_at(slot);
+        return 1;
+    }
+
+    // Removes the entries for which `pred(entry)` is true, keeping the order of
+    // the other ones, and returns the number of removed entries.
+    template <class Pred>
+    friend size_t erase_if(ordered_flat_hash_map& c, Pred pred) {
+        size_t old_size = c.size();
+        c.entries_.erase(std::remove_if(c.entries_.begin(), c.entries_.end(), pred),
+                         c.entries_.end());
+        if (c.size() != old_size)
+            c.rebuild(c.capacity_);
+        return old_size - c.size();
+    }
+
+    // ------------------------------- reordering ----------------------------------
+    // Sorts the entries with `comp(const value_type&, const value_type&)`.
+    template <class Compare>
+    void sort(Compare comp) {
+        std::sort(entries_.begin(), entries_.end(), comp);
+        rebuild(capacity_);
+    }
+
+    // Sorts the entries by key.
+    void sort_keys() {
+        sort([](const value_type& a, const value_type& b) { return a.first < b.first; });
+    }
+
+    // Equality does not depend on the order of the entries.
+    friend bool operator==(const ordered_flat_hash_map& a, const ordered_flat_hash_map& b) {
+        if (a.size() != b.size())
+            return false;
+        for (const auto& e : a.entries_) {
+            auto it = b.find(e.first);
+            if (it == b.end() || !(it->second == e.second))
+                return false;
+        }
+        return true;
+    }
+
+    friend bool operator!=(const ordered_flat_hash_map& a, const ordered_flat_hash_map& b) {
+        return !(a == b);
+    }
+
+private:
+    template <class K, class... Args>
+    std::pair<iterator, bool> try_emplace_impl(K&& key, Args&&... args) {
+        size_t hashval = hash(key);
+        size_t slot = find_slot(key, hashval);
+        if (slot != npos)
+            return { begin() + static_cast<difference_type>(index_[slot]), false };
+        assert(size() < max_size() && "ordered_flat_hash_map is full");
+        slot = prepare_insert(hashval);
+        entries_.emplace_back(std::piecewise_construct,
+                              std::forward_as_tuple(std::forward<K>(key)),
+                              std::forward_as_tuple(std::forward<Args>(args)...));
+        growth_left_ -= priv::IsEmpty(ctrl_[slot]);
+        set_ctrl(slot, priv::H2(hashval));
+        index_[slot] = static_cast<uint32_t>(size() - 1);
+        return { end() - 1, true };
+    }
+
+    priv::probe_seq<Group::kWidth> probe(size_t hashval) const {
+        return priv::probe_seq<Group::kWidth>(priv::H1(hashval, ctrl_), capacity_);
+    }
+
+    size_t find_slot(const key_type& key, size_t hashval) const {
+        auto seq = probe(hashval);
+        while (true) {
+            Group g{ctrl_ + seq.offset()};
+            for (uint32_t i : g.Match((priv::h2_t)priv::H2(hashval))) {
+                size_t slot = seq.offset((size_t)i);
+                if (PHMAP_PREDICT_TRUE(eq_(entries_[index_[slot]].first, key)))
+                    return slot;
+            }
+            if (PHMAP_PREDICT_TRUE(g.MatchEmpty()))
+                return npos;
+            seq.next();
+        }
+    }
+
+    // slot holding the entry index `i`
+    size_t slot_of(size_t i) const {
+        size_t hashval = hash(entries_[i].first);
+        auto seq = probe(hashval);
+        while (true) {
+            Group g{ctrl_ + seq.offset()};
+            for (uint32_t j : g.Match((priv::h2_t)priv::H2(hashval))) {
+                size_t slot = seq.offset((size_t)j);
+                if (index_[slot] == i)
+                    return slot;
+            }
+            assert(!g.MatchEmpty() && "entry not found in the table");
+            seq.next();
+        }
+    }
+
+    size_t find_first_non_full(size_t hashval) const {
+        auto seq = probe(hashval);
+        while (true) {
+            Group g{ctrl_ + seq.offset()};
+            auto mask = g.MatchEmptyOrDeleted();
+            if (mask)
+                return seq.offset((size_t)mask.LowestBitSet());
+            assert(seq.getindex() < capacity_ && "full table!");
+            seq.next();
+        }
+    }
+
+    size_t prepare_insert(size_t hashval) {
+        size_t target = find_first_non_full(hashval);
+        if (PHMAP_PREDICT_FALSE(growth_left_ == 0 && !priv::IsDeleted(ctrl_[target]))) {
+            if (capacity_ > Group::kWidth && size() * uint64_t{32} <= capacity_ * uint64_t{25})
+                rebuild(capacity_);   // only drop the deleted slots
+            else
+                rebuild(capacity_ * 2 + 1);
+            target = find_first_non_full(hashval);
+        }
+        return target;
+    }
+
+    // same as raw_hash_set::erase_meta_only()
+    void erase_slot(size_t slot) {
+        const size_t index_before = (slot - Group::kWidth) & capacity_;
+        const auto empty_after = Group(ctrl_ + slot).MatchEmpty();
+        const auto empty_before = Group(ctrl_ + index_before).MatchEmpty();
+        bool was_never_full =
+            empty_before && empty_after &&
+            static_cast<size_t>(empty_after.TrailingZeros() +
+                                empty_before.LeadingZeros()) < Group::kWidth;
+        set_ctrl(slot, was_never_full ? priv::kEmpty : priv::kDeleted);
+        growth_left_ += was_never_full;
+    }
+
+    void erase_at(size_t slot) {
+        uint32_t i = index_[slot];
+        erase_slot(slot);
+        entries_.erase(entries_.begin() + static_cast<difference_type>(i));
+        if (i == size())
+            return;
+        for (size_t s = 0; s != capacity_; ++s)
+            if (priv::IsFull(ctrl_[s]) && index_[s] > i)
+                --index_[s];
+    }
+
+    void swap_erase_at(size_t slot) {
+        uint32_t i = index_[slot];
+        erase_slot(slot);
+        size_t last = size() - 1;
+        if (i != last) {
+            index_[slot_of(last)] = i;
+            entries_[i] = std::move(entries_[last]);
+        }
+        entries_.pop_back();
+    }
+
+    void set_ctrl(size_t i, ctrl_t h) {
+        assert(i < capacity_);
+        ctrl_[i] = h;
+        ctrl_[((i - Group::kWidth) & capacity_) + 1 + ((Group::kWidth - 1) & capacity_)] = h;
+    }
+
+    void reset_ctrl() {
+        std::memset(ctrl_, priv::kEmpty, capacity_ + Group::kWidth);
+        ctrl_[capacity_] = priv::kSentinel;
+    }
+
+    // the control bytes and the indices are allocated in a single block
+    static size_t table_words(size_t capacity) {
+        return (capacity + Group::kWidth + sizeof(uint32_t) - 1) / sizeof(uint32_t) + capacity;
+    }
+
+    void init_table(size_t capacity) {
+        assert(priv::IsValidCapacity(capacity));
+        uint32_t* mem = IndexAllocTraits::allocate(alloc_, table_words(capacity));
+        capacity_ = capacity;
+        ctrl_ = reinterpret_cast<ctrl_t*>(mem);
+        index_ = mem + table_words(capacity) - capacity;
+        reset_ctrl();
+        growth_left_ = priv::CapacityToGrowth(capacity);
+    }
+
+    void free_table() {
+        if (capacity_)
+            IndexAllocTraits::deallocate(alloc_, reinterpret_cast<uint32_t*>(ctrl_),
+                                         table_words(capacity_));
+        ctrl_ = priv::EmptyGroup<std::true_type>();
+        index_ = nullptr;
+        capacity_ = growth_left_ = 0;
+    }
+
+    // Rebuilds the table from the entries, with `capacity` slots (or more if
+    // needed to hold all the entries).
+    void rebuild(size_t capacity) {
+        size_t min_capacity = priv::NormalizeCapacity(priv::GrowthToLowerboundCapacity(size()));
+        capacity = (std::max)(capacity, min_capacity);
+        if (capacity != capacity_) {
+            free_table();
+            init_table(capacity);
+        } else {
+            reset_ctrl();
+            growth_left_ = priv::CapacityToGrowth(capacity);
+        }
+        for (size_t i = 0; i < size(); ++i) {
+            size_t hashval = hash(entries_[i].first);
+            size_t target = find_first_non_full(hashval);
+            set_ctrl(target, priv::H2(hashval));
+            index_[target] = static_cast<uint32_t>(i);
+        }
+        growth_left_ -= size();
+    }
+
+    Entries    entries_;
+    hasher     hash_;
+    key_equal  eq_;
+    IndexAlloc alloc_;
+    ctrl_t*    ctrl_        = priv::EmptyGroup<std::true_type>();
+    uint32_t*  index_       = nullptr;
+    size_t     capacity_    = 0;
+    size_t     growth_left_ = 0;
+};
+
+template <class Key, class Value, class Hash, class Eq, class Alloc>
+constexpr size_t ordered_flat_hash_map<Key, Value, Hash, Eq, Alloc>::npos;
+
+}  // namespace phmap
+
+#endif // phmap_ordered_h_guard_
@@ -0,0 +1,1400 @@
+#if !defined(phmap_sparse_h_guard_)
+#define phmap_sparse_h_guard_
+
+// ---------------------------------------------------------------------------
+// Copyright (c) 2019, Gregory Popovitch - greg7mdp@gmail.com
+//
+//       memory frugal (sparse) hash containers
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+// IMPLEMENTATION DETAILS
+//
+// The `sparse` hash containers are open addressing hash tables (triangular
+// probing over a power of 2 number of buckets), where the buckets are split
+// in groups of 64. A group only stores its present elements, in bucket order,
+// in an array allocated to the exact size:
+//
+//    struct SparseGroup {
+//        slot_type* slots;     // [popcount(bitmap)] elements
+//        uint64_t   bitmap;    // bucket i is occupied
+//        uint64_t   deleted;   // bucket i held an erased element (tombstone)
+//    };
+//
+// The element of bucket i is `slots[popcount(bitmap & ((1 << i) - 1))]`.
+//
+// So an empty bucket costs 3 bits (2 bits of bitmaps, and the group pointer
+// shared by 64 buckets), and the maximum load factor can be kept at 0.5 to
+// limit probing. This trades CPU for memory: an insertion or an erasure
+// reallocates the array of the group, and lookups compare keys for every
+// occupied bucket probed (there are no H2 control bytes).
+//
+// The elements move when their group is reallocated, so pointers to elements
+// are invalidated by insertions and erasures. Iterators are invalidated by
+// insertions (as for `flat` containers), but not by erasures of other elements.
+// ---------------------------------------------------------------------------
+
+#include "phmap.h"
+
+namespace phmap {
+
+namespace priv {
+
+// --------------------------------------------------------------------------
+// 64 buckets of a sparse hash table, see implementation details above.
+// --------------------------------------------------------------------------
+template <class Slot>
+struct SparseGroup
+{
+    static constexpr size_t kSize = 64;
+
+    uint32_t size() const { return base_internal::Popcount64(bitmap); }
+
+    bool occupied(size_t b) const   { return (bitmap >> b) & 1; }
+    bool is_deleted(size_t b) const { return (deleted >> b) & 1; }
+
+    // index in `slots` of the element of bucket `b`
+    uint32_t rank(size_t b) const {
+        return base_internal::Popcount64(bitmap & ((uint64_t(1) << b) - 1));
+    }
+
+    Slot*    slots   = nullptr;
+    uint64_t bitmap  = 0;
+    uint64_t deleted = 0;
+};
+
+// ----------------------------------------------------------------------------
+// Sparse hash table (see implementation details above).
+//
+// The Policy is one of the flat policies (FlatHashSetPolicy/FlatHashMapPolicy).
+//
+// This class also provides the internal interface used by `parallel_hash_set`,
+// so it can be used as its `RefSet` template parameter. Its `set_ctrl()` does
+// nothing, as the bucket is marked as occupied by `emplace_at()`.
+// ----------------------------------------------------------------------------
+template <class Policy, class Hash, class Eq, class Alloc>
+class raw_sparse_hash_set
+{
+    using PolicyTraits = hash_policy_traits<Policy>;
+    using KeyArgImpl =
+        KeyArg<IsTransparent<Eq>::value && IsTransparent<Hash>::value>;
+
+public:
+    using init_type       = typename PolicyTraits::init_type;
+    using key_type        = typename PolicyTraits::key_type;
+    using slot_type       = typename PolicyTraits::slot_type;
+    using allocator_type  = Alloc;
+    using size_type       = size_t;
+    using difference_type = ptrdiff_t;
+    using hasher          = Hash;
+    using key_equal       = Eq;
+    using policy_type     = Policy;
+    using value_type      = typename PolicyTraits::value_type;
+    using reference       = value_type&;
+    using const_reference = const value_type&;
+    using pointer         = value_type*;
+    using const_pointer   = const value_type*;
+
+    template <class K>
+    using key_arg = typename KeyArgImpl::template type<K, key_type>;
+
+private:
+    using SGroup = SparseGroup<slot_type>;
+    using AllocTraits = phmap::allocator_traits<allocator_type>;
+    using SlotAlloc = typename AllocTraits::template rebind_alloc<slot_type>;
+    using SlotAllocTraits = typename AllocTraits::template rebind_traits<slot_type>;
+    using GroupAlloc = typename AllocTraits::template rebind_alloc<SGroup>;
+    using GroupAllocTraits = typename AllocTraits::template rebind_traits<SGroup>;
+    using PosAlloc = typename AllocTraits::template rebind_alloc<uint32_t>;
+    using PosAllocTraits = typename AllocTraits::template rebind_traits<uint32_t>;
+
+    static constexpr size_t kGroupSize = SGroup::kSize;
+
+    // smallest valid number of buckets >= n
+    static size_t NormalizeBuckets(size_t n) {
+        return n <= kGroupSize ? kGroupSize : NormalizeCapacity(n - 1) + 1;
+    }
+
+    // maximum load factor of 0.5
+    static size_t BucketsToGrowth(size_t buckets) { return buckets / 2; }
+
+    template <class T>
+    struct SameAsElementReference
+        : std::is_same<typename std::remove_cv<typename std::remove_reference<reference>::type>::type,
+                       typename std::remove_cv<typename std::remove_reference<T>::type>::type> {};
+
+    template <class T>
+    using RequiresInsertable = typename std::enable_if<
+        phmap::disjunction<std::is_convertible<T, init_type>,
+                           SameAsElementReference<T>>::value, int>::type;
+
+    template <class T>
+    using RequiresNotInit =
+        typename std::enable_if<!std::is_same<T, init_type>::value, int>::type;
+
+    template <class... Ts>
+    using IsDecomposable = priv::IsDecomposable<void, PolicyTraits, Hash, Eq, Ts...>;
+
+public:
+    class iterator
+    {
+        friend class raw_sparse_hash_set;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename raw_sparse_hash_set::value_type;
+        using reference =
+            phmap::conditional_t<PolicyTraits::constant_iterators::value,
+                                 const value_type&, value_type&>;
+        using pointer = phmap::remove_reference_t<reference>*;
+        using difference_type = typename raw_sparse_hash_set::difference_type;
+
+        iterator() {}
+
+        // PRECONDITION: not an end() iterator.
+        reference operator*() const {
+            return PolicyTraits::element(group_->slots + group_->rank(bucket_));
+        }
+
+        // PRECONDITION: not an end() iterator.
+        pointer operator->() const { return &operator*(); }
+
+        // PRECONDITION: not an end() iterator.
+        iterator& operator++() {
+            uint64_t next = group_->bitmap & ~((uint64_t(2) << bucket_) - 1);
+            if (next) {
+                bucket_ = TrailingZeros(next);
+            } else {
+                ++group_;
+                skip_empty_groups();
+            }
+            return *this;
+        }
+
+        iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b) {
+            return a.group_ == b.group_ && a.bucket_ == b.bucket_;
+        }
+        friend bool operator!=(const iterator& a, const iterator& b) {
+            return !(a == b);
+        }
+
+    private:
+        iterator(SGroup* group, SGroup* last, size_t bucket) :
+            group_(group), last_(last), bucket_(static_cast<uint32_t>(bucket)) {}
+
+        void skip_empty_groups() {
+            while (group_ != last_ && group_->bitmap == 0)
+                ++group_;
+            bucket_ = group_ != last_ ? TrailingZeros(group_->bitmap) : 0;
+        }
+
+        // The bucket is stored rather than a slot pointer, as the elements of a
+        // group move when another element of the group is erased.
+        SGroup*  group_  = nullptr;
+        SGroup*  last_   = nullptr;   // end() is {last_, last_, 0}
+        uint32_t bucket_ = 0;
+    };
+
+    class const_iterator
+    {
+        friend class raw_sparse_hash_set;
+
+    public:
+        using iterator_category = typename iterator::iterator_category;
+        using value_type = typename raw_sparse_hash_set::value_type;
+        using reference = typename raw_sparse_hash_set::const_reference;
+        using pointer = typename raw_sparse_hash_set::const_pointer;
+        using difference_type = typename raw_sparse_hash_set::difference_type;
+
+        const_iterator() {}
+        // Implicit construction from iterator.
+        const_iterator(iterator i) : inner_(std::move(i)) {}
+
+        reference operator*() const { return *inner_; }
+        pointer operator->() const { return inner_.operator->(); }
+
+        const_iterator& operator++() {
+            ++inner_;
+            return *this;
+        }
+        const_iterator operator++(int) { return inner_++; }
+
+        friend bool operator==(const const_iterator& a, const const_iterator& b) {
+            return a.inner_ == b.inner_;
+        }
+        friend bool operator!=(const const_iterator& a, const const_iterator& b) {
+            return !(a == b);
+        }
+
+    private:
+        iterator inner_;
+    };
+
+    // Extension API: support for lazy emplace, see raw_hash_set::constructor.
+    class constructor
+    {
+        friend class raw_sparse_hash_set;
+
+    public:
+        template <class... Args>
+        void operator()(Args&&... args) const {
+            assert(*set_);
+            (*set_)->emplace_at(offset_, std::forward<Args>(args)...);
+            *set_ = nullptr;
+        }
+
+    private:
+        constructor(raw_sparse_hash_set** set, size_t offset) : set_(set), offset_(offset) {}
+
+        raw_sparse_hash_set** set_;
+        size_t offset_;
+    };
+
+    raw_sparse_hash_set() noexcept(
+        std::is_nothrow_default_constructible<hasher>::value&&
+        std::is_nothrow_default_constructible<key_equal>::value&&
+        std::is_nothrow_default_constructible<allocator_type>::value) {}
+
+    explicit raw_sparse_hash_set(size_t bucket_cnt, const hasher& hashfn = hasher(),
+                                 const key_equal& eq = key_equal(),
+                                 const allocator_type& alloc = allocator_type())
+        : settings_(0, hashfn, eq, alloc) {
+        if (bucket_cnt)
+            resize(NormalizeBuckets(bucket_cnt));
+    }
+
+    raw_sparse_hash_set(size_t bucket_cnt, const hasher& hashfn,
+                        const allocator_type& alloc)
+        : raw_sparse_hash_set(bucket_cnt, hashfn, key_equal(), alloc) {}
+
+    raw_sparse_hash_set(size_t bucket_cnt, const allocator_type& alloc)
+        : raw_sparse_hash_set(bucket_cnt, hasher(), key_equal(), alloc) {}
+
+    explicit raw_sparse_hash_set(const allocator_type& alloc)
+        : raw_sparse_hash_set(0, hasher(), key_equal(), alloc) {}
+
+    template <class InputIter>
+    raw_sparse_hash_set(InputIter first, InputIter last, size_t bucket_cnt = 0,
+                        const hasher& hashfn = hasher(), const key_equal& eq = key_equal(),
+                        const allocator_type& alloc = allocator_type())
+        : raw_sparse_hash_set(bucket_cnt, hashfn, eq, alloc) {
+        insert(first, last);
+    }
+
+    template <class T, RequiresNotInit<T> = 0, RequiresInsertable<T> = 0>
+    raw_sparse_hash_set(std::initializer_list<T> init, size_t bucket_cnt = 0,
+                        const hasher& hashfn = hasher(), const key_equal& eq = key_equal(),
+                        const allocator_type& alloc = allocator_type())
+        : raw_sparse_hash_set(init.begin(), init.end(), bucket_cnt, hashfn, eq, alloc) {}
+
+    raw_sparse_hash_set(std::initializer_list<init_type> init, size_t bucket_cnt = 0,
+                        const hasher& hashfn = hasher(), const key_equal& eq = key_equal(),
+                        const allocator_type& alloc = allocator_type())
+        : raw_sparse_hash_set(init.begin(), init.end(), bucket_cnt, hashfn, eq, alloc) {}
+
+    raw_sparse_hash_set(const raw_sparse_hash_set& that)
+        : raw_sparse_hash_set(that, AllocTraits::select_on_container_copy_construction(
+                                  that.alloc_ref())) {}
+
+    // The copy has the same buckets as `that`, group by group.
+    raw_sparse_hash_set(const raw_sparse_hash_set& that, const allocator_type& a)
+        : raw_sparse_hash_set(0, that.hash_ref(), that.eq_ref(), a) {
+        if (!that.capacity_)
+            return;
+        allocate_groups(that.capacity_);
+        for (size_t g = 0; g < num_groups(); ++g) {
+            const SGroup& src = that.groups_[g];
+            SGroup& dst = groups_[g];
+            uint32_t n = src.size();
+            if (n) {
+                dst.slots = allocate_slots(n);
+                for (uint32_t i = 0; i < n; ++i)
+                    PolicyTraits::construct(&alloc_ref(), dst.slots + i,
+                                            PolicyTraits::element(src.slots + i));
+            }
+            dst.bitmap = src.bitmap;
+            dst.deleted = src.deleted;
+        }
+        size_ = that.size_;
+        growth_left() = that.growth_left();
+    }
+
+    raw_sparse_hash_set(raw_sparse_hash_set&& that) noexcept(
+        std::is_nothrow_copy_constructible<hasher>::value&&
+        std::is_nothrow_copy_constructible<key_equal>::value&&
+        std::is_nothrow_copy_constructible<allocator_type>::value)
+        : groups_(phmap::exchange(that.groups_, nullptr)),
+          size_(phmap::exchange(that.size_, 0)),
+          capacity_(phmap::exchange(that.capacity_, 0)),
+          settings_(std::move(that.settings_)) {
+        that.growth_left() = 0;
+    }
+
+    raw_sparse_hash_set(raw_sparse_hash_set&& that, const allocator_type& a)
+        : settings_(0, that.hash_ref(), that.eq_ref(), a) {
+        if (a == that.alloc_ref()) {
+            swap_storage(that);
+        } else {
+            reserve(that.size());
+            for (auto& elem : that)
+                insert(std::move(elem));
+        }
+    }
+
+    raw_sparse_hash_set& operator=(const raw_sparse_hash_set& that) {
+        raw_sparse_hash_set tmp(that,
+                                AllocTraits::propagate_on_container_copy_assignment::value
+                                ? that.alloc_ref() : alloc_ref());
+        swap(tmp);
+        return *this;
+    }
+
+    raw_sparse_hash_set& operator=(raw_sparse_hash_set&& that) noexcept(
+        phmap::allocator_traits<allocator_type>::is_always_equal::value&&
+        std::is_nothrow_move_assignable<hasher>::value&&
+        std::is_nothrow_move_assignable<key_equal>::value) {
+        raw_sparse_hash_set tmp(std::move(that));
+        swap(tmp);
+        return *this;
+    }
+
+    ~raw_sparse_hash_set() { destroy_slots(); }
+
+    iterator begin() {
+        iterator it(groups_, groups_ + num_groups(), 0);
+        it.skip_empty_groups();
+        return it;
+    }
+    iterator end() { return {groups_ + num_groups(), groups_ + num_groups(), 0}; }
+
+    const_iterator begin() const { return const_cast<raw_sparse_hash_set*>(this)->begin(); }
+    const_iterator end() const   { return const_cast<raw_sparse_hash_set*>(this)->end(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const   { return end(); }
+
+    bool   empty() const    { return !size(); }
+    size_t size() const     { return size_; }
+    size_t capacity() const { return capacity_; }
+    size_t max_size() const { return (std::numeric_limits<uint32_t>::max)() / 2; }
+
+    PHMAP_ATTRIBUTE_REINITIALIZES void clear() {
+        if (empty())
+            return;
+        for (size_t g = 0; g < num_groups(); ++g) {
+            destroy_group(groups_[g]);
+            groups_[g].bitmap = groups_[g].deleted = 0;
+        }
+        size_ = 0;
+        reset_growth_left();
+    }
+
+    template <class T, RequiresInsertable<T> = 0,
+              typename std::enable_if<IsDecomposable<T>::value, int>::type = 0,
+              T* = nullptr>
+    std::pair<iterator, bool> insert(T&& value) {
+        return emplace(std::forward<T>(value));
+    }
+
+    template <class T, RequiresInsertable<T> = 0,
+              typename std::enable_if<IsDecomposable<const T&>::value, int>::type = 0>
+    std::pair<iterator, bool> insert(const T& value) {
+        return emplace(value);
+    }
+
+    std::pair<iterator, bool> insert(init_type&& value) {
+        return emplace(std::move(value));
+    }
+
+    template <class T, RequiresInsertable<T> = 0,
+              typename std::enable_if<IsDecomposable<const T&>::value, int>::type = 0>
+    iterator insert(const_iterator, const T& value) {
+        return insert(value).first;
+    }
+
+    iterator insert(const_iterator, init_type&& value) {
+        return insert(std::move(value)).first;
+    }
+
+    template <class InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first)
+            emplace(*first);
+    }
+
+    template <class T, RequiresNotInit<T> = 0, RequiresInsertable<const T&> = 0>
+    void insert(std::initializer_list<T> ilist) {
+        insert(ilist.begin(), ilist.end());
+    }
+
+    void insert(std::initializer_list<init_type> ilist) {
+        insert(ilist.begin(), ilist.end());
+    }
+
+    template <class... Args, typename std::enable_if<
+                                 IsDecomposable<Args...>::value, int>::type = 0>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        return PolicyTraits::apply(EmplaceDecomposable{*this},
+                                   std::forward<Args>(args)...);
+    }
+
+    // The value is constructed first, and moved into the table or destroyed.
+    template <class... Args, typename std::enable_if<
+                                 !IsDecomposable<Args...>::value, int>::type = 0>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        typename phmap::aligned_storage<sizeof(slot_type), alignof(slot_type)>::type raw;
+        slot_type* slot = reinterpret_cast<slot_type*>(&raw);
+
+        PolicyTraits::construct(&alloc_ref(), slot, std::forward<Args>(args)...);
+        return PolicyTraits::apply(InsertSlot{*this, slot}, PolicyTraits::element(slot));
+    }
+
+    template <class... Args>
+    iterator emplace_hint(const_iterator, Args&&... args) {
+        return emplace(std::forward<Args>(args)...).first;
+    }
+
+    template <class... Args, typename std::enable_if<IsDecomposable<Args...>::value, int>::type = 0>
+    std::pair<iterator, bool> emplace_with_hash(size_t hashval, Args&&... args) {
+        return PolicyTraits::apply(EmplaceDecomposableHashval{*this, hashval},
+                                   std::forward<Args>(args)...);
+    }
+
+    template <class K = key_type, class F>
+    iterator lazy_emplace(const key_arg<K>& key, F&& f) {
+        return lazy_emplace_with_hash(key, this->hash(key), std::forward<F>(f));
+    }
+
+    template <class K = key_type, class F>
+    iterator lazy_emplace_with_hash(const key_arg<K>& key, size_t hashval, F&& f) {
+        size_t offset = _find_key(key, hashval);
+        if (offset == (size_t)-1) {
+            offset = prepare_insert(hashval);
+            lazy_emplace_at(offset, std::forward<F>(f));
+        }
+        return iterator_at(offset);
+    }
+
+    template <class K = key_type, class F>
+    void lazy_emplace_at(size_t& idx, F&& f) {
+        raw_sparse_hash_set* s = this;
+        std::forward<F>(f)(constructor(&s, idx));
+        assert(!s);
+    }
+
+    template <class K = key_type, class F>
+    void emplace_single_with_hash(const key_arg<K>& key, size_t hashval, F&& f) {
+        size_t offset = _find_key(key, hashval);
+        if (offset == (size_t)-1) {
+            offset = prepare_insert(hashval);
+            lazy_emplace_at(offset, std::forward<F>(f));
+        } else
+            _erase(iterator_at(offset));
+    }
+
+    template <class K = key_type>
+    size_type erase(const key_arg<K>& key) {
+        size_t offset = _find_key(key, this->hash(key));
+        if (offset == (size_t)-1) return 0;
+        erase_at(offset);
+        return 1;
+    }
+
+    iterator erase(const_iterator cit) { return erase(cit.inner_); }
+
+    iterator erase(iterator it) {
+        _erase(it++);
+        return it;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        if (first == begin() && last == end()) {
+            clear();
+            return end();
+        }
+        iterator it = first.inner_;
+        while (it != last.inner_)
+            it = erase(it);
+        return it;
+    }
+
+    void _erase(iterator it) {
+        assert(it != end());
+        erase_at(static_cast<size_t>(it.group_ - groups_) * kGroupSize + it.bucket_);
+    }
+    void _erase(const_iterator cit) { _erase(cit.inner_); }
+
+    void swap(raw_sparse_hash_set& that) noexcept(
+        IsNoThrowSwappable<hasher>() && IsNoThrowSwappable<key_equal>() &&
+        (!AllocTraits::propagate_on_container_swap::value ||
+         IsNoThrowSwappable<allocator_type>(typename AllocTraits::propagate_on_container_swap{}))) {
+        using std::swap;
+        swap_storage(that);
+        swap(hash_ref(), that.hash_ref());
+        swap(eq_ref(), that.eq_ref());
+        SwapAlloc(alloc_ref(), that.alloc_ref(), typename AllocTraits::propagate_on_container_swap{});
+    }
+
+    void rehash(size_t n) {
+        if (n == 0 && capacity_ == 0) return;
+        if (n == 0 && size_ == 0) {
+            destroy_slots();
+            return;
+        }
+        auto m = NormalizeBuckets((std::max)(n, 2 * size() + 1));
+        if (n == 0 || m > capacity_)
+            resize(m);
+    }
+
+    void reserve(size_t n) { rehash(2 * n + 1); }
+
+    template <class K = key_type>
+    size_t count(const key_arg<K>& key) const {
+        return find(key) == end() ? size_t(0) : size_t(1);
+    }
+
+    void prefetch_hash(size_t hashval) const {
+        if (!capacity_)
+            return;
+        const SGroup* g = groups_ + (hashval & (capacity_ - 1)) / kGroupSize;
+        (void)g;
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_prefetch((const char *)g, _MM_HINT_NTA);
+#elif defined(__GNUC__)
+        __builtin_prefetch(static_cast<const void*>(g));
+#endif
+    }
+
+    template <class K = key_type>
+    void prefetch(const key_arg<K>& key) const {
+        prefetch_hash(this->hash(key));
+    }
+
+    template <class K = key_type>
+    iterator find(const key_arg<K>& key, size_t hashval) {
+        size_t offset = _find_key(key, hashval);
+        return offset == (size_t)-1 ? end() : iterator_at(offset);
+    }
+
+    template <class K = key_type>
+    iterator find(const key_arg<K>& key) {
+        return find(key, this->hash(key));
+    }
+
+    template <class K = key_type>
+    const_iterator find(const key_arg<K>& key, size_t hashval) const {
+        return const_cast<raw_sparse_hash_set*>(this)->find(key, hashval);
+    }
+
+    template <class K = key_type>
+    const_iterator find(const key_arg<K>& key) const {
+        return find(key, this->hash(key));
+    }
+
+    template <class K = key_type>
+    pointer find_ptr(const key_arg<K>& key, size_t hashval) {
+        size_t offset = _find_key(key, hashval);
+        return offset == (size_t)-1 ? nullptr : &PolicyTraits::element(slot_at(offset));
+    }
+
+    template <class K = key_type>
+    bool contains(const key_arg<K>& key) const {
+        return find(key) != end();
+    }
+
+    template <class K = key_type>
+    bool contains(const key_arg<K>& key, size_t hashval) const {
+        return find(key, hashval) != end();
+    }
+
+    template <class K = key_type>
+    std::pair<iterator, iterator> equal_range(const key_arg<K>& key) {
+        auto it = find(key);
+        if (it != end()) return {it, std::next(it)};
+        return {it, it};
+    }
+
+    template <class K = key_type>
+    std::pair<const_iterator, const_iterator> equal_range(const key_arg<K>& key) const {
+        auto it = find(key);
+        if (it != end()) return {it, std::next(it)};
+        return {it, it};
+    }
+
+    size_t bucket_count() const { return capacity_; }
+    float load_factor() const {
+        return capacity_ ? static_cast<float>(static_cast<double>(size()) / capacity_) : 0.0f;
+    }
+    float max_load_factor() const { return 0.5f; }
+    void max_load_factor(float) {
+        // Does nothing.
+    }
+
+    hasher hash_function() const { return hash_ref(); }
+    key_equal key_eq() const { return eq_ref(); }
+    allocator_type get_allocator() const { return alloc_ref(); }
+
+    // Bytes allocated by the table: groups and element arrays.
+    size_t allocated_bytes() const {
+        return num_groups() * sizeof(SGroup) + size_ * sizeof(slot_type);
+    }
+
+    friend bool operator==(const raw_sparse_hash_set& a, const raw_sparse_hash_set& b) {
+        if (a.size() != b.size()) return false;
+        for (const value_type& elem : a)
+            if (!b.has_element(elem)) return false;
+        return true;
+    }
+
+    friend bool operator!=(const raw_sparse_hash_set& a, const raw_sparse_hash_set& b) {
+        return !(a == b);
+    }
+
+    friend void swap(raw_sparse_hash_set& a,
+                     raw_sparse_hash_set& b) noexcept(noexcept(a.swap(b))) {
+        a.swap(b);
+    }
+
+    template <class K>
+    size_t hash(const K& key) const {
+        return HashElement{hash_ref()}(key);
+    }
+
+private:
+    struct HashElement
+    {
+        template <class K, class... Args>
+        size_t operator()(const K& key, Args&&...) const {
+#if PHMAP_DISABLE_MIX
+            return h(key);
+#else
+            return phmap_mix<sizeof(size_t)>()(h(key));
+#endif
+        }
+        const hasher& h;
+    };
+
+    template <class K1>
+    struct EqualElement
+    {
+        template <class K2, class... Args>
+        bool operator()(const K2& lhs, Args&&...) const {
+            return eq(lhs, rhs);
+        }
+        const K1& rhs;
+        const key_equal& eq;
+    };
+
+    template <class K, class... Args>
+    std::pair<iterator, bool> emplace_decomposable(const K& key, size_t hashval,
+                                                   Args&&... args) {
+        size_t offset = _find_key(key, hashval);
+        if (offset == (size_t)-1) {
+            offset = prepare_insert(hashval);
+            emplace_at(offset, std::forward<Args>(args)...);
+            return {iterator_at(offset), true};
+        }
+        return {iterator_at(offset), false};
+    }
+
+    struct EmplaceDecomposable
+    {
+        template <class K, class... Args>
+        std::pair<iterator, bool> operator()(const K& key, Args&&... args) const {
+            return s.emplace_decomposable(key, s.hash(key), std::forward<Args>(args)...);
+        }
+        raw_sparse_hash_set& s;
+    };
+
+    struct EmplaceDecomposableHashval
+    {
+        template <class K, class... Args>
+        std::pair<iterator, bool> operator()(const K& key, Args&&... args) const {
+            return s.emplace_decomposable(key, hashval, std::forward<Args>(args)...);
+        }
+        raw_sparse_hash_set& s;
+        size_t hashval;
+    };
+
+    // Moves the constructed `slot` into the table, or destroys it if its key is
+    // already present.
+    struct InsertSlot
+    {
+        template <class K, class... Args>
+        std::pair<iterator, bool> operator()(const K& key, Args&&...) const {
+            size_t hashval = s.hash(key);
+            size_t offset = s._find_key(key, hashval);
+            if (offset != (size_t)-1) {
+                PolicyTraits::destroy(&s.alloc_ref(), slot);
+                return {s.iterator_at(offset), false};
+            }
+            offset = s.prepare_insert(hashval);
+            PolicyTraits::transfer(&s.alloc_ref(), s.make_hole(offset), slot);
+            return {s.iterator_at(offset), true};
+        }
+        raw_sparse_hash_set& s;
+        slot_type* slot;
+    };
+
+    size_t num_groups() const { return capacity_ / kGroupSize; }
+
+    SGroup& group_of(size_t pos) const { return groups_[pos / kGroupSize]; }
+
+    // PRECONDITION: bucket `pos` is occupied
+    slot_type* slot_at(size_t pos) const {
+        const SGroup& g = group_of(pos);
+        return g.slots + g.rank(pos % kGroupSize);
+    }
+
+    slot_type* allocate_slots(size_t n) {
+        SlotAlloc slot_alloc(alloc_ref());
+        return SlotAllocTraits::allocate(slot_alloc, n);
+    }
+
+    void deallocate_slots(slot_type* slots, size_t n) {
+        SlotAlloc slot_alloc(alloc_ref());
+        SlotAllocTraits::deallocate(slot_alloc, slots, n);
+    }
+
+    void allocate_groups(size_t buckets) {
+        GroupAlloc group_alloc(alloc_ref());
+        capacity_ = buckets;
+        groups_ = GroupAllocTraits::allocate(group_alloc, num_groups());
+        for (size_t g = 0; g < num_groups(); ++g)
+            GroupAllocTraits::construct(group_alloc, groups_ + g);
+    }
+
+    void deallocate_groups(SGroup* groups, size_t n) {
+        GroupAlloc group_alloc(alloc_ref());
+        GroupAllocTraits::deallocate(group_alloc, groups, n);
+    }
+
+    void destroy_group(SGroup& g) {
+        uint32_t n = g.size();
+        if (!n)
+            return;
+        for (uint32_t i = 0; i < n; ++i)
+            PolicyTraits::destroy(&alloc_ref(), g.slots + i);
+        deallocate_slots(g.slots, n);
+        g.slots = nullptr;
+    }
+
+    // Reallocates the group of the empty bucket `pos` with one more slot, marks
+    // the bucket as occupied and returns its (unconstructed) slot.
+    slot_type* make_hole(size_t pos) {
+        SGroup& g = group_of(pos);
+        size_t b = pos % kGroupSize;
+        uint32_t n = g.size();
+        uint32_t r = g.rank(b);
+        slot_type* slots = allocate_slots(n + 1);
+        for (uint32_t i = 0; i < r; ++i)
+            PolicyTraits::transfer(&alloc_ref(), slots + i, g.slots + i);
+        for (uint32_t i = r; i < n; ++i)
+            PolicyTraits::transfer(&alloc_ref(), slots + i + 1, g.slots + i);
+        if (n)
+            deallocate_slots(g.slots, n);
+        g.slots = slots;
+        g.bitmap |= uint64_t(1) << b;
+        g.deleted &= ~(uint64_t(1) << b);
+        return slots + r;
+    }
+
+    // Destroys the element of bucket `pos`, and leaves a tombstone.
+    void erase_at(size_t pos) {
+        SGroup& g = group_of(pos);
+        size_t b = pos % kGroupSize;
+        assert(g.occupied(b) && "erasing a dangling iterator");
+        uint32_t n = g.size();
+        uint32_t r = g.rank(b);
+        PolicyTraits::destroy(&alloc_ref(), g.slots + r);
+        slot_type* slots = nullptr;
+        if (n > 1) {
+            slots = allocate_slots(n - 1);
+            for (uint32_t i = 0; i < r; ++i)
+                PolicyTraits::transfer(&alloc_ref(), slots + i, g.slots + i);
+            for (uint32_t i = r + 1; i < n; ++i)
+                PolicyTraits::transfer(&alloc_ref(), slots + i - 1, g.slots + i);
+        }
+        deallocate_slots(g.slots, n);
+        g.slots = slots;
+        g.bitmap &= ~(uint64_t(1) << b);
+        g.deleted |= uint64_t(1) << b;
+        --size_;
+    }
+
+    void destroy_slots() {
+        if (!capacity_)
+            return;
+        for (size_t g = 0; g < num_groups(); ++g)
+            destroy_group(groups_[g]);
+        deallocate_groups(groups_, num_groups());
+        groups_ = nullptr;
+        size_ = 0;
+        capacity_ = 0;
+        growth_left() = 0;
+    }
+
+    // Moves all elements into a table of `new_capacity` buckets, which also
+    // drops the tombstones. The buckets of all elements are computed first, so
+    // that each group is allocated once to its final size.
+    void resize(size_t new_capacity) {
+        assert(new_capacity >= kGroupSize && (new_capacity & (new_capacity - 1)) == 0);
+        SGroup* old_groups = groups_;
+        const size_t old_num_groups = num_groups();
+        allocate_groups(new_capacity);
+
+        PosAlloc pos_alloc(alloc_ref());
+        uint32_t* positions = size_ ? PosAllocTraits::allocate(pos_alloc, size_) : nullptr;
+        size_t n = 0;
+        for (size_t g = 0; g < old_num_groups; ++g) {
+            const SGroup& src = old_groups[g];
+            for (uint32_t i = 0, cnt = src.size(); i < cnt; ++i) {
+                size_t hashval = PolicyTraits::apply(HashElement{hash_ref()},
+                                                     PolicyTraits::element(src.slots + i));
+                size_t pos = find_first_non_full(hashval);
+                group_of(pos).bitmap |= uint64_t(1) << (pos % kGroupSize);
+                positions[n++] = static_cast<uint32_t>(pos);
+            }
+        }
+
+        for (size_t g = 0; g < num_groups(); ++g)
+            if (groups_[g].bitmap)
+                groups_[g].slots = allocate_slots(groups_[g].size());
+
+        n = 0;
+        for (size_t g = 0; g < old_num_groups; ++g) {
+            SGroup& src = old_groups[g];
+            uint32_t cnt = src.size();
+            for (uint32_t i = 0; i < cnt; ++i)
+                PolicyTraits::transfer(&alloc_ref(), slot_at(positions[n++]), src.slots + i);
+            if (cnt)
+                deallocate_slots(src.slots, cnt);
+        }
+        if (positions)
+            PosAllocTraits::deallocate(pos_alloc, positions, size_);
+        if (old_groups)
+            deallocate_groups(old_groups, old_num_groups);
+        reset_growth_left();
+    }
+
+    void drop_deletes_without_resize() { resize(capacity_); }
+
+    void rehash_and_grow_if_necessary() {
+        if (capacity_ == 0) {
+            resize(kGroupSize);
+        } else if (size() <= BucketsToGrowth(capacity_) / 2) {
+            drop_deletes_without_resize();
+        } else {
+            resize(capacity_ * 2);
+        }
+    }
+
+    bool has_element(const value_type& elem, size_t hashval) const {
+        if (!capacity_)
+            return false;
+        const size_t mask = capacity_ - 1;
+        size_t pos = hashval & mask;
+        for (size_t i = 1; ; ++i) {
+            const SGroup& g = group_of(pos);
+            size_t b = pos % kGroupSize;
+            if (g.occupied(b)) {
+                if (PolicyTraits::element(g.slots + g.rank(b)) == elem)
+                    return true;
+            } else if (!g.is_deleted(b)) {
+                return false;
+            }
+            pos = (pos + i) & mask;
+        }
+    }
+
+    bool has_element(const value_type& elem) const {
+        size_t hashval = PolicyTraits::apply(HashElement{hash_ref()}, elem);
+        return has_element(elem, hashval);
+    }
+
+    // first bucket which is empty or deleted on the probe sequence of `hashval`
+    size_t find_first_non_full(size_t hashval) const {
+        const size_t mask = capacity_ - 1;
+        size_t pos = hashval & mask;
+        for (size_t i = 1; group_of(pos).occupied(pos % kGroupSize); ++i) {
+            assert(i <= capacity_ && "full table!");
+            pos = (pos + i) & mask;
+        }
+        return pos;
+    }
+
+    void swap_storage(raw_sparse_hash_set& that) {
+        using std::swap;
+        swap(groups_, that.groups_);
+        swap(size_, that.size_);
+        swap(capacity_, that.capacity_);
+        swap(growth_left(), that.growth_left());
+    }
+
+protected:
+    template <class K>
+    size_t _find_key(const K& key, size_t hashval) {
+        if (!capacity_)
+            return (size_t)-1;
+        const size_t mask = capacity_ - 1;
+        size_t pos = hashval & mask;
+        for (size_t i = 1; ; ++i) {
+            const SGroup& g = group_of(pos);
+            size_t b = pos % kGroupSize;
+            if (g.occupied(b)) {
+                if (PHMAP_PREDICT_TRUE(PolicyTraits::apply(
+                        EqualElement<K>{key, eq_ref()},
+                        PolicyTraits::element(g.slots + g.rank(b)))))
+                    return pos;
+            } else if (!g.is_deleted(b)) {
+                return (size_t)-1;
+            }
+            pos = (pos + i) & mask;
+        }
+    }
+
+    template <class K>
+    std::pair<size_t, bool> find_or_prepare_insert(const K& key, size_t hashval) {
+        size_t offset = _find_key(key, hashval);
+        if (offset == (size_t)-1)
+            return {prepare_insert(hashval), true};
+        return {offset, false};
+    }
+
+    size_t prepare_insert(size_t hashval) PHMAP_ATTRIBUTE_NOINLINE {
+        if (!capacity_)
+            rehash_and_grow_if_necessary();
+        size_t target = find_first_non_full(hashval);
+        if (PHMAP_PREDICT_FALSE(growth_left() == 0 &&
+                                !group_of(target).is_deleted(target % kGroupSize))) {
+            rehash_and_grow_if_necessary();
+            target = find_first_non_full(hashval);
+        }
+        ++size_;
+        growth_left() -= !group_of(target).is_deleted(target % kGroupSize);
+        return target;
+    }
+
+    // PRECONDITION: i is an index returned from prepare_insert().
+    template <class... Args>
+    void emplace_at(size_t i, Args&&... args) {
+        // construct into a temporary slot first, so that the table is unchanged
+        // if the constructor throws.
+        typename phmap::aligned_storage<sizeof(slot_type), alignof(slot_type)>::type raw;
+        slot_type* slot = reinterpret_cast<slot_type*>(&raw);
+        PHMAP_INTERNAL_TRY {
+            PolicyTraits::construct(&alloc_ref(), slot, std::forward<Args>(args)...);
+        }
+        PHMAP_INTERNAL_CATCH_ANY {
+            --size_;
+            growth_left() += !group_of(i).is_deleted(i % kGroupSize);
+            PHMAP_INTERNAL_RETHROW;
+        }
+        PolicyTraits::transfer(&alloc_ref(), make_hole(i), slot);
+    }
+
+    iterator iterator_at(size_t i) {
+        return {&group_of(i), groups_ + num_groups(), i % kGroupSize};
+    }
+    const_iterator iterator_at(size_t i) const {
+        return const_cast<raw_sparse_hash_set*>(this)->iterator_at(i);
+    }
+
+    // the bucket was marked as occupied by emplace_at()
+    void set_ctrl(size_t, ctrl_t) {}
+
+private:
+    template <size_t N,
+              template <class, class, class, class> class RefSet,
+              class M, class P, class H, class E, class A>
+    friend class parallel_hash_set;
+
+    template <size_t N,
+              template <class, class, class, class> class RefSet,
+              class M, class P, class H, class E, class A>
+    friend class parallel_hash_map;
+
+    void reset_growth_left() {
+        growth_left() = BucketsToGrowth(capacity_) - size_;
+    }
+
+    size_t& growth_left() { return std::get<0>(settings_); }
+    const size_t& growth_left() const { return std::get<0>(settings_); }
+
+    hasher& hash_ref() { return std::get<1>(settings_); }
+    const hasher& hash_ref() const { return std::get<1>(settings_); }
+    key_equal& eq_ref() { return std::get<2>(settings_); }
+    const key_equal& eq_ref() const { return std::get<2>(settings_); }
+    allocator_type& alloc_ref() { return std::get<3>(settings_); }
+    const allocator_type& alloc_ref() const { return std::get<3>(settings_); }
+
+    SGroup* groups_ = nullptr;       // [capacity / 64]
+    size_t  size_ = 0;               // number of elements
+    size_t  capacity_ = 0;           // number of buckets
+    std::tuple<size_t /* growth_left */, hasher, key_equal, allocator_type>
+        settings_{0, hasher{}, key_equal{}, allocator_type{}};
+};
+
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+template <class Policy, class Hash, class Eq, class Alloc>
+class raw_sparse_hash_map : public raw_sparse_hash_set<Policy, Hash, Eq, Alloc>
+{
+    template <class P>
+    using MappedReference = decltype(P::value(
+               std::addressof(std::declval<typename raw_sparse_hash_map::reference>())));
+
+    template <class P>
+    using MappedConstReference = decltype(P::value(
+               std::addressof(std::declval<typename raw_sparse_hash_map::const_reference>())));
+
+    using KeyArgImpl =
+        KeyArg<IsTransparent<Eq>::value && IsTransparent<Hash>::value>;
+
+    using Base = raw_sparse_hash_set<Policy, Hash, Eq, Alloc>;
+
+public:
+    using key_type = typename Policy::key_type;
+    using mapped_type = typename Policy::mapped_type;
+    template <class K>
+    using key_arg = typename KeyArgImpl::template type<K, key_type>;
+
+    using iterator = typename Base::iterator;
+    using const_iterator = typename Base::const_iterator;
+
+    raw_sparse_hash_map() {}
+    using Base::raw_sparse_hash_set;
+
+    template <class K = key_type, class V = mapped_type, K* = nullptr, V* = nullptr>
+    std::pair<iterator, bool> insert_or_assign(key_arg<K>&& k, V&& v) {
+        return insert_or_assign_impl(std::forward<K>(k), std::forward<V>(v));
+    }
+
+    template <class K = key_type, class V = mapped_type, K* = nullptr>
+    std::pair<iterator, bool> insert_or_assign(key_arg<K>&& k, const V& v) {
+        return insert_or_assign_impl(std::forward<K>(k), v);
+    }
+
+    template <class K = key_type, class V = mapped_type, V* = nullptr>
+    std::pair<iterator, bool> insert_or_assign(const key_arg<K>& k, V&& v) {
+        return insert_or_assign_impl(k, std::forward<V>(v));
+    }
+
+    template <class K = key_type, class V = mapped_type>
+    std::pair<iterator, bool> insert_or_assign(const key_arg<K>& k, const V& v) {
+        return insert_or_assign_impl(k, v);
+    }
+
+    template <class K = key_type, class... Args,
+              typename std::enable_if<
+                  !std::is_convertible<K, const_iterator>::value, int>::type = 0,
+              K* = nullptr>
+    std::pair<iterator, bool> try_emplace(key_arg<K>&& k, Args&&... args) {
+        return try_emplace_impl(std::forward<K>(k), std::forward<Args>(args)...);
+    }
+
+    template <class K = key_type, class... Args,
+              typename std::enable_if<
+                  !std::is_convertible<K, const_iterator>::value, int>::type = 0>
+    std::pair<iterator, bool> try_emplace(const key_arg<K>& k, Args&&... args) {
+        return try_emplace_impl(k, std::forward<Args>(args)...);
+    }
+
+    template <class K = key_type, class... Args>
+    iterator try_emplace(const_iterator, const key_arg<K>& k, Args&&... args) {
+        return try_emplace(k, std::forward<Args>(args)...).first;
+    }
+
+    template <class K = key_type, class P = Policy>
+    MappedReference<P> at(const key_arg<K>& key) {
+        auto it = this->find(key);
+        if (it == this->end())
+            phmap::base_internal::ThrowStdOutOfRange("phmap at(): lookup non-existent key");
+        return Policy::value(&*it);
+    }
+
+    template <class K = key_type, class P = Policy>
+    MappedConstReference<P> at(const key_arg<K>& key) const {
+        auto it = this->find(key);
+        if (it == this->end())
+            phmap::base_internal::ThrowStdOutOfRange("phmap at(): lookup non-existent key");
+        return Policy::value(&*it);
+    }
+
+    template <class K = key_type, class P = Policy, K* = nullptr>
+    MappedReference<P> operator[](key_arg<K>&& key) {
+        return Policy::value(&*try_emplace(std::forward<K>(key)).first);
+    }
+
+    template <class K = key_type, class P = Policy>
+    MappedReference<P> operator[](const key_arg<K>& key) {
+        return Policy::value(&*try_emplace(key).first);
+    }
+
+private:
+    template <class K, class V>
+    std::pair<iterator, bool> insert_or_assign_impl(K&& k, V&& v) {
+        size_t hashval = this->hash(k);
+        size_t offset = this->_find_key(k, hashval);
+        if (offset == (size_t)-1) {
+            offset = this->prepare_insert(hashval);
+            this->emplace_at(offset, std::forward<K>(k), std::forward<V>(v));
+            return {this->iterator_at(offset), true};
+        }
+        Policy::value(&*this->iterator_at(offset)) = std::forward<V>(v);
+        return {this->iterator_at(offset), false};
+    }
+
+    template <class K = key_type, class... Args>
+    std::pair<iterator, bool> try_emplace_impl(K&& k, Args&&... args) {
+        size_t hashval = this->hash(k);
+        size_t offset = this->_find_key(k, hashval);
+        if (offset == (size_t)-1) {
+            offset = this->prepare_insert(hashval);
+            this->emplace_at(offset, std::piecewise_construct,
+                             std::forward_as_tuple(std::forward<K>(k)),
+                             std::forward_as_tuple(std::forward<Args>(args)...));
+            return {this->iterator_at(offset), true};
+        }
+        return {this->iterator_at(offset), false};
+    }
+};
+
+}  // namespace priv
+
+// -----------------------------------------------------------------------------
+// phmap::sparse_hash_set
+// -----------------------------------------------------------------------------
+// Same interface as `phmap::flat_hash_set`, with a much lower memory overhead
+// per bucket, but slower insertions and erasures (see implementation details
+// above).
+// -----------------------------------------------------------------------------
+template <class T, class Hash, class Eq, class Alloc> // default values in phmap_fwd_decl.h
+class sparse_hash_set
+    : public phmap::priv::raw_sparse_hash_set<
+          phmap::priv::FlatHashSetPolicy<T>, Hash, Eq, Alloc>
+{
+    using Base = typename sparse_hash_set::raw_sparse_hash_set;
+
+public:
+    sparse_hash_set() {}
+    using Base::Base;
+    using Base::begin;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::end;
+    using Base::capacity;
+    using Base::empty;
+    using Base::max_size;
+    using Base::size;
+    using Base::clear;
+    using Base::erase;
+    using Base::insert;
+    using Base::emplace;
+    using Base::emplace_hint;
+    using Base::swap;
+    using Base::rehash;
+    using Base::reserve;
+    using Base::contains;
+    using Base::count;
+    using Base::equal_range;
+    using Base::find;
+    using Base::bucket_count;
+    using Base::load_factor;
+    using Base::max_load_factor;
+    using Base::get_allocator;
+    using Base::hash_function;
+    using Base::hash;
+    using Base::key_eq;
+};
+
+// -----------------------------------------------------------------------------
+// phmap::sparse_hash_map
+// -----------------------------------------------------------------------------
+// Same interface as `phmap::flat_hash_map`, with a much lower memory overhead
+// per bucket, but slower insertions and erasures (see implementation details
+// above).
+// -----------------------------------------------------------------------------
+template <class Key, class Value, class Hash, class Eq, class Alloc> // default values in phmap_fwd_decl.h
+class sparse_hash_map
+    : public phmap::priv::raw_sparse_hash_map<
+          phmap::priv::FlatHashMapPolicy<Key, Value>, Hash, Eq, Alloc>
+{
+    using Base = typename sparse_hash_map::raw_sparse_hash_map;
+
+public:
+    sparse_hash_map() {}
+    using Base::Base;
+    using Base::begin;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::end;
+    using Base::capacity;
+    using Base::empty;
+    using Base::max_size;
+    using Base::size;
+    using Base::clear;
+    using Base::erase;
+    using Base::insert;
+    using Base::insert_or_assign;
+    using Base::emplace;
+    using Base::emplace_hint;
+    using Base::try_emplace;
+    using Base::swap;
+    using Base::rehash;
+    using Base::reserve;
+    using Base::at;
+    using Base::contains;
+    using Base::count;
+    using Base::equal_range;
+    using Base::find;
+    using Base::operator[];
+    using Base::bucket_count;
+    using Base::load_factor;
+    using Base::max_load_factor;
+    using Base::get_allocator;
+    using Base::hash_function;
+    using Base::hash;
+    using Base::key_eq;
+};
+
+// -----------------------------------------------------------------------------
+// phmap::parallel_sparse_hash_set
+// -----------------------------------------------------------------------------
+template <class T, class Hash, class Eq, class Alloc, size_t N, class Mtx_> // default values in phmap_fwd_decl.h
+class parallel_sparse_hash_set
+    : public phmap::priv::parallel_hash_set<
+             N, phmap::priv::raw_sparse_hash_set, Mtx_,
+             phmap::priv::FlatHashSetPolicy<T>, Hash, Eq, Alloc>
+{
+    using Base = typename parallel_sparse_hash_set::parallel_hash_set;
+
+public:
+    parallel_sparse_hash_set() {}
+    using Base::Base;
+    using Base::hash;
+    using Base::subidx;
+    using Base::subcnt;
+    using Base::begin;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::end;
+    using Base::capacity;
+    using Base::empty;
+    using Base::max_size;
+    using Base::size;
+    using Base::clear;
+    using Base::erase;
+    using Base::insert;
+    using Base::emplace;
+    using Base::emplace_hint;
+    using Base::emplace_with_hash;
+    using Base::emplace_hint_with_hash;
+    using Base::swap;
+    using Base::rehash;
+    using Base::reserve;
+    using Base::contains;
+    using Base::count;
+    using Base::equal_range;
+    using Base::find;
+    using Base::bucket_count;
+    using Base::load_factor;
+    using Base::max_load_factor;
+    using Base::get_allocator;
+    using Base::hash_function;
+    using Base::key_eq;
+};
+
+// -----------------------------------------------------------------------------
+// phmap::parallel_sparse_hash_map
+// -----------------------------------------------------------------------------
+template <class Key, class Value, class Hash, class Eq, class Alloc, size_t N, class Mtx_> // default values in phmap_fwd_decl.h
+class parallel_sparse_hash_map
+    : public phmap::priv::parallel_hash_map<
+          N, phmap::priv::raw_sparse_hash_set, Mtx_,
+          phmap::priv::FlatHashMapPolicy<Key, Value>, Hash, Eq, Alloc>
+{
+    using Base = typename parallel_sparse_hash_map::parallel_hash_map;
+
+public:
+    parallel_sparse_hash_map() {}
+    using Base::Base;
+    using Base::hash;
+    using Base::subidx;
+    using Base::subcnt;
+    using Base::begin;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::end;
+    using Base::capacity;
+    using Base::empty;
+    using Base::max_size;
+    using Base::size;
+    using Base::clear;
+    using Base::erase;
+    using Base::insert;
+    using Base::insert_or_assign;
+    using Base::emplace;
+    using Base::emplace_hint;
+    using Base::try_emplace;
+    using Base::emplace_with_hash;
+    using Base::emplace_hint_with_hash;
+    using Base::try_emplace_with_hash;
+    using Base::swap;
+    using Base::rehash;
+    using Base::reserve;
+    using Base::at;
+    using Base::contains;
+    using Base::count;
+    using Base::equal_range;
+    using Base::find;
+    using Base::operator[];
+    using Base::bucket_count;
+    using Base::load_factor;
+    using Base::max_load_factor;
+    using Base::get_allocator;
+    using Base::hash_function;
+    using Base::key_eq;
+};
+
+// ======== erase_if for sparse containers =====================================
+template <class T, class Hash, class Eq, class Alloc, class Pred>
+std::size_t erase_if(phmap::sparse_hash_set<T, Hash, Eq, Alloc>& c, Pred pred) {
+    return phmap::priv::erase_if(c, std::move(pred));
+}
+
+template <class K, class V, class Hash, class Eq, class Alloc, class Pred>
+std::size_t erase_if(phmap::sparse_hash_map<K, V, Hash, Eq, Alloc>& c, Pred pred) {
+    return phmap::priv::erase_if(c, std::move(pred));
+}
+
+template <class T, class Hash, class Eq, class Alloc, size_t N, class Mtx_, class Pred>
+std::size_t erase_if(phmap::parallel_sparse_hash_set<T, Hash, Eq, Alloc, N, Mtx_>& c, Pred pred) {
+    return phmap::priv::erase_if(c, std::move(pred));
+}
+
+template <class K, class V, class Hash, class Eq, class Alloc, size_t N, class Mtx_, class Pred>
+std::size_t erase_if(phmap::parallel_sparse_hash_map<K, V, Hash, Eq, Alloc, N, Mtx_>& c, Pred pred) {
+    return phmap::priv::erase_if(c, std::move(pred));
+}
+
+}  // namespace phmap
+
+#endif // phmap_sparse_h_guard_
@@ -0,0 +1,294 @@
+#if !defined(phmap_static_h_guard_)
+#define phmap_static_h_guard_
+
+// ---------------------------------------------------------------------------
+// Copyright (c) 2019, Gregory Popovitch - greg7mdp@gmail.com
+//
+//       hash map constructed at compile time
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+// phmap::static_flat_map<K, V, N> is an immutable map of N elements, meant for
+// keyword tables, enum-from-string parsing or opcode maps:
+//
+//    constexpr auto keywords = phmap::make_static_flat_map<std::string_view, int>({
+//        {"if", 1}, {"else", 2}, {"while", 3} });
+//    static_assert(keywords.at("else") == 2, "");
+//
+// When declared `constexpr`, the map is built by the compiler: there is no
+// construction nor allocation at runtime, and the data is in read-only memory.
+//
+// The table is a perfect hash (hash and displace): the keys are split in
+// buckets by a first hash, and each bucket stores either the slot of its only
+// key, or the seed (pilot) of a second hash which sends its keys to distinct
+// free slots. A lookup computes at most two hashes and compares a single key.
+//
+// The hash is `phmap::StaticHash<K>` (integers, enums, and std::string_view in
+// C++17), which can be specialized for other literal types. It must be a
+// `constexpr` function of the key and a 64 bit seed. The compile time cost
+// grows with N, so very large tables may need a higher constexpr evaluation
+// limit from the compiler (-fconstexpr-ops-limit or -fconstexpr-steps).
+//
+// Requires C++14.
+// ---------------------------------------------------------------------------
+
+#include "phmap.h"
+
+#if PHMAP_HAVE_CC14
+
+namespace phmap {
+
+namespace priv {
+
+// constexpr equivalent of phmap_mix<8> (umul128 version): the high and low
+// halves of the 128 bit product are computed with 64 bit multiplications.
+constexpr uint64_t static_mix(uint64_t a) {
+    constexpr uint64_t k = 0xde5fb9d2630458e9ULL;
+    uint64_t lo_lo = (a & 0xffffffff) * (k & 0xffffffff);
+    uint64_t hi_lo = (a >> 32) * (k & 0xffffffff);
+    uint64_t lo_hi = (a & 0xffffffff) * (k >> 32);
+    uint64_t hi_hi = (a >> 32) * (k >> 32);
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffff) + lo_hi;
+    uint64_t hi = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    uint64_t lo = (cross << 32) | (lo_lo & 0xffffffff);
+    return hi + lo;
+}
+
+// FNV-1a of `n` bytes, with the seed xor'ed into the offset basis.
+constexpr uint64_t static_hash_bytes(const char* p, size_t n, uint64_t seed) {
+    uint64_t h = 0xcbf29ce484222325ULL ^ seed;
+    for (size_t i = 0; i < n; ++i) {
+        h ^= static_cast<unsigned char>(p[i]);
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+}  // namespace priv
+
+// -----------------------------------------------------------------------------
+// constexpr seeded hash, for integers and enums by default
+// -----------------------------------------------------------------------------
+template <class T>
+struct StaticHash
+{
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value,
+                  "phmap::StaticHash<T> must be specialized for this key type");
+
+    constexpr uint64_t operator()(const T& v, uint64_t seed) const {
+        return priv::static_mix(static_cast<uint64_t>(v) + seed * 0x9e3779b97f4a7c15ULL);
+    }
+};
+
+#if PHMAP_HAVE_STD_STRING_VIEW
+template <>
+struct StaticHash<std::string_view>
+{
+    constexpr uint64_t operator()(std::string_view v, uint64_t seed) const {
+        return priv::static_mix(priv::static_hash_bytes(v.data(), v.size(), seed));
+    }
+};
+#endif
+
+template <class T>
+struct StaticEqualTo
+{
+    constexpr bool operator()(const T& a, const T& b) const { return a == b; }
+};
+
+// -----------------------------------------------------------------------------
+// phmap::static_flat_map
+// -----------------------------------------------------------------------------
+template <class K, class V, size_t N, class Hash, class Eq> // default values in phmap_fwd_decl.h
+class static_flat_map
+{
+    static_assert(N > 0, "static_flat_map must have at least one element");
+
+    // number of slots and of buckets: power of 2 >= N
+    static constexpr size_t NormalizeSlots(size_t n) {
+        size_t res = 1;
+        while (res < n)
+            res *= 2;
+        return res;
+    }
+
+    static constexpr size_t   kSlots    = NormalizeSlots(N);
+    static constexpr uint64_t kMask     = kSlots - 1;
+    static constexpr uint32_t kEmpty    = static_cast<uint32_t>(N);
+    static constexpr int32_t  kMaxPilot = 1 << 20;
+
+public:
+    using key_type        = K;
+    using mapped_type     = V;
+    using value_type      = std::pair<K, V>;
+    using size_type       = size_t;
+    using difference_type = ptrdiff_t;
+    using hasher          = Hash;
+    using key_equal       = Eq;
+    using reference       = const value_type&;
+    using const_reference = const value_type&;
+    using pointer         = const value_type*;
+    using const_pointer   = const value_type*;
+    using iterator        = const value_type*;
+    using const_iterator  = const value_type*;
+
+    // Elements are kept in the order of `items`. Throws std::invalid_argument
+    // (a compile error in a constant expression) on duplicate keys.
+    constexpr static_flat_map(const value_type (&items)[N], const hasher& hashfn = hasher(),
+                              const key_equal& eq = key_equal()) :
+        static_flat_map(items, phmap::make_index_sequence<N>(), hashfn, eq) {}
+
+    constexpr const_iterator begin() const  { return items_; }
+    constexpr const_iterator end() const    { return items_ + N; }
+    constexpr const_iterator cbegin() const { return begin(); }
+    constexpr const_iterator cend() const   { return end(); }
+
+    constexpr bool      empty() const        { return false; }
+    constexpr size_type size() const         { return N; }
+    constexpr size_type max_size() const     { return N; }
+    constexpr size_type bucket_count() const { return kSlots; }
+
+    constexpr hasher    hash_function() const { return hash_; }
+    constexpr key_equal key_eq() const        { return eq_; }
+
+    constexpr const_iterator find(const key_type& key) const {
+        uint32_t i = slots_[slot_of(key)];
+        return i != kEmpty && eq_(items_[i].first, key) ? items_ + i : end();
+    }
+
+    constexpr bool contains(const key_type& key) const { return find(key) != end(); }
+    constexpr size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+    constexpr std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+        const_iterator it = find(key);
+        return {it, it == end() ? it : it + 1};
+    }
+
+    constexpr const mapped_type& at(const key_type& key) const {
+        const_iterator it = find(key);
+        if (it == end())
+            phmap::base_internal::ThrowStdOutOfRange("phmap at(): lookup non-existent key");
+        return it->second;
+    }
+
+private:
+    template <size_t... I>
+    constexpr static_flat_map(const value_type (&items)[N], phmap::index_sequence<I...>,
+                              const hasher& hashfn, const key_equal& eq) :
+        items_{items[I]...}, hash_(hashfn), eq_(eq) {
+        while (!build())
+            ++seed_;
+    }
+
+    constexpr size_t bucket_of(const key_type& key) const {
+        return static_cast<size_t>(hash_(key, seed_) & kMask);
+    }
+
+    constexpr size_t slot_of(const key_type& key) const {
+        int32_t pilot = pilots_[bucket_of(key)];
+        return pilot < 0 ? static_cast<size_t>(-(pilot + 1))
+                         : static_cast<size_t>(hash_(key, static_cast<uint64_t>(pilot)) & kMask);
+    }
+
+    // Places all the keys with `seed_`, starting with the largest buckets.
+    // Returns false if a bucket could not be placed (try another seed).
+    constexpr bool build() {
+        size_t bucket_size[kSlots] = {};
+        size_t buckets[N] = {};
+        size_t max_bucket_size = 0;
+        for (size_t i = 0; i < N; ++i) {
+            buckets[i] = bucket_of(items_[i].first);
+            max_bucket_size = (std::max)(max_bucket_size, ++bucket_size[buckets[i]]);
+        }
+        for (size_t s = 0; s < kSlots; ++s) {
+            slots_[s] = kEmpty;
+            pilots_[s] = 0;
+        }
+
+        uint32_t keys[N] = {};
+        size_t   placed[N] = {};
+        for (size_t sz = max_bucket_size; sz > 1; --sz) {
+            for (size_t b = 0; b < kSlots; ++b) {
+                if (bucket_size[b] != sz)
+                    continue;
+                size_t n = 0;
+                for (size_t i = 0; i < N; ++i) {
+                    if (buckets[i] != b)
+                        continue;
+                    for (size_t j = 0; j < n; ++j)
+                        if (eq_(items_[keys[j]].first, items_[i].first))
+                            phmap::base_internal::ThrowStdInvalidArgument(
+                                "phmap static_flat_map: duplicate key");
+                    keys[n++] = static_cast<uint32_t>(i);
+                }
+
+                int32_t pilot = 1;
+                for (; pilot < kMaxPilot; ++pilot) {
+                    size_t j = 0;
+                    for (; j < n; ++j) {
+                        size_t s = static_cast<size_t>(
+                            hash_(items_[keys[j]].first, static_cast<uint64_t>(pilot)) & kMask);
+                        if (slots_[s] != kEmpty)
+                            break;
+                        slots_[s] = keys[j];
+                        placed[j] = s;
+                    }
+                    if (j == n)
+                        break;
+                    while (j--)             // undo the partial placement
+                        slots_[placed[j]] = kEmpty;
+                }
+                if (pilot == kMaxPilot)
+                    return false;
+                pilots_[b] = pilot;
+            }
+        }
+
+        // buckets of one key point directly to a free slot
+        size_t free_slot = 0;
+        for (size_t i = 0; i < N; ++i) {
+            if (bucket_size[buckets[i]] != 1)
+                continue;
+            while (slots_[free_slot] != kEmpty)
+                ++free_slot;
+            slots_[free_slot] = static_cast<uint32_t>(i);
+            pilots_[buckets[i]] = -static_cast<int32_t>(free_slot) - 1;
+        }
+        return true;
+    }
+
+    value_type items_[N];
+    int32_t    pilots_[kSlots] = {};   // < 0: -(slot + 1), otherwise seed of the slot hash
+    uint32_t   slots_[kSlots] = {};    // index in items_, or kEmpty
+    uint64_t   seed_ = 0;              // seed of the bucket hash
+    hasher     hash_;
+    key_equal  eq_;
+};
+
+// -----------------------------------------------------------------------------
+// Deduces N from the initializer list:
+//     constexpr auto m = phmap::make_static_flat_map<int, char>({{1, 'a'}, {2, 'b'}});
+// -----------------------------------------------------------------------------
+template <class K, class V, class Hash = phmap::StaticHash<K>, class Eq = phmap::StaticEqualTo<K>,
+          size_t N>
+constexpr static_flat_map<K, V, N, Hash, Eq> make_static_flat_map(const std::pair<K, V> (&items)[N]) {
+    return static_flat_map<K, V, N, Hash, Eq>(items);
+}
+
+}  // namespace phmap
+
+#endif // PHMAP_HAVE_CC14
+
+#endif // phmap_static_h_guard_
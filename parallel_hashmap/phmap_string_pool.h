@@ -0,0 +1,278 @@
+#if !defined(phmap_string_pool_h_guard_)
+#define phmap_string_pool_h_guard_
+
+// ---------------------------------------------------------------------------
+// Copyright (c) 2019, Gregory Popovitch - greg7mdp@gmail.com
+//
+//       concurrent string interning
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+// phmap::string_pool stores a single copy of each distinct string, and
+// identifies it with a 32 bit id:
+//
+//    phmap::string_pool<> pool;
+//    uint32_t id = pool.intern("hello");      // same id for every "hello"
+//    std::string_view s = pool.view(id);      // O(1) reverse lookup
+//
+// It is a parallel_flat_hash_set of {string_view, id} entries, looked up with
+// heterogeneous std::string_view keys (hashed with StringHashEqT<char>). The
+// bytes of the strings are copied in append-only arenas, one per submap, so
+// interning a new string does not allocate (except for a new arena block) and
+// the returned string_views stay valid until the pool is cleared or destroyed.
+//
+// The id of a string is `(index in its submap << N) | submap index`. Each
+// submap also keeps the vector of its string_views indexed by this index, for
+// the reverse lookup. The arena and this vector are protected by the lock of
+// their submap, so all members can be called concurrently when `Mutex` is a
+// real mutex (std::mutex by default), except `clear()`.
+//
+// Requires C++17 (std::string_view).
+// ---------------------------------------------------------------------------
+
+#include <array>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "phmap.h"
+
+#if PHMAP_HAVE_STD_STRING_VIEW
+
+namespace phmap {
+
+namespace priv {
+
+// --------------------------------------------------------------------------
+// Append-only storage for string bytes. The blocks are never moved.
+// --------------------------------------------------------------------------
+class StringArena
+{
+public:
+    explicit StringArena(size_t block_size) : block_size_(block_size) {}
+
+    std::string_view append(std::string_view s) {
+        if (s.size() > left_) {
+            size_t sz = (std::max)(block_size_, s.size());
+            blocks_.emplace_back(new char[sz]);
+            cur_ = blocks_.back().get();
+            left_ = sz;
+            allocated_ += sz;
+        }
+        if (!s.empty())
+            std::memcpy(cur_, s.data(), s.size());
+        std::string_view res(cur_, s.size());
+        cur_ += s.size();
+        left_ -= s.size();
+        return res;
+    }
+
+    size_t allocated_bytes() const { return allocated_; }
+
+    void clear() {
+        blocks_.clear();
+        cur_ = nullptr;
+        left_ = 0;
+        allocated_ = 0;
+    }
+
+private:
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char*  cur_ = nullptr;
+    size_t left_ = 0;
+    size_t allocated_ = 0;
+    size_t block_size_;
+};
+
+// entry of the string_pool hash set
+struct StringPoolEntry
+{
+    std::string_view str;
+    uint32_t         id;
+};
+
+struct StringPoolHash : StringHashEqT<char>::Hash
+{
+    using Base = StringHashEqT<char>::Hash;
+    using is_transparent = void;
+
+    size_t operator()(std::string_view v) const { return Base::operator()(v); }
+    size_t operator()(const StringPoolEntry& e) const { return Base::operator()(e.str); }
+};
+
+struct StringPoolEq
+{
+    using is_transparent = void;
+
+    static std::string_view str(std::string_view v) { return v; }
+    static std::string_view str(const StringPoolEntry& e) { return e.str; }
+
+    template <class A, class B>
+    bool operator()(const A& a, const B& b) const { return str(a) == str(b); }
+};
+
+}  // namespace priv
+
+// -----------------------------------------------------------------------------
+// phmap::string_pool
+// -----------------------------------------------------------------------------
+template <size_t N, class Mutex> // default values in phmap_fwd_decl.h
+class string_pool
+{
+    using Entry = priv::StringPoolEntry;
+    using Set = phmap::parallel_flat_hash_set<Entry, priv::StringPoolHash, priv::StringPoolEq,
+                                              phmap::priv::Allocator<Entry>, N, Mutex>;
+
+    static constexpr size_t   kNumSubmaps = size_t(1) << N;
+    static constexpr uint64_t kMaxPerSubmap = (uint64_t(1) << (32 - N)) - 1;
+
+    static_assert(N < 16, "string_pool supports at most 2**15 submaps");
+
+public:
+    using id_type = uint32_t;
+
+    // returned by find() when the string is not in the pool (never a valid id)
+    static constexpr id_type npos = ~id_type(0);
+
+    // `block_size` is the size of the arena blocks of each submap
+    explicit string_pool(size_t block_size = 64 * 1024) {
+        for (size_t i = 0; i < kNumSubmaps; ++i)
+            shards_[i].reset(new Shard(block_size));
+    }
+
+    string_pool(const string_pool&) = delete;
+    string_pool& operator=(const string_pool&) = delete;
+
+    // Returns the id of `s`, adding a copy of `s` to the pool if not present.
+    id_type intern(std::string_view s) { return intern_impl(s).id; }
+
+    // Same as `intern()`, but returns the copy of `s` stored in the pool.
+    std::string_view intern_view(std::string_view s) { return intern_impl(s).str; }
+
+    // Returns the id of `s`, or `npos` if `s` was not interned.
+    id_type find(std::string_view s) const {
+        size_t hashval = set_.hash(s);
+        id_type id = npos;
+        set_.with_submap(Set::subidx(hashval), [&](const typename Set::EmbeddedSet& set) {
+            auto it = set.find(s, hashval);
+            if (it != set.end())
+                id = it->id;
+        });
+        return id;
+    }
+
+    bool contains(std::string_view s) const { return find(s) != npos; }
+
+    // Returns the string of `id`.
+    // PRECONDITION: `id` was returned by this pool.
+    std::string_view view(id_type id) const {
+        size_t idx = id & (kNumSubmaps - 1);
+        std::string_view res;
+        set_.with_submap(idx, [&](const typename Set::EmbeddedSet&) {
+            const auto& views = shards_[idx]->views;
+            assert((id >> N) < views.size() && "invalid string_pool id");
+            res = views[id >> N];
+        });
+        return res;
+    }
+
+    size_t size() const { return set_.size(); }
+    bool empty() const { return set_.empty(); }
+
+    // bytes allocated by the arenas
+    size_t arena_bytes() const {
+        size_t res = 0;
+        for (size_t i = 0; i < kNumSubmaps; ++i)
+            set_.with_submap(i, [&](const typename Set::EmbeddedSet&) {
+                res += shards_[i]->arena.allocated_bytes();
+            });
+        return res;
+    }
+
+    // Calls `f(id, string_view)` for each string, submap by submap under its
+    // (shared) lock.
+    template <class F>
+    void for_each(F&& f) const {
+        for (size_t i = 0; i < kNumSubmaps; ++i)
+            set_.with_submap(i, [&](const typename Set::EmbeddedSet&) {
+                const auto& views = shards_[i]->views;
+                for (size_t j = 0; j < views.size(); ++j)
+                    f(make_id(j, i), views[j]);
+            });
+    }
+
+    // Removes all the strings. Invalidates the ids and string_views returned
+    // so far; must not be called concurrently with other members.
+    void clear() {
+        set_.clear();
+        for (auto& shard : shards_) {
+            shard->arena.clear();
+            shard->views.clear();
+        }
+    }
+
+private:
+    struct Shard
+    {
+        explicit Shard(size_t block_size) : arena(block_size) {}
+
+        priv::StringArena             arena;
+        std::vector<std::string_view> views;   // indexed by `id >> N`
+    };
+
+    static id_type make_id(size_t local, size_t idx) {
+        return static_cast<id_type>((local << N) | idx);
+    }
+
+    // Looks up `s` under the shared lock of its submap first, as most strings
+    // are usually already interned, then under the unique lock to insert it.
+    Entry intern_impl(std::string_view s) {
+        size_t hashval = set_.hash(s);
+        size_t idx = Set::subidx(hashval);
+        Entry res{std::string_view(), npos};
+        set_.with_submap(idx, [&](const typename Set::EmbeddedSet& set) {
+            auto it = set.find(s, hashval);
+            if (it != set.end())
+                res = *it;
+        });
+        if (res.id != npos)
+            return res;
+
+        set_.with_submap_m(idx, [&](typename Set::EmbeddedSet& set) {
+            auto it = set.find(s, hashval);
+            if (it != set.end()) {
+                res = *it;
+                return;
+            }
+            Shard& shard = *shards_[idx];
+            if (shard.views.size() >= kMaxPerSubmap)
+                phmap::base_internal::ThrowStdLengthError("phmap string_pool: too many strings");
+            res.str = shard.arena.append(s);
+            res.id = make_id(shard.views.size(), idx);
+            shard.views.push_back(res.str);
+            set.emplace_with_hash(hashval, res);
+        });
+        return res;
+    }
+
+    Set set_;
+    std::array<std::unique_ptr<Shard>, kNumSubmaps> shards_;
+};
+
+}  // namespace phmap
+
+#endif // PHMAP_HAVE_STD_STRING_VIEW
+
+#endif // phmap_string_pool_h_guard_
@@ -28,11 +28,24 @@
     #pragma warning(disable : 4711) // selected for automatic inline expansion
 #endif
 
+#include <array>
 #include <cstdint>
 #include <functional>
+#include <iterator>
+#include <string>
 #include <tuple>
+#include <type_traits>
+#include <vector>
 #include "phmap_bits.h"
 
+#if PHMAP_HAVE_STD_STRING_VIEW
+    #include <string_view>
+#endif
+
+#if defined(__ARM_FEATURE_CRC32)
+    #include <arm_acle.h>
+#endif
+
 // ---------------------------------------------------------------
 // Absl forward declaration requires global scope.
 // ---------------------------------------------------------------
@@ -44,6 +57,102 @@ namespace phmap
 {
 
 // ---------------------------------------------------------------
+// CRC32C (Castagnoli), computed with the SSE4.2 or ARMv8 instructions
+// when the target has them (-msse4.2 for example), with a table otherwise.
+// ---------------------------------------------------------------
+namespace priv {
+
+#if !PHMAP_HAVE_SSE42 && !defined(__ARM_FEATURE_CRC32)
+inline const uint32_t* crc32c_table()
+{
+    static const struct Table {
+        uint32_t t[256];
+        Table() {
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k)
+                    c = (c >> 1) ^ (0x82f63b78U & (0U - (c & 1)));
+                t[i] = c;
+            }
+        }
+    } table;
+    return table.t;
+}
+#endif
+
+inline uint32_t crc32c_u8(uint32_t crc, uint8_t v)
+{
+#if PHMAP_HAVE_SSE42
+    return _mm_crc32_u8(crc, v);
+#elif defined(__ARM_FEATURE_CRC32)
+    return __crc32cb(crc, v);
+#else
+    return (crc >> 8) ^ crc32c_table()[(crc ^ v) & 0xff];
+#endif
+}
+
+inline uint32_t crc32c_u64(uint32_t crc, uint64_t v)
+{
+#if PHMAP_HAVE_SSE42 && (defined(__x86_64__) || defined(_M_X64))
+    return static_cast<uint32_t>(_mm_crc32_u64(crc, v));
+#elif PHMAP_HAVE_SSE42
+    crc = _mm_crc32_u32(crc, static_cast<uint32_t>(v));
+    return _mm_crc32_u32(crc, static_cast<uint32_t>(v >> 32));
+#elif defined(__ARM_FEATURE_CRC32)
+    return __crc32cd(crc, v);
+#else
+    for (int k = 0; k < 8; ++k, v >>= 8)
+        crc = crc32c_u8(crc, static_cast<uint8_t>(v));
+    return crc;
+#endif
+}
+
+// 64 bit hash of a 64 bit value: the CRC32C of the value, and of the value
+// with its halves swapped, which the CPU computes in parallel
+inline uint64_t crc32c_mix(uint64_t v)
+{
+    return (uint64_t(crc32c_u64(0, (v >> 32) | (v << 32))) << 32) | crc32c_u64(0, v);
+}
+
+// 64 bit hash of a range of bytes, with the same two CRC32C
+inline uint64_t crc32c_hash_bytes(const void* key, size_t len)
+{
+    const uint8_t* p = static_cast<const uint8_t*>(key);
+    uint32_t c1 = static_cast<uint32_t>(len), c2 = ~c1;
+    for (; len >= 8; len -= 8, p += 8) {
+        const uint64_t w = bits::UnalignedLoad64(p);
+        c1 = crc32c_u64(c1, w);
+        c2 = crc32c_u64(c2, (w >> 32) | (w << 32));
+    }
+    if (len) {
+        uint64_t w = 0;
+        memcpy(&w, p, len);
+        c1 = crc32c_u64(c1, w);
+        c2 = crc32c_u64(c2, (w >> 32) | (w << 32));
+    }
+    return (uint64_t(c2) << 32) | c1;
+}
+
+}  // namespace priv
+
+// standard CRC-32C of [p, p + len), which continues `crc` (as zlib's crc32())
+inline uint32_t crc32c(const void* key, size_t len, uint32_t crc = 0)
+{
+    const uint8_t* p = static_cast<const uint8_t*>(key);
+    crc = ~crc;
+    for (; len >= 8; len -= 8, p += 8)
+        crc = priv::crc32c_u64(crc, bits::UnalignedLoad64(p));
+    for (; len; --len)
+        crc = priv::crc32c_u8(crc, *p++);
+    return ~crc;
+}
+
+// ---------------------------------------------------------------
+// phmap_mix: the mix applied by the tables to the hashes (of a quality
+// which the user hash functions may not have). With
+// PHMAP_USE_CRC32C_HASH, it uses the CRC32C instead of a 128 bit
+// multiplication: only worth it with the CRC32C in hardware (-msse4.2, or
+// ARMv8 with crc), the software fallback is much slower.
 // ---------------------------------------------------------------
 template<int n> 
 struct phmap_mix
@@ -56,13 +165,26 @@ struct phmap_mix<4>
 {
     inline size_t operator()(size_t a) const
     {
+#if defined(PHMAP_USE_CRC32C_HASH)
+        uint64_t l = priv::crc32c_mix(a);
+#else
         static constexpr uint64_t kmul = 0xcc9e2d51UL;
         uint64_t l = a * kmul;
+#endif
         return static_cast<size_t>(l ^ (l >> 32));
     }
 };
 
-#if defined(PHMAP_HAS_UMUL128)
+#if defined(PHMAP_USE_CRC32C_HASH)
+    template<>
+    struct phmap_mix<8>
+    {
+        inline size_t operator()(size_t a) const
+        {
+            return static_cast<size_t>(priv::crc32c_mix(a));
+        }
+    };
+#elif defined(PHMAP_HAS_UMUL128)
     template<>
     struct phmap_mix<8>
     {
@@ -118,6 +240,121 @@ struct fold_if_needed<8>
     }
 };
 
+// ---------------------------------------------------------------
+// hash_bytes(p, len, seed): 64 bit hash of a range of bytes, used for
+// the strings. This is the algorithm of wyhash (final version 4): the
+// input is read 16 or 48 bytes at a time, and each 64 bit word is mixed
+// with a 64x64->128 bit multiplication.
+// ---------------------------------------------------------------
+namespace priv {
+
+inline void wy_mum(uint64_t* a, uint64_t* b)
+{
+#if defined(PHMAP_HAS_UMUL128)
+    uint64_t h;
+    *a = umul128(*a, *b, &h);
+    *b = h;
+#else
+    const uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    const uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+inline uint64_t wy_mix(uint64_t a, uint64_t b)
+{
+    wy_mum(&a, &b);
+    return a ^ b;
+}
+
+struct wy_secret
+{
+    static constexpr uint64_t s0 = 0x2d358dccaa6c78a5ULL, s1 = 0x8bb84b93962eacc9ULL,
+                              s2 = 0x4b33a62ed433d4a3ULL, s3 = 0x4d5a2da51de1aa47ULL;
+};
+
+inline uint64_t wy_read8(const uint8_t* p) { return bits::UnalignedLoad64(p); }
+inline uint64_t wy_read4(const uint8_t* p) { return bits::UnalignedLoad32(p); }
+
+// 1 to 3 bytes
+inline uint64_t wy_read3(const uint8_t* p, size_t k)
+{
+    return (uint64_t(p[0]) << 16) | (uint64_t(p[k >> 1]) << 8) | p[k - 1];
+}
+
+// hash_bytes() with a seed which is already mixed
+inline uint64_t wy_hash(const void* key, size_t len, uint64_t seed)
+{
+    const uint64_t s0 = wy_secret::s0, s1 = wy_secret::s1, s2 = wy_secret::s2, s3 = wy_secret::s3;
+    const uint8_t* p = static_cast<const uint8_t*>(key);
+    uint64_t a, b;
+    if (len <= 16) {
+        if (len >= 4) {
+            const size_t d = (len >> 3) << 2;
+            a = (wy_read4(p) << 32) | wy_read4(p + d);
+            b = (wy_read4(p + len - 4) << 32) | wy_read4(p + len - 4 - d);
+        } else if (len > 0) {
+            a = wy_read3(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = wy_mix(wy_read8(p) ^ s1, wy_read8(p + 8) ^ seed);
+                see1 = wy_mix(wy_read8(p + 16) ^ s2, wy_read8(p + 24) ^ see1);
+                see2 = wy_mix(wy_read8(p + 32) ^ s3, wy_read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = wy_mix(wy_read8(p) ^ s1, wy_read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = wy_read8(p + i - 16);
+        b = wy_read8(p + i - 8);
+    }
+    a ^= s1;
+    b ^= seed;
+    wy_mum(&a, &b);
+    return wy_mix(a ^ s0 ^ len, b ^ s1);
+}
+
+}  // namespace priv
+
+inline uint64_t hash_bytes(const void* key, size_t len, uint64_t seed = 0)
+{
+    using priv::wy_secret;
+    return priv::wy_hash(key, len, seed ^ priv::wy_mix(seed ^ wy_secret::s0, wy_secret::s1));
+}
+
+namespace priv {
+
+// the hash of the strings and of the other ranges of bytes (see
+// is_uniquely_represented): hash_bytes(), or the CRC32C with
+// PHMAP_USE_CRC32C_HASH
+inline size_t hash_key_bytes(const void* key, size_t len)
+{
+#if defined(PHMAP_USE_CRC32C_HASH)
+    return fold_if_needed<sizeof(size_t)>()(crc32c_hash_bytes(key, len));
+#else
+    return fold_if_needed<sizeof(size_t)>()(hash_bytes(key, len));
+#endif
+}
+
+}  // namespace priv
+
 // ---------------------------------------------------------------
 // see if class T has a hash_value() friend method
 // ---------------------------------------------------------------
@@ -136,6 +373,65 @@ public:
     static constexpr bool value = std::is_same<decltype(test<T>(0)), yes>::value;
 };
 
+// ---------------------------------------------------------------
+// see if class T has an AbslHashValue() friend function (see
+// MixingHashState below)
+// ---------------------------------------------------------------
+class MixingHashState;
+
+template<typename T>
+struct has_absl_hash_value
+{
+private:
+    typedef std::true_type yes;
+    typedef std::false_type no;
+
+    template<typename U> static auto test(int) -> decltype(AbslHashValue(std::declval<MixingHashState>(),
+                                                                         std::declval<const U&>()), yes());
+
+    template<typename> static no test(...);
+
+public:
+    static constexpr bool value = std::is_same<decltype(test<T>(0)), yes>::value;
+};
+
+namespace priv {
+template <class T> size_t hash_with_state(const T& v);
+}
+
+// ---------------------------------------------------------------
+// is_uniquely_represented<T>: true if two values of T are equal exactly when
+// their bytes are equal (no padding, one representation per value), so that
+// contiguous values of T can be hashed as a range of bytes. True for the
+// integers (except bool), the enums, and the arrays and pairs of such types
+// without padding. It can be specialized for the user types:
+//
+//    namespace phmap {
+//        template <> struct is_uniquely_represented<Digest> : std::true_type {};
+//    }
+//
+// phmap::Hash<Digest> then hashes the bytes of a Digest (unless it has a
+// hash_value() function), and the vectors of Digest are hashed at once.
+// ---------------------------------------------------------------
+template <class T, class Enable = void>
+struct is_uniquely_represented : std::false_type {};
+
+template <class T>
+struct is_uniquely_represented<T, typename std::enable_if<
+    (std::is_integral<T>::value && !std::is_same<typename std::remove_cv<T>::type, bool>::value) ||
+    std::is_enum<T>::value>::type> : std::true_type {};
+
+template <class T, size_t N>
+struct is_uniquely_represented<std::array<T, N>>
+    : std::integral_constant<bool, is_uniquely_represented<T>::value &&
+                                   sizeof(std::array<T, N>) == N * sizeof(T)> {};
+
+template <class T1, class T2>
+struct is_uniquely_represented<std::pair<T1, T2>>
+    : std::integral_constant<bool, is_uniquely_represented<T1>::value &&
+                                   is_uniquely_represented<T2>::value &&
+                                   sizeof(std::pair<T1, T2>) == sizeof(T1) + sizeof(T2)> {};
+
 #if defined(PHMAP_USE_ABSL_HASH) && !defined(phmap_fwd_decl_h_guard_)
     template <class T> using Hash = ::absl::Hash<T>;
 #elif !defined(PHMAP_USE_ABSL_HASH)
@@ -151,7 +447,26 @@ struct Hash
         return hash_value(val);
     }
  
-    template <class U, typename std::enable_if<!has_hash_value<U>::value, int>::type = 0>
+    template <class U, typename std::enable_if<!has_hash_value<U>::value &&
+                                               has_absl_hash_value<U>::value, int>::type = 0>
+    size_t _hash(const T& val) const
+    {
+        return priv::hash_with_state(val);
+    }
+
+    template <class U, typename std::enable_if<!has_hash_value<U>::value &&
+                                               !has_absl_hash_value<U>::value &&
+                                               std::is_class<U>::value &&
+                                               is_uniquely_represented<U>::value, int>::type = 0>
+    size_t _hash(const T& val) const
+    {
+        return priv::hash_key_bytes(&val, sizeof(T));
+    }
+
+    template <class U, typename std::enable_if<!has_hash_value<U>::value &&
+                                               !has_absl_hash_value<U>::value &&
+                                               !(std::is_class<U>::value &&
+                                                 is_uniquely_represented<U>::value), int>::type = 0>
     size_t _hash(const T& val) const
     {
         return std::hash<T>()(val);
@@ -273,6 +588,27 @@ struct Hash<double> : public phmap_unary_function<double, size_t>
     }
 };
 
+// strings and string_views of the same characters have the same hash
+template <class CharT, class Traits, class Alloc>
+struct Hash<std::basic_string<CharT, Traits, Alloc>>
+{
+    inline size_t operator()(const std::basic_string<CharT, Traits, Alloc>& s) const noexcept
+    {
+        return priv::hash_key_bytes(s.data(), s.size() * sizeof(CharT));
+    }
+};
+
+#if PHMAP_HAVE_STD_STRING_VIEW
+template <class CharT, class Traits>
+struct Hash<std::basic_string_view<CharT, Traits>>
+{
+    inline size_t operator()(std::basic_string_view<CharT, Traits> s) const noexcept
+    {
+        return priv::hash_key_bytes(s.data(), s.size() * sizeof(CharT));
+    }
+};
+#endif
+
 #endif
 
 #if defined(_MSC_VER)
@@ -335,7 +671,8 @@ template <class H> struct Combiner<H, 8>
     }
 };
 
-// define HashState to combine member hashes... see example below
+// define HashState to combine member hashes... see example below (HashState,
+// for size_t, feeds the members into a MixingHashState instead)
 // -----------------------------------------------------------------------------
 template <typename H>
 class HashStateBase {
@@ -355,46 +692,358 @@ H HashStateBase<H>::combine(H seed, const T& v, const Ts&... vs)
                                      vs...);
 }
 
+// ---------------------------------------------------------------
+// MixingHashState: streaming hash state (as Abseil's). The members of an
+// object are fed one after the other into one 64 bit state, which is
+// finalized once, instead of being hashed separately and combined. A user
+// type provides it with an AbslHashValue() friend function:
+//
+//    template <class H>
+//    friend H AbslHashValue(H h, const Person& p) {
+//        return H::combine(std::move(h), p._first, p._last, p._age);
+//    }
+//
+// and phmap::Hash<Person> (or absl::Hash<Person>) hashes it in one pass.
+// The integers, enums, floats and pointers are mixed into the state with
+// one 64x64->128 bit multiplication; the strings and the ranges of
+// uniquely represented values are hashed with wyhash seeded with the
+// state; the other types are fed their phmap::Hash (hash_value() or
+// std::hash).
+// ---------------------------------------------------------------
+class MixingHashState
+{
+public:
+    explicit MixingHashState(uint64_t seed = 0) : state_(seed ^ priv::wy_secret::s0) {}
+
+    template <class T, class... Ts>
+    static MixingHashState combine(MixingHashState s, const T& v, const Ts&... vs)
+    {
+        return combine(add(s, v), vs...);
+    }
+
+    static MixingHashState combine(MixingHashState s) { return s; }
+
+    // feeds the values of [data, data + size), but not their number
+    template <class T>
+    static MixingHashState combine_contiguous(MixingHashState s, const T* data, size_t size)
+    {
+        return add_range(s, data, size, is_uniquely_represented<T>());
+    }
+
+    size_t value() const { return fold_if_needed<sizeof(size_t)>()(state_); }
+
+private:
+    void mix(uint64_t v) { state_ = priv::wy_mix(state_ + v, priv::wy_secret::s1); }
+
+    void mix_bytes(const void* p, size_t len) { state_ = priv::wy_hash(p, len, state_); }
+
+    template <class T>
+    using kind = std::integral_constant<int,
+        has_absl_hash_value<T>::value ? 0 :
+        ((std::is_integral<T>::value || std::is_enum<T>::value) && sizeof(T) <= 8) ? 1 :
+        (is_uniquely_represented<T>::value && sizeof(T) <= 8) ? 2 :
+        is_uniquely_represented<T>::value ? 3 :
+        (std::is_same<T, float>::value || std::is_same<T, double>::value) ? 4 :
+        std::is_pointer<T>::value ? 5 : 6>;
+
+    template <class T>
+    static MixingHashState add(MixingHashState s, const T& v) { return add(s, v, kind<T>()); }
+
+    template <class T>
+    static MixingHashState add(MixingHashState s, const T& v, std::integral_constant<int, 0>)
+    {
+        return AbslHashValue(std::move(s), v);
+    }
+
+    template <class T>
+    static MixingHashState add(MixingHashState s, const T& v, std::integral_constant<int, 1>)
+    {
+        s.mix(static_cast<uint64_t>(v));
+        return s;
+    }
+
+    template <class T>
+    static MixingHashState add(MixingHashState s, const T& v, std::integral_constant<int, 2>)
+    {
+        uint64_t w = 0;
+        memcpy(&w, &v, sizeof(T));
+        s.mix(w);
+        return s;
+    }
+
+    template <class T>
+    static MixingHashState add(MixingHashState s, const T& v, std::integral_constant<int, 3>)
+    {
+        s.mix_bytes(&v, sizeof(T));
+        return s;
+    }
+
+    // 0.0 and -0.0 are equal
+    template <class T>
+    static MixingHashState add(MixingHashState s, const T& v, std::integral_constant<int, 4>)
+    {
+        uint64_t w = 0;
+        if (v != 0)
+            memcpy(&w, &v, sizeof(T));
+        s.mix(w);
+        return s;
+    }
+
+    template <class T>
+    static MixingHashState add(MixingHashState s, const T& v, std::integral_constant<int, 5>)
+    {
+        s.mix(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(v)));
+        return s;
+    }
+
+    template <class T>
+    static MixingHashState add(MixingHashState s, const T& v, std::integral_constant<int, 6>)
+    {
+        s.mix(phmap::Hash<T>()(v));
+        return s;
+    }
+
+    // the length of the strings is mixed by wyhash
+    template <class CharT, class Traits, class Alloc>
+    static MixingHashState add(MixingHashState s, const std::basic_string<CharT, Traits, Alloc>& v)
+    {
+        s.mix_bytes(v.data(), v.size() * sizeof(CharT));
+        return s;
+    }
+
+#if PHMAP_HAVE_STD_STRING_VIEW
+    template <class CharT, class Traits>
+    static MixingHashState add(MixingHashState s, const std::basic_string_view<CharT, Traits>& v)
+    {
+        s.mix_bytes(v.data(), v.size() * sizeof(CharT));
+        return s;
+    }
+#endif
+
+    template <class T1, class T2>
+    static MixingHashState add(MixingHashState s, const std::pair<T1, T2>& p)
+    {
+        return combine(s, p.first, p.second);
+    }
+
+    template <class... Ts>
+    static MixingHashState add(MixingHashState s, const std::tuple<Ts...>& t)
+    {
+        return add_tuple<0>(s, t);
+    }
+
+    template <size_t I, class Tuple>
+    static typename std::enable_if<I == std::tuple_size<Tuple>::value, MixingHashState>::type
+    add_tuple(MixingHashState s, const Tuple&) { return s; }
+
+    template <size_t I, class Tuple>
+    static typename std::enable_if<I < std::tuple_size<Tuple>::value, MixingHashState>::type
+    add_tuple(MixingHashState s, const Tuple& t)
+    {
+        return add_tuple<I + 1>(add(s, std::get<I>(t)), t);
+    }
+
+    template <class T, class A>
+    static MixingHashState add(MixingHashState s, const std::vector<T, A>& v)
+    {
+        return add(combine_contiguous(s, v.data(), v.size()), v.size());
+    }
+
+    template <class A>
+    static MixingHashState add(MixingHashState s, const std::vector<bool, A>& v)
+    {
+        for (bool b : v)
+            s.mix(b);
+        return add(s, v.size());
+    }
+
+    template <class T, size_t N>
+    static MixingHashState add(MixingHashState s, const std::array<T, N>& a)
+    {
+        return add(combine_contiguous(s, a.data(), N), N);
+    }
+
+    template <class T>
+    static MixingHashState add_range(MixingHashState s, const T* data, size_t size, std::true_type)
+    {
+        s.mix_bytes(data, size * sizeof(T));
+        return s;
+    }
+
+    template <class T>
+    static MixingHashState add_range(MixingHashState s, const T* data, size_t size, std::false_type)
+    {
+        for (size_t i = 0; i < size; ++i)
+            s = add(s, data[i]);
+        return s;
+    }
+
+    uint64_t state_;
+};
+
+namespace priv {
+
+template <class T>
+size_t hash_with_state(const T& v)
+{
+    return MixingHashState::combine(MixingHashState(), v).value();
+}
+
+}  // namespace priv
+
+// HashState().combine(seed, values...) feeds the values into one MixingHashState
+template <>
+class HashStateBase<size_t> {
+public:
+    template <typename... Ts>
+    static size_t combine(size_t seed, const Ts&... values)
+    {
+        return MixingHashState::combine(MixingHashState(seed), values...).value();
+    }
+};
+
 using HashState = HashStateBase<size_t>;
 
 // -----------------------------------------------------------------------------
 
 #if !defined(PHMAP_USE_ABSL_HASH)
 
-// define Hash for std::pair
-// -------------------------
+// define Hash for std::pair and std::tuple: the same values have the same hash
+// in both
+// ----------------------------------------------------------------------------
 template<class T1, class T2> 
 struct Hash<std::pair<T1, T2>> {
     size_t operator()(std::pair<T1, T2> const& p) const noexcept {
-        return phmap::HashState().combine(phmap::Hash<T1>()(p.first), p.second);
+        return priv::hash_with_state(p);
     }
 };
 
-// define Hash for std::tuple
-// --------------------------
 template<class... T> 
 struct Hash<std::tuple<T...>> {
     size_t operator()(std::tuple<T...> const& t) const noexcept {
-        size_t seed = 0;
-        return _hash_helper(seed, t);
+        return priv::hash_with_state(t);
     }
+};
 
-private:
-    template<size_t I = 0, class TUP>
-    typename std::enable_if<I == std::tuple_size<TUP>::value, size_t>::type
-    _hash_helper(size_t seed, const TUP &) const noexcept { return seed; }
+namespace priv {
+
+// Hash of n contiguous values: their bytes are hashed at once if they are
+// uniquely represented, otherwise they are fed to a MixingHashState.
+template <class T>
+size_t hash_range(const T* p, size_t n, std::true_type) {
+    return hash_key_bytes(p, n * sizeof(T));
+}
+
+template <class It>
+size_t hash_range(It it, size_t n, std::false_type) {
+    using T = typename std::iterator_traits<It>::value_type;
+    MixingHashState s;
+    for (size_t i = 0; i < n; ++i, ++it) {
+        const T& v = *it;
+        s = MixingHashState::combine(s, v);
+    }
+    return MixingHashState::combine(s, n).value();
+}
+
+template <class T>
+size_t hash_range(const T* p, size_t n) {
+    return hash_range(p, n, is_uniquely_represented<typename std::remove_cv<T>::type>());
+}
+
+}  // namespace priv
+
+// define Hash for std::vector and std::array (and phmap::Span in phmap_base.h):
+// the same values have the same hash in all of them
+// ---------------------------------------------------------------------------
+template<class T, class A>
+struct Hash<std::vector<T, A>> {
+    size_t operator()(const std::vector<T, A>& v) const noexcept {
+        return priv::hash_range(v.data(), v.size());
+    }
+};
+
+template<class A>
+struct Hash<std::vector<bool, A>> {
+    size_t operator()(const std::vector<bool, A>& v) const noexcept {
+        return priv::hash_range(v.begin(), v.size(), std::false_type());
+    }
+};
 
-    template<size_t I = 0, class TUP>
-    typename std::enable_if<I < std::tuple_size<TUP>::value, size_t>::type
-    _hash_helper(size_t seed, const TUP &t) const noexcept {
-        const auto &el = std::get<I>(t);
-        using el_type = typename std::remove_cv<typename std::remove_reference<decltype(el)>::type>::type;
-        seed = Combiner<size_t, sizeof(size_t)>()(seed, phmap::Hash<el_type>()(el));
-        return _hash_helper<I + 1>(seed, t);
+template<class T, size_t N>
+struct Hash<std::array<T, N>> {
+    size_t operator()(const std::array<T, N>& a) const noexcept {
+        return priv::hash_range(a.data(), N);
     }
 };
 
+#endif
 
+// ---------------------------------------------------------------
+// hash_batch(keys, n, out): out[i] = hasher(keys[i]) for a batch of keys
+// (of a bulk insert or lookup). Hashing the batch in its own loop, rather
+// than one key between two probes, keeps the multiplications of the
+// independent keys in flight together, and lets the compiler vectorize the
+// hashers of the integers.
+// ---------------------------------------------------------------
+template <class T, class H = phmap::Hash<T>>
+void hash_batch(const T* keys, size_t n, size_t* out, const H& hasher = H())
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = hasher(keys[i]);
+}
+
+// ---------------------------------------------------------------
+// phmap::Crc32cHash<T>: hash computed with the CRC32C, for the integers,
+// the enums, the strings and the uniquely represented types (see
+// is_uniquely_represented):
+//
+//    phmap::flat_hash_map<uint64_t, int, phmap::Crc32cHash<uint64_t>> m;
+//
+// The tables mix the hash again with phmap_mix, which uses the CRC32C too
+// when PHMAP_USE_CRC32C_HASH is defined. This switch also makes the
+// default hash of the strings the one of Crc32cHash.
+// ---------------------------------------------------------------
+template <class T, class Enable = void>
+struct Crc32cHash
+{
+    static_assert(is_uniquely_represented<T>::value,
+                  "Crc32cHash requires integers, enums, strings, or uniquely represented types");
+
+    size_t operator()(const T& v) const noexcept
+    {
+        return fold_if_needed<sizeof(size_t)>()(priv::crc32c_hash_bytes(&v, sizeof(T)));
+    }
+};
+
+template <class T>
+struct Crc32cHash<T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type>
+{
+    size_t operator()(T v) const noexcept
+    {
+        return fold_if_needed<sizeof(size_t)>()(priv::crc32c_mix(static_cast<uint64_t>(v)));
+    }
+};
+
+template <class CharT, class Traits, class Alloc>
+struct Crc32cHash<std::basic_string<CharT, Traits, Alloc>>
+{
+    size_t operator()(const std::basic_string<CharT, Traits, Alloc>& s) const noexcept
+    {
+        return fold_if_needed<sizeof(size_t)>()(
+            priv::crc32c_hash_bytes(s.data(), s.size() * sizeof(CharT)));
+    }
+};
+
+#if PHMAP_HAVE_STD_STRING_VIEW
+template <class CharT, class Traits>
+struct Crc32cHash<std::basic_string_view<CharT, Traits>>
+{
+    size_t operator()(std::basic_string_view<CharT, Traits> s) const noexcept
+    {
+        return fold_if_needed<sizeof(size_t)>()(
+            priv::crc32c_hash_bytes(s.data(), s.size() * sizeof(CharT)));
+    }
+};
 #endif
 
 
@@ -0,0 +1,334 @@
+#if !defined(phmap_wal_h_guard_)
+#define phmap_wal_h_guard_
+
+// ---------------------------------------------------------------------------
+// Copyright (c) 2019, Gregory Popovitch - greg7mdp@gmail.com
+//
+//       write-ahead log of the mutations of a parallel hash map
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+// phmap::mutation_log<Map> makes the mutations of a parallel_flat_hash_map
+// (of trivially copyable keys and values, with a mutex) durable between two
+// full dumps:
+//
+//    Map m;
+//    m.phmap_load(base_ar);                               // last full dump
+//    phmap::mutation_log<Map>::replay(m, "map.wal");      // and the mutations since
+//
+//    phmap::mutation_log<Map> log(m, "map.wal", std::chrono::milliseconds(5));
+//    log.insert_or_assign(42, 1);                         // durable after the next commit
+//
+// The mutations made through the log are applied to the map, and their
+// results (the new value of the element, or its erasure) are appended to a
+// buffer of the submap while the submap's lock is held, so that logging adds
+// no locking. commit() writes the buffers of all the submaps as one group at
+// the end of the file, and syncs it: with a commit interval, a background
+// thread commits periodically (group commit), otherwise commit() is called
+// by the user, typically before acknowledging the mutations.
+//
+// The records are idempotent, so a full dump can be taken while the map is
+// in use: rotate() the log to a new file first, then dump the map; recovery
+// loads this dump and replays the new file. A group which is not complete
+// (crash during a commit) is ignored by replay(), and truncated when the
+// file is opened again.
+//
+// The mutations made directly on the map are not logged.
+// ---------------------------------------------------------------------------
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "phmap_dump.h"
+
+#if PHMAP_HAVE_MMAP
+
+namespace phmap {
+
+template <class Map>
+class mutation_log
+{
+public:
+    using map_type    = Map;
+    using key_type    = typename Map::key_type;
+    using mapped_type = typename Map::mapped_type;
+    using value_type  = typename Map::value_type;
+
+    static_assert(type_traits_internal::IsTriviallyCopyable<key_type>::value &&
+                  type_traits_internal::IsTriviallyCopyable<mapped_type>::value,
+                  "mutation_log requires trivially copyable keys and values");
+
+    // Appends to `file_path` (created if needed). With a non-zero interval,
+    // commit() is called periodically by a background thread.
+    mutation_log(Map& m, const char* file_path,
+                 std::chrono::milliseconds commit_interval = std::chrono::milliseconds(0)) :
+        map_(m), bufs_(Map::subcnt())
+    {
+        open(file_path, false);
+        if (commit_interval.count() > 0) {
+            committer_ = std::thread([this, commit_interval]() {
+                std::unique_lock<std::mutex> l(stop_mutex_);
+                while (!stop_) {
+                    stop_cv_.wait_for(l, commit_interval);
+                    commit();
+                }
+            });
+        }
+    }
+
+    ~mutation_log() {
+        if (committer_.joinable()) {
+            {
+                std::lock_guard<std::mutex> l(stop_mutex_);
+                stop_ = true;
+            }
+            stop_cv_.notify_one();
+            committer_.join();
+        }
+        commit();
+        ::close(fd_);
+    }
+
+    mutation_log(const mutation_log&) = delete;
+    mutation_log& operator=(const mutation_log&) = delete;
+
+    // ------------------------------------------------------------------
+    // mutations, applied to the map and logged
+    // ------------------------------------------------------------------
+    // returns true if the element was inserted (an existing one is unchanged)
+    bool insert(const value_type& v) {
+        auto& buf = buffer(v.first);
+        bool inserted = false;
+        map_.lazy_emplace_l(v.first,
+                            [](value_type&) {},
+                            [&](const typename Map::constructor& ctor) {
+                                ctor(v.first, v.second);
+                                inserted = true;
+                                log_put(buf, v.first, v.second);
+                            });
+        return inserted;
+    }
+
+    // returns true if the element was inserted, false if it was assigned
+    bool insert_or_assign(const key_type& k, const mapped_type& v) {
+        auto& buf = buffer(k);
+        bool inserted = false;
+        map_.lazy_emplace_l(k,
+                            [&](value_type& e) {
+                                e.second = v;
+                                log_put(buf, k, v);
+                            },
+                            [&](const typename Map::constructor& ctor) {
+                                ctor(k, v);
+                                inserted = true;
+                                log_put(buf, k, v);
+                            });
+        return inserted;
+    }
+
+    // calls f(value_type&) if the key is present, and logs the new value
+    template <class F>
+    bool modify_if(const key_type& k, F&& f) {
+        auto& buf = buffer(k);
+        return map_.modify_if(k, [&](value_type& e) {
+            std::forward<F>(f)(e);
+            log_put(buf, e.first, e.second);
+        });
+    }
+
+    size_t erase(const key_type& k) {
+        auto& buf = buffer(k);
+        return map_.erase_if(k, [&](value_type&) {
+            log_erase(buf, k);
+            return true;
+        }) ? 1 : 0;
+    }
+
+    // ------------------------------------------------------------------
+    // Writes the records logged so far as one group, and syncs the file if
+    // `sync`. Returns false if the file could not be written (the records of
+    // this group are then lost, and the following commits fail too).
+    // ------------------------------------------------------------------
+    bool commit(bool sync = true) {
+        std::lock_guard<std::mutex> l(commit_mutex_);
+        return commit_locked(sync);
+    }
+
+    // Commits the pending records, then logs to `file_path` (truncated).
+    bool rotate(const char* file_path) {
+        std::lock_guard<std::mutex> l(commit_mutex_);
+        bool ok = commit_locked(true);
+        ::close(fd_);
+        open(file_path, true);
+        return ok;
+    }
+
+    bool good() const {
+        std::lock_guard<std::mutex> l(commit_mutex_);
+        return good_;
+    }
+
+    uint64_t file_size() const {
+        std::lock_guard<std::mutex> l(commit_mutex_);
+        return size_;
+    }
+
+    // ------------------------------------------------------------------
+    // Applies the complete groups of the log `file_path` to `m`. Returns
+    // true if the file does not exist.
+    // ------------------------------------------------------------------
+    static bool replay(Map& m, const char* file_path) {
+        int fd = ::open(file_path, O_RDONLY);
+        if (fd < 0)
+            return errno == ENOENT;
+        bool ok = true;
+        scan(fd, [&](const char* p, const char* end) {
+            while (ok && p < end) {
+                char op = *p++;
+                key_type k;
+                if (static_cast<size_t>(end - p) < sizeof(key_type)) {
+                    ok = false;
+                    break;
+                }
+                memcpy(&k, p, sizeof(key_type));
+                p += sizeof(key_type);
+                if (op == kErase) {
+                    m.erase(k);
+                } else if (op == kPut && static_cast<size_t>(end - p) >= sizeof(mapped_type)) {
+                    mapped_type v;
+                    memcpy(&v, p, sizeof(mapped_type));
+                    p += sizeof(mapped_type);
+                    m.insert_or_assign(k, v);
+                } else {
+                    ok = false;
+                }
+            }
+        });
+        ::close(fd);
+        return ok;
+    }
+
+private:
+    enum : char { kPut = 1, kErase = 2 };
+
+    static constexpr uint64_t kGroupTag = 0x7068616d70776c61ULL;
+
+    std::vector<char>& buffer(const key_type& k) {
+        return bufs_[Map::subidx(map_.hash(k))];
+    }
+
+    static void append(std::vector<char>& buf, const void* p, size_t n) {
+        const char* s = static_cast<const char*>(p);
+        buf.insert(buf.end(), s, s + n);
+    }
+
+    static void log_put(std::vector<char>& buf, const key_type& k, const mapped_type& v) {
+        buf.push_back(kPut);
+        append(buf, &k, sizeof(key_type));
+        append(buf, &v, sizeof(mapped_type));
+    }
+
+    static void log_erase(std::vector<char>& buf, const key_type& k) {
+        buf.push_back(kErase);
+        append(buf, &k, sizeof(key_type));
+    }
+
+    // Calls f(begin, end) on the payload of each complete group, and returns
+    // the file offset after the last one. A group is: tag, payload size,
+    // payload, and the bitwise negation of the payload size.
+    template <class F>
+    static uint64_t scan(int fd, F&& f) {
+        struct stat st;
+        if (::fstat(fd, &st) != 0)
+            return 0;
+        const uint64_t file_size = static_cast<uint64_t>(st.st_size);
+        FdInputArchive ar(fd, 0, size_t(1) << 20);
+        std::vector<char> payload;
+        uint64_t end = 0;
+        for (;;) {
+            uint64_t header[2], footer = 0;
+            if (!ar.loadBinary(header, sizeof(header)) || header[0] != kGroupTag ||
+                header[1] > file_size - ar.offset())
+                break;
+            payload.resize(header[1]);
+            if (!ar.loadBinary(payload.data(), payload.size()) ||
+                !ar.loadBinary(&footer, sizeof(footer)) || footer != ~header[1])
+                break;
+            f(payload.data(), payload.data() + payload.size());
+            end = ar.offset();
+        }
+        return end;
+    }
+
+    void open(const char* file_path, bool truncate) {
+        bool direct;
+        fd_ = priv::FdOpen(file_path, O_RDWR | O_CREAT | (truncate ? O_TRUNC : 0), false, direct);
+        // drop an incomplete group at the end, so that the next ones can be replayed
+        size_ = scan(fd_, [](const char*, const char*) {});
+        good_ = ::ftruncate(fd_, static_cast<off_t>(size_)) == 0;
+    }
+
+    bool commit_locked(bool sync) {
+        group_.resize(2 * sizeof(uint64_t));
+        for (size_t i = 0; i < bufs_.size(); ++i) {
+            // the submap's lock protects its buffer
+            map_.with_submap(i, [&](const typename Map::EmbeddedSet&) {
+                group_.insert(group_.end(), bufs_[i].begin(), bufs_[i].end());
+                bufs_[i].clear();
+            });
+        }
+        uint64_t header[2] = { kGroupTag, group_.size() - sizeof(header) };
+        if (header[1] == 0 || !good_)
+            return good_;
+        uint64_t footer = ~header[1];
+        memcpy(group_.data(), header, sizeof(header));
+        append(group_, &footer, sizeof(footer));
+
+        bool direct = false;
+        good_ = priv::FdWriteAt(fd_, group_.data(), group_.size(), size_, direct);
+        if (good_ && sync) {
+#if defined(__linux__)
+            good_ = ::fdatasync(fd_) == 0;
+#else
+            good_ = ::fsync(fd_) == 0;
+#endif
+        }
+        size_ += group_.size();
+        return good_;
+    }
+
+    Map&                           map_;
+    std::vector<std::vector<char>> bufs_;        // one per submap
+    std::vector<char>              group_;
+    mutable std::mutex             commit_mutex_;
+    int                            fd_ = -1;
+    uint64_t                       size_ = 0;    // end of the last group
+    bool                           good_ = true;
+
+    std::thread                    committer_;
+    std::mutex                     stop_mutex_;
+    std::condition_variable        stop_cv_;
+    bool                           stop_ = false;
+};
+
+} // namespace phmap
+
+#endif // PHMAP_HAVE_MMAP
+
+#endif // phmap_wal_h_guard_
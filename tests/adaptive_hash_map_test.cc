@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "parallel_hashmap/phmap.h"
+
+namespace {
+
+struct Large
+{
+    Large(int v = 0) { std::fill(data.begin(), data.end(), v); }
+    std::array<int, 64> data;
+
+    friend bool operator==(const Large& a, const Large& b) { return a.data == b.data; }
+};
+
+struct SmallButForcedOutOfLine
+{
+    int v;
+};
+
+} // namespace
+
+namespace phmap {
+
+template <class Key>
+struct is_value_stored_inline<Key, SmallButForcedOutOfLine> : std::false_type {};
+
+namespace priv {
+namespace {
+
+TEST(AdaptiveHashMap, StorageChoice) {
+    EXPECT_TRUE((adaptive_hash_map<int, int>::stores_values_inline));
+    EXPECT_TRUE((adaptive_hash_map<std::string, std::string>::stores_values_inline));
+    EXPECT_FALSE((adaptive_hash_map<int, Large>::stores_values_inline));
+    EXPECT_FALSE((adaptive_hash_map<int, SmallButForcedOutOfLine>::stores_values_inline));
+}
+
+TEST(AdaptiveHashMap, Inline) {
+    adaptive_hash_map<int, std::string> m = { {1, "one"}, {2, "two"} };
+    m[3] = "three";
+    EXPECT_EQ(m.size(), 3u);
+    EXPECT_EQ(m.at(2), "two");
+    EXPECT_EQ(m.erase(1), 1u);
+    EXPECT_FALSE(m.contains(1));
+}
+
+TEST(AdaptiveHashMap, OutOfLine) {
+    adaptive_hash_map<int, Large> m;
+    std::vector<const Large*> ptrs;
+    for (int i = 0; i < 5000; ++i)
+        ptrs.push_back(&m.try_emplace(i, i).first->second);
+    EXPECT_EQ(m.size(), 5000u);
+    for (int i = 0; i < 5000; ++i) {
+        auto it = m.find(i);
+        ASSERT_TRUE(it != m.end());
+        // values are never moved
+        EXPECT_EQ(&it->second, ptrs[i]);
+        EXPECT_EQ(it->second.data[63], i);
+    }
+    for (int i = 0; i < 5000; i += 2)
+        m.erase(i);
+    EXPECT_EQ(m.size(), 2500u);
+    EXPECT_EQ(m[1].data[0], 1);
+    m[2] = Large(42);
+    EXPECT_EQ(m.at(2).data[10], 42);
+
+    auto m2 = m;
+    EXPECT_TRUE(m == m2);
+    m2.insert_or_assign(1, Large(7));
+    EXPECT_TRUE(m != m2);
+
+    auto node = m2.extract(1);
+    EXPECT_EQ(node.key(), 1);
+    EXPECT_EQ(node.mapped().data[0], 7);
+    EXPECT_FALSE(m2.contains(1));
+    m2.insert(std::move(node));
+    EXPECT_TRUE(m2.contains(1));
+
+    phmap::erase_if(m2, [](const std::pair<const int, Large>& kv) { return kv.first > 10; });
+    EXPECT_EQ(m2.size(), 6u);
+}
+
+TEST(AdaptiveHashMap, OutOfLineStringKeys) {
+    adaptive_hash_map<std::string, SmallButForcedOutOfLine> m;
+    for (int i = 0; i < 1000; ++i)
+        m[std::to_string(i)].v = i;
+    m.rehash(0);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(m.at(std::to_string(i)).v, i);
+    m.clear();
+    EXPECT_TRUE(m.empty());
+}
+
+}  // namespace
+}  // namespace priv
+}  // namespace phmap
@@ -0,0 +1,184 @@
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "parallel_hashmap/phmap_compact.h"
+
+namespace phmap {
+namespace priv {
+namespace {
+
+TEST(NodeArena, ChunksAndFreeList) {
+    std::allocator<uint64_t> alloc;
+    NodeArena<uint64_t> arena;
+    std::vector<uint64_t*> ptrs;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        uint32_t idx = arena.allocate(&alloc);
+        EXPECT_EQ(idx, i);
+        *arena.get(idx) = i;
+        ptrs.push_back(arena.get(idx));
+    }
+    for (uint32_t i = 0; i < 1000; ++i) {
+        EXPECT_EQ(ptrs[i], arena.get(i));
+        EXPECT_EQ(*arena.get(i), i);
+    }
+    arena.release(17);
+    arena.release(500);
+    EXPECT_EQ(arena.allocate(&alloc), 500u);
+    EXPECT_EQ(arena.allocate(&alloc), 17u);
+    EXPECT_EQ(arena.allocate(&alloc), 1000u);
+    arena.deallocate(&alloc);
+}
+
+TEST(CompactNodeHashMap, Basic) {
+    compact_node_hash_map<int, std::string> m;
+    EXPECT_TRUE(m.empty());
+    m[1] = "one";
+    m.emplace(2, "two");
+    m.insert({3, "three"});
+    m.try_emplace(4, "four");
+    EXPECT_FALSE(m.try_emplace(4, "FOUR").second);
+    m.insert_or_assign(4, "four!");
+    EXPECT_EQ(m.size(), 4u);
+    EXPECT_EQ(m.at(1), "one");
+    EXPECT_EQ(m[2], "two");
+    EXPECT_EQ(m.find(3)->second, "three");
+    EXPECT_EQ(m.at(4), "four!");
+    EXPECT_TRUE(m.contains(4));
+    EXPECT_FALSE(m.contains(5));
+    EXPECT_EQ(m.count(5), 0u);
+    EXPECT_EQ(m.erase(2), 1u);
+    EXPECT_EQ(m.erase(2), 0u);
+    EXPECT_EQ(m.size(), 3u);
+    EXPECT_THROW(m.at(2), std::out_of_range);
+
+    size_t cnt = 0;
+    for (const auto& kv : m) {
+        EXPECT_TRUE(kv.first == 1 || kv.first == 3 || kv.first == 4);
+        ++cnt;
+    }
+    EXPECT_EQ(cnt, 3u);
+    m.clear();
+    EXPECT_TRUE(m.empty());
+    EXPECT_TRUE(m.find(1) == m.end());
+}
+
+TEST(CompactNodeHashMap, PointerStability) {
+    compact_node_hash_map<int, int> m;
+    std::vector<const std::pair<const int, int>*> ptrs;
+    for (int i = 0; i < 10000; ++i)
+        ptrs.push_back(&*m.emplace(i, i * 2).first);
+    for (int i = 0; i < 10000; ++i) {
+        auto it = m.find(i);
+        ASSERT_TRUE(it != m.end());
+        EXPECT_EQ(&*it, ptrs[i]);
+        EXPECT_EQ(it->second, i * 2);
+    }
+}
+
+TEST(CompactNodeHashMap, EraseAndReuse) {
+    compact_node_hash_map<int, int> m;
+    for (int i = 0; i < 5000; ++i)
+        m[i] = i;
+    size_t bytes = m.allocated_bytes();
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 5000; i += 2)
+            m.erase(i);
+        EXPECT_EQ(m.size(), 2500u);
+        for (int i = 0; i < 5000; i += 2)
+            m[i] = i + round;
+        EXPECT_EQ(m.size(), 5000u);
+    }
+    // erased nodes are reused, so the arena does not grow.
+    EXPECT_EQ(m.allocated_bytes(), bytes);
+    phmap::erase_if(m, [](const std::pair<const int, int>& kv) { return kv.first >= 100; });
+    EXPECT_EQ(m.size(), 100u);
+}
+
+TEST(CompactNodeHashMap, CopyMoveCompare) {
+    compact_node_hash_map<std::string, int> m1;
+    for (int i = 0; i < 1000; ++i)
+        m1[std::to_string(i)] = i;
+    compact_node_hash_map<std::string, int> m2(m1);
+    EXPECT_TRUE(m1 == m2);
+    m2["x"] = 1;
+    EXPECT_TRUE(m1 != m2);
+    compact_node_hash_map<std::string, int> m3(std::move(m2));
+    EXPECT_EQ(m3.size(), 1001u);
+    EXPECT_EQ(m3["999"], 999);
+    m2 = m3;
+    EXPECT_TRUE(m2 == m3);
+    m1.swap(m3);
+    EXPECT_EQ(m1.size(), 1001u);
+    EXPECT_EQ(m3.size(), 1000u);
+}
+
+TEST(CompactNodeHashSet, Basic) {
+    compact_node_hash_set<std::string> s = { "a", "b", "c" };
+    EXPECT_EQ(s.size(), 3u);
+    EXPECT_FALSE(s.insert("a").second);
+    EXPECT_TRUE(s.emplace("d").second);
+    EXPECT_TRUE(s.contains("d"));
+    s.erase(s.find("a"));
+    EXPECT_EQ(s.size(), 3u);
+    compact_node_hash_set<std::string> s2(s.begin(), s.end());
+    EXPECT_TRUE(s == s2);
+}
+
+TEST(CompactNodeHashMap, SmallerThanNodeHashMap) {
+    compact_node_hash_map<uint64_t, uint64_t> cm;
+    for (uint64_t i = 0; i < 100000; ++i)
+        cm[i] = i;
+    EXPECT_EQ(sizeof(compact_node_hash_map<uint64_t, uint64_t>::slot_type), 4u);
+    EXPECT_EQ(cm.size(), 100000u);
+}
+
+TEST(ParallelCompactNodeHashMap, Threads) {
+    using Map = parallel_compact_node_hash_map<int, int, phmap::priv::hash_default_hash<int>,
+                                               phmap::priv::hash_default_eq<int>,
+                                               std::allocator<std::pair<const int, int>>,
+                                               4, std::mutex>;
+    Map m;
+    const int num_threads = 4;
+    const int per_thread = 10000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&m, t]() {
+            for (int i = 0; i < per_thread; ++i)
+                m.try_emplace_l(t * per_thread + i, [](Map::value_type&) {}, i);
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+    EXPECT_EQ(m.size(), size_t(num_threads * per_thread));
+    for (int i = 0; i < num_threads * per_thread; ++i) {
+        int v = -1;
+        EXPECT_TRUE(m.if_contains(i, [&v](const Map::value_type& kv) { v = kv.second; }));
+        EXPECT_EQ(v, i % per_thread);
+    }
+    m.erase(0);
+    EXPECT_FALSE(m.contains(0));
+    EXPECT_EQ(m[1], 1);
+    Map m2(m);
+    EXPECT_TRUE(m == m2);
+}
+
+TEST(ParallelCompactNodeHashSet, Basic) {
+    parallel_compact_node_hash_set<std::string> s;
+    for (int i = 0; i < 1000; ++i)
+        s.insert(std::to_string(i));
+    EXPECT_EQ(s.size(), 1000u);
+    EXPECT_TRUE(s.contains("500"));
+    s.erase("500");
+    EXPECT_FALSE(s.contains("500"));
+    size_t cnt = 0;
+    for (auto& v : s) { (void)v; ++cnt; }
+    EXPECT_EQ(cnt, 999u);
+}
+
+}  // namespace
+}  // namespace priv
+}  // namespace phmap
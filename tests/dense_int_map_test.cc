@@ -0,0 +1,152 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "parallel_hashmap/phmap_dense.h"
+
+namespace phmap {
+namespace priv {
+namespace {
+
+template <class Set>
+std::vector<int> elems(const Set& s) {
+    return std::vector<int>(s.begin(), s.end());
+}
+
+TEST(DenseIntSet, Basic) {
+    dense_int_set<uint32_t> s = { 5, 1, 300, 64 };
+    EXPECT_EQ(s.size(), 4u);
+    EXPECT_EQ(elems(s), (std::vector<int>{1, 5, 64, 300}));  // in key order
+    EXPECT_GE(s.capacity(), 301u);
+    EXPECT_TRUE(s.insert(63).second);
+    EXPECT_FALSE(s.insert(5).second);
+    EXPECT_EQ(*s.find(300), 300u);
+    EXPECT_TRUE(s.find(2) == s.end());
+    EXPECT_TRUE(s.find(100000) == s.end());
+    EXPECT_EQ(s.count(64), 1u);
+    EXPECT_FALSE(s.contains(100000));
+    EXPECT_EQ(s.rank(64), 3u);
+    EXPECT_EQ(s.rank(1000), 5u);
+    EXPECT_EQ(s.erase(5), 1u);
+    EXPECT_EQ(s.erase(5), 0u);
+    EXPECT_EQ(*s.erase(s.find(63)), 64u);
+    EXPECT_EQ(elems(s), (std::vector<int>{1, 64, 300}));
+    EXPECT_EQ(erase_if(s, [](uint32_t k) { return k > 10; }), 2u);
+    EXPECT_EQ(elems(s), (std::vector<int>{1}));
+
+    s.rehash(0);
+    EXPECT_EQ(s.capacity(), 64u);
+    s.clear();
+    EXPECT_TRUE(s.empty());
+    EXPECT_TRUE(s.begin() == s.end());
+    s.rehash(0);
+    EXPECT_EQ(s.capacity(), 0u);
+}
+
+TEST(DenseIntSet, SmallDomain) {
+    dense_int_set<uint8_t> s;
+    for (int i = 0; i < 256; i += 3)
+        s.insert(static_cast<uint8_t>(i));
+    EXPECT_EQ(s.size(), 86u);
+    EXPECT_EQ(s.capacity(), 256u);
+    EXPECT_EQ(s.max_size(), 256u);
+    s.reserve(100000);
+    EXPECT_EQ(s.capacity(), 256u);  // the whole domain
+    EXPECT_TRUE(s.contains(255));
+}
+
+TEST(DenseIntSet, SetOperations) {
+    dense_int_set<int> a, b;
+    for (int i = 0; i < 1000; i += 2)
+        a.insert(i);
+    for (int i = 0; i < 3000; i += 3)
+        b.insert(i);
+    EXPECT_EQ(intersection_size(a, b), 167u);
+
+    auto i = set_intersection(a, b);
+    auto u = set_union(a, b);
+    auto d = set_difference(a, b);
+    EXPECT_EQ(i.size(), 167u);
+    EXPECT_EQ(u.size(), 500u + 1000u - 167u);
+    EXPECT_EQ(d.size(), 500u - 167u);
+    for (int k = 0; k < 3000; ++k) {
+        ASSERT_EQ(i.contains(k), k % 6 == 0 && k < 1000);
+        ASSERT_EQ(u.contains(k), (k % 2 == 0 && k < 1000) || k % 3 == 0);
+        ASSERT_EQ(d.contains(k), k % 2 == 0 && k % 3 != 0 && k < 1000);
+    }
+
+    auto x = a;
+    x ^= b;
+    EXPECT_EQ(x.size(), u.size() - i.size());
+    x ^= b;
+    EXPECT_TRUE(x == a);
+    EXPECT_TRUE(x != b);
+    b &= a;
+    EXPECT_TRUE(b == i);
+
+    dense_int_set<int> big(100000);
+    big.insert(10);
+    big.insert(20);
+    dense_int_set<int> small = { 10, 20 };
+    EXPECT_TRUE(big == small);  // capacities differ
+}
+
+TEST(DenseIntMap, Basic) {
+    dense_int_map<uint16_t, std::string> m = { {1, "a"}, {2, "b"} };
+    EXPECT_EQ(m.size(), 2u);
+    EXPECT_FALSE(m.insert({1, "x"}).second);
+    EXPECT_EQ(m.at(1), "a");
+    m[300] = "c";
+    m.insert_or_assign(2, "bb");
+    EXPECT_EQ(m[2], "bb");
+    EXPECT_TRUE(m.try_emplace(4, 3, 'd').second);
+    EXPECT_EQ(m.find(4)->second, "ddd");
+    EXPECT_TRUE(m.emplace(5, "e").second);
+    EXPECT_TRUE(m.emplace(std::make_pair(6, "f")).second);
+    EXPECT_TRUE(m.find(7) == m.end());
+    EXPECT_THROW(m.at(7), std::out_of_range);
+
+    std::vector<int> keys;
+    for (const auto& e : m)
+        keys.push_back(e.first);
+    EXPECT_EQ(keys, (std::vector<int>{1, 2, 4, 5, 6, 300}));
+
+    EXPECT_EQ(m.erase(300), 1u);
+    EXPECT_EQ(m.erase(300), 0u);
+    m.rehash(0);
+    EXPECT_EQ(m.capacity(), 64u);
+    EXPECT_EQ(m.at(6), "f");
+    EXPECT_EQ(erase_if(m, [](const std::pair<const uint16_t, std::string>& e) { return e.first > 2; }), 3u);
+    EXPECT_EQ(m.size(), 2u);
+}
+
+TEST(DenseIntMap, CopyMoveCompare) {
+    dense_int_map<int, std::unique_ptr<int>> m;
+    for (int i = 0; i < 1000; ++i)
+        m.emplace(i * 3, new int(i));
+    EXPECT_EQ(*m.at(2997), 999);
+    auto m2 = std::move(m);
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m2.size(), 1000u);
+    m[1].reset(new int(1));
+    EXPECT_EQ(*m.at(1), 1);
+
+    dense_int_map<int, std::string> a = { {1, "a"}, {100, "b"} };
+    dense_int_map<int, std::string> b(a);
+    EXPECT_TRUE(a == b);
+    b[100] = "c";
+    EXPECT_TRUE(a != b);
+    a = b;
+    EXPECT_EQ(a.at(100), "c");
+    a.clear();
+    EXPECT_TRUE(a.empty());
+    a.swap(b);
+    EXPECT_EQ(a.size(), 2u);
+    EXPECT_TRUE(b.empty());
+}
+
+}  // namespace
+}  // namespace priv
+}  // namespace phmap
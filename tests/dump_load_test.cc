@@ -1,7 +1,11 @@
+#include <atomic>
 #include <cstdint>
 #include <fstream>
+#include <mutex>
 #include <parallel_hashmap/phmap.h>
 #include <sstream>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -101,7 +105,597 @@ TEST(DumpLoad, ParallelFlatHashMap_uint64_uint32) {
     }
 }
 
+TEST(DumpLoad, FlatHashMap_string_uint64) {
+    phmap::flat_hash_map<std::string, uint64_t> mp1;
+    for (uint64_t i = 0; i < 10000; ++i)
+        mp1[std::to_string(i) + std::string(i % 40, 'x')] = i;
+    mp1.erase("0");
+    {
+        phmap::BinaryOutputArchive ar_out("./dump.data");
+        EXPECT_TRUE(mp1.phmap_dump(ar_out));
+    }
+
+    phmap::flat_hash_map<std::string, uint64_t> mp2 = { {"a", 1} };
+    {
+        phmap::BinaryInputArchive ar_in("./dump.data");
+        EXPECT_TRUE(mp2.phmap_load(ar_in));
+    }
+    EXPECT_TRUE(mp1 == mp2);
+    EXPECT_EQ(mp2.capacity(), mp1.capacity());
+    EXPECT_FALSE(mp2.contains("a"));
+    mp2["0"] = 0;                   // the table is usable as usual
+    EXPECT_EQ(mp2.size(), 10000u);
+
+    // truncated dump
+    std::stringstream ss;
+    {
+        phmap::BinaryOutputArchive ar_out(ss);
+        EXPECT_TRUE(mp1.phmap_dump(ar_out));
+    }
+    std::string data = ss.str();
+    std::stringstream ss2(data.substr(0, data.size() - 10));
+    phmap::BinaryInputArchive ar_in(ss2);
+    EXPECT_FALSE(mp2.phmap_load(ar_in));
+    EXPECT_TRUE(mp2.empty());
+}
+
+TEST(DumpLoad, FlatHashSet_string) {
+    phmap::flat_hash_set<std::string> st1 = { "", "hello", std::string(100, 'z') };
+    std::stringstream ss;
+    phmap::BinaryOutputArchive ar_out(ss);
+    EXPECT_TRUE(st1.phmap_dump(ar_out));
+
+    phmap::flat_hash_set<std::string> st2;
+    phmap::BinaryInputArchive ar_in(ss);
+    EXPECT_TRUE(st2.phmap_load(ar_in));
+    EXPECT_TRUE(st1 == st2);
+}
+
+TEST(DumpLoad, ParallelFlatHashMap_string_vector) {
+    using Map = phmap::parallel_flat_hash_map<std::string, std::vector<std::string>>;
+    Map mp1;
+    for (int i = 0; i < 1000; ++i)
+        for (int j = 0; j < i % 5; ++j)
+            mp1[std::to_string(i)].push_back(std::to_string(j));
+
+    std::stringstream ss;
+    phmap::BinaryOutputArchive ar_out(ss);
+    EXPECT_TRUE(mp1.phmap_dump(ar_out));
+
+    Map mp2;
+    phmap::BinaryInputArchive ar_in(ss);
+    EXPECT_TRUE(mp2.phmap_load(ar_in));
+    EXPECT_TRUE(mp1 == mp2);
+    EXPECT_EQ(mp2.at("999").size(), 4u);
+}
+
+TEST(DumpLoad, NodeHashMap_uint64_uint32) {
+    phmap::node_hash_map<uint64_t, uint32_t> mp1;
+    for (uint64_t i = 0; i < 10000; ++i)
+        mp1[i * 3] = (uint32_t)i;
+    std::stringstream ss;
+    {
+        phmap::BinaryOutputArchive ar_out(ss);
+        EXPECT_TRUE(mp1.phmap_dump(ar_out));
+    }
+    std::string data = ss.str();
+
+    phmap::node_hash_map<uint64_t, uint32_t> mp2;
+    {
+        std::stringstream ss2(data);
+        phmap::BinaryInputArchive ar_in(ss2);
+        EXPECT_TRUE(mp2.phmap_load(ar_in));
+    }
+    EXPECT_TRUE(mp1 == mp2);
+    EXPECT_EQ(mp2.capacity(), mp1.capacity());
+    const uint32_t* p = &mp2.at(300);
+    mp2.reserve(100000);
+    EXPECT_EQ(p, &mp2.at(300));     // nodes are stable as usual
+
+    // same elements and control bytes: a flat map can load the dump of a node map
+    phmap::flat_hash_map<uint64_t, uint32_t> mp3;
+    {
+        std::stringstream ss2(data);
+        phmap::BinaryInputArchive ar_in(ss2);
+        EXPECT_TRUE(mp3.phmap_load(ar_in));
+    }
+    EXPECT_EQ(mp3.size(), mp1.size());
+    EXPECT_EQ(mp3.at(2997), 999u);
+}
+
+TEST(DumpLoad, NodeHashSet_string) {
+    phmap::node_hash_set<std::string> st1 = { "a", "bb", std::string(50, 'c') };
+    std::stringstream ss;
+    phmap::BinaryOutputArchive ar_out(ss);
+    EXPECT_TRUE(st1.phmap_dump(ar_out));
+
+    phmap::node_hash_set<std::string> st2;
+    phmap::BinaryInputArchive ar_in(ss);
+    EXPECT_TRUE(st2.phmap_load(ar_in));
+    EXPECT_TRUE(st1 == st2);
+}
+
+TEST(DumpLoad, ParallelNodeHashMap_string_vector) {
+    using Map = phmap::parallel_node_hash_map<std::string, std::vector<int>>;
+    Map mp1;
+    for (int i = 0; i < 5000; ++i)
+        mp1[std::to_string(i)] = std::vector<int>(i % 7, i);
+    {
+        phmap::BinaryOutputArchive ar_out("./dump.data");
+        EXPECT_TRUE(mp1.phmap_dump(ar_out));
+    }
+
+    Map mp2;
+    {
+        phmap::BinaryInputArchive ar_in("./dump.data");
+        EXPECT_TRUE(mp2.phmap_load(ar_in));
+    }
+    EXPECT_TRUE(mp1 == mp2);
+
+    phmap::parallel_node_hash_set<uint32_t> st1;
+    for (uint32_t i = 0; i < 5000; ++i)
+        st1.insert(i);
+    {
+        phmap::BinaryOutputArchive ar_out("./dump.data");
+        EXPECT_TRUE(st1.phmap_dump(ar_out));
+    }
+    phmap::parallel_node_hash_set<uint32_t> st2;
+    {
+        phmap::BinaryInputArchive ar_in("./dump.data");
+        EXPECT_TRUE(st2.phmap_load(ar_in));
+    }
+    EXPECT_TRUE(st1 == st2);
 }
+
+TEST(DumpLoad, ParallelFlatHashMap_dump_async) {
+    using Map = phmap::parallel_flat_hash_map<uint64_t, uint64_t, phmap::Hash<uint64_t>,
+                                             phmap::EqualTo<uint64_t>,
+                                             std::allocator<std::pair<const uint64_t, uint64_t>>,
+                                             4, std::mutex>;
+    const uint64_t n = 100000;
+    Map mp1;
+    for (uint64_t i = 0; i < n; ++i)
+        mp1.emplace(i, i);
+
+    // writers keep modifying the map during the dump
+    std::atomic<bool> stop(false);
+    std::thread writer([&]() {
+        for (uint64_t i = n; !stop; ++i) {
+            mp1.emplace(i, i);
+            mp1.erase(i - n);
+        }
+    });
+
+    std::stringstream ss;
+    phmap::BinaryOutputArchive ar_out(ss);
+    std::vector<size_t> progress;
+    int done = -1;
+    auto res = mp1.dump_async(ar_out,
+                              [&](size_t i, size_t cnt) { EXPECT_EQ(cnt, mp1.subcnt()); progress.push_back(i); },
+                              [&](bool ok) { done = ok; });
+    EXPECT_TRUE(res.get());
+    stop = true;
+    writer.join();
+    EXPECT_EQ(done, 1);
+    ASSERT_EQ(progress.size(), mp1.subcnt());
+    EXPECT_EQ(progress.back(), mp1.subcnt());
+
+    Map mp2;
+    phmap::BinaryInputArchive ar_in(ss);
+    EXPECT_TRUE(mp2.phmap_load(ar_in));
+    EXPECT_GT(mp2.size(), 0u);
+    for (const auto& v : mp2)
+        EXPECT_EQ(v.first, v.second);
 }
+
+TEST(DumpLoad, ParallelFlatHashMap_delta) {
+    using Map = phmap::parallel_flat_hash_map<uint64_t, uint64_t, phmap::Hash<uint64_t>,
+                                             phmap::EqualTo<uint64_t>,
+                                             std::allocator<std::pair<const uint64_t, uint64_t>>,
+                                             4, std::mutex>;
+    Map mp1;
+    for (uint64_t i = 0; i < 10000; ++i)
+        mp1.emplace(i, i);
+
+    std::stringstream base, deltas;
+    size_t since = mp1.advance_epoch();
+    {
+        phmap::BinaryOutputArchive ar_out(base);
+        EXPECT_TRUE(mp1.phmap_dump(ar_out));
+    }
+    const size_t base_size = base.str().size();
+
+    phmap::BinaryOutputArchive ar_out(deltas);
+    {
+        // nothing modified
+        size_t next = mp1.advance_epoch();
+        EXPECT_TRUE(mp1.dump_delta(ar_out, since));
+        EXPECT_EQ(deltas.str().size(), 3 * sizeof(size_t));
+        since = next;
+    }
+    {
+        mp1.erase(3);
+        mp1.modify_if(4, [](Map::value_type& v) { v.second = 44; });
+        size_t next = mp1.advance_epoch();
+        EXPECT_TRUE(mp1.dump_delta(ar_out, since));
+        EXPECT_LT(deltas.str().size(), base_size / 4);
+        since = next;
+    }
+    {
+        mp1[20000] = 1;
+        mp1.try_emplace_l(5, [](Map::value_type& v) { v.second = 55; });
+        mp1.if_contains(6, [](const Map::value_type&) {});  // not a modification
+        size_t next = mp1.advance_epoch();
+        EXPECT_TRUE(mp1.dump_delta(ar_out, since));
+        since = next;
+    }
+
+    Map mp2;
+    {
+        phmap::BinaryInputArchive ar_in(base);
+        EXPECT_TRUE(mp2.phmap_load(ar_in));
+    }
+    EXPECT_FALSE(mp1 == mp2);
+    phmap::BinaryInputArchive ar_in(deltas);
+    EXPECT_TRUE(mp2.load_deltas(ar_in));
+    EXPECT_TRUE(mp1 == mp2);
+    EXPECT_EQ(mp2.at(4), 44u);
+    EXPECT_EQ(mp2.at(5), 55u);
+    EXPECT_FALSE(mp2.contains(3));
+
+    // a full dump is not a delta
+    Map mp3;
+    std::stringstream ss(base.str());
+    phmap::BinaryInputArchive ar_base(ss);
+    EXPECT_FALSE(mp3.load_deltas(ar_base));
 }
 
+// stores the data as is
+struct CopyCodec {
+    void encode(const char* p, size_t n, size_t, std::vector<char>& out) const {
+        out.insert(out.end(), p, p + n);
+    }
+    bool decode(const char* p, size_t n, char* out, size_t out_size, size_t) const {
+        if (n != out_size)
+            return false;
+        std::copy(p, p + n, out);
+        return true;
+    }
+};
+
+TEST(DumpLoad, CompressedArchive) {
+    phmap::flat_hash_map<uint64_t, uint32_t> mp1;
+    mp1.reserve(1 << 18);
+    for (uint64_t i = 0; i < 50000; ++i)
+        mp1.emplace(i * 7, (uint32_t)(i % 1000));
+
+    std::stringstream raw, packed;
+    {
+        phmap::BinaryOutputArchive ar_out(raw);
+        EXPECT_TRUE(mp1.phmap_dump(ar_out));
+    }
+    {
+        phmap::BinaryOutputArchive file_out(packed);
+        phmap::CompressedOutputArchive<phmap::BinaryOutputArchive> ar_out(file_out, 1 << 16);
+        EXPECT_TRUE(mp1.phmap_dump(ar_out));
+        EXPECT_TRUE(ar_out.flush());
+    }
+    EXPECT_LT(packed.str().size(), raw.str().size() / 4);
+
+    phmap::flat_hash_map<uint64_t, uint32_t> mp2;
+    {
+        std::stringstream ss(packed.str());
+        phmap::BinaryInputArchive file_in(ss);
+        phmap::CompressedInputArchive<phmap::BinaryInputArchive> ar_in(file_in);
+        EXPECT_TRUE(mp2.phmap_load(ar_in));
+    }
+    EXPECT_TRUE(mp1 == mp2);
+    EXPECT_EQ(mp1.capacity(), mp2.capacity());
+
+    // corrupted
+    {
+        std::string data = packed.str();
+        data[data.size() / 2] ^= 0x55;
+        data.resize(data.size() - 10);
+        std::stringstream ss(data);
+        phmap::BinaryInputArchive file_in(ss);
+        phmap::CompressedInputArchive<phmap::BinaryInputArchive> ar_in(file_in);
+        EXPECT_FALSE(mp2.phmap_load(ar_in));
+    }
+}
+
+TEST(DumpLoad, CompressedArchive_parallel) {
+    using Map = phmap::parallel_flat_hash_map<uint64_t, uint64_t, phmap::Hash<uint64_t>,
+                                             phmap::EqualTo<uint64_t>,
+                                             std::allocator<std::pair<const uint64_t, uint64_t>>,
+                                             4, std::mutex>;
+    Map mp1;
+    for (uint64_t i = 0; i < 20000; ++i)
+        mp1.emplace(i, i * 3);
+
+    // phmap_dump(), then dump_async() whose tables are plain data
+    std::stringstream ss;
+    {
+        phmap::BinaryOutputArchive file_out(ss);
+        phmap::CompressedOutputArchive<phmap::BinaryOutputArchive, CopyCodec> ar_out(file_out);
+        EXPECT_TRUE(ar_out.saveBinary(mp1));
+        EXPECT_TRUE(mp1.dump_async(ar_out).get());
+    }
+    phmap::BinaryInputArchive file_in(ss);
+    phmap::CompressedInputArchive<phmap::BinaryInputArchive, CopyCodec> ar_in(file_in);
+    Map mp2, mp3;
+    EXPECT_TRUE(ar_in.loadBinary(&mp2));
+    EXPECT_TRUE(mp1 == mp2);
+    EXPECT_TRUE(mp3.phmap_load(ar_in));
+    EXPECT_TRUE(mp1 == mp3);
+
+    // the elements with a blob section go through the codec as plain data
+    phmap::parallel_flat_hash_map<std::string, std::vector<int>> mp4, mp5;
+    for (int i = 0; i < 1000; ++i)
+        mp4[std::to_string(i)] = std::vector<int>(i % 5, i);
+    std::stringstream ss2;
+    {
+        phmap::BinaryOutputArchive file_out(ss2);
+        phmap::CompressedOutputArchive<phmap::BinaryOutputArchive> ar_out(file_out, 100);
+        EXPECT_TRUE(mp4.phmap_dump(ar_out));
+    }
+    phmap::BinaryInputArchive file_in2(ss2);
+    phmap::CompressedInputArchive<phmap::BinaryInputArchive> ar_in2(file_in2);
+    EXPECT_TRUE(mp5.phmap_load(ar_in2));
+    EXPECT_TRUE(mp4 == mp5);
+}
+
+#if PHMAP_HAVE_MMAP
+
+TEST(DumpLoad, MappedFlatHashMap) {
+    phmap::flat_hash_map<uint64_t, uint32_t> mp1;
+    for (uint64_t i = 0; i < 100000; ++i)
+        mp1[i * 7] = (uint32_t)i;
+    for (uint64_t i = 0; i < 100000; i += 3)
+        mp1.erase(i * 7);
+    {
+        phmap::BinaryOutputArchive ar_out("./dump.data");
+        EXPECT_TRUE(mp1.phmap_dump(ar_out));
+    }
+
+    phmap::mapped_flat_hash_map<uint64_t, uint32_t> mp2("./dump.data");
+    EXPECT_TRUE(mp2.in_place());
+    EXPECT_EQ(mp2.size(), mp1.size());
+    EXPECT_EQ(mp2.capacity(), mp1.capacity());
+    for (uint64_t i = 0; i < 100000; ++i) {
+        auto it = mp2.find(i * 7);
+        ASSERT_EQ(it != mp2.end(), i % 3 != 0);
+        if (it != mp2.end()) {
+            EXPECT_EQ(it->second, (uint32_t)i);
+        }
+        EXPECT_FALSE(mp2.contains(i * 7 + 1));
+    }
+    EXPECT_EQ(mp2.at(7), 1u);
+    EXPECT_THROW(mp2.at(8), std::out_of_range);
+
+    size_t cnt = 0;
+    for (const auto& e : mp2) {
+        EXPECT_EQ(mp1.at(e.first), e.second);
+        ++cnt;
+    }
+    EXPECT_EQ(cnt, mp1.size());
+}
+
+TEST(DumpLoad, MappedFlatHashSet) {
+    // capacity 3: the slots are not aligned in the file, and are copied
+    phmap::flat_hash_set<uint64_t> st1 = { 1991, 1202 };
+    {
+        phmap::BinaryOutputArchive ar_out("./dump.data");
+        EXPECT_TRUE(st1.phmap_dump(ar_out));
+    }
+    {
+        phmap::mapped_flat_hash_set<uint64_t> st2("./dump.data");
+        EXPECT_FALSE(st2.in_place());
+        EXPECT_EQ(st2.size(), 2u);
+        EXPECT_EQ(st2.count(1991), 1u);
+        EXPECT_EQ(st2.count(1992), 0u);
+    }
+
+    st1.clear();
+    {
+        phmap::BinaryOutputArchive ar_out("./dump.data");
+        EXPECT_TRUE(st1.phmap_dump(ar_out));
+    }
+    phmap::mapped_flat_hash_set<uint64_t> st3("./dump.data");
+    EXPECT_TRUE(st3.empty());
+    EXPECT_TRUE(st3.begin() == st3.end());
+    EXPECT_FALSE(st3.contains(1991));
+}
+
+TEST(DumpLoad, MappedParallelFlatHashMap) {
+    phmap::parallel_flat_hash_map<uint64_t, uint32_t> mp1;
+    for (uint64_t i = 0; i < 100000; ++i)
+        mp1[i] = (uint32_t)(i * 2);
+    {
+        phmap::BinaryOutputArchive ar_out("./dump.data");
+        EXPECT_TRUE(mp1.phmap_dump(ar_out));
+    }
+
+    phmap::mapped_parallel_flat_hash_map<uint64_t, uint32_t> mp2("./dump.data");
+    EXPECT_TRUE(mp2.in_place());
+    EXPECT_EQ(mp2.size(), mp1.size());
+    for (uint64_t i = 0; i < 100000; ++i)
+        ASSERT_EQ(mp2.at(i), (uint32_t)(i * 2));
+    EXPECT_EQ(std::distance(mp2.begin(), mp2.end()), (ptrdiff_t)mp1.size());
+
+    // wrong number of submaps
+    using Mapped5 = phmap::mapped_parallel_flat_hash_map<uint64_t, uint32_t, phmap::Hash<uint64_t>,
+                                                         phmap::EqualTo<uint64_t>, 5>;
+    EXPECT_THROW(Mapped5("./dump.data"), std::runtime_error);
+
+    {
+        std::ofstream os("./dump.data", std::ofstream::trunc | std::ofstream::binary);
+        os << "not a dump";
+    }
+    using Mapped = phmap::mapped_flat_hash_map<uint64_t, uint32_t>;
+    EXPECT_THROW(Mapped("./dump.data"), std::runtime_error);
+}
+
+TEST(DumpLoad, FdArchive) {
+    phmap::flat_hash_map<uint64_t, uint32_t> mp1;
+    for (uint64_t i = 0; i < 100000; ++i)
+        mp1.emplace(i * 7, (uint32_t)i);
+
+    std::stringstream ss;
+    phmap::BinaryOutputArchive ar_ss(ss);
+    EXPECT_TRUE(mp1.phmap_dump(ar_ss));
+    const size_t dump_size = ss.str().size();
+
+    for (bool direct : { false, true }) {
+        {
+            // small buffer, so that it is flushed many times
+            phmap::FdOutputArchive ar_out("./dump.data", direct, 1 << 16);
+            EXPECT_TRUE(mp1.phmap_dump(ar_out));
+            EXPECT_EQ(ar_out.offset(), dump_size);
+            EXPECT_TRUE(ar_out.close());
+        }
+        std::ifstream is("./dump.data", std::ifstream::binary | std::ifstream::ate);
+        EXPECT_EQ(static_cast<size_t>(is.tellg()), dump_size);
+
+        phmap::flat_hash_map<uint64_t, uint32_t> mp2;
+        {
+            phmap::FdInputArchive ar_in("./dump.data", direct, 1 << 16);
+            EXPECT_TRUE(mp2.phmap_load(ar_in));
+            EXPECT_EQ(ar_in.offset(), dump_size);
+        }
+        EXPECT_TRUE(mp1 == mp2);
+    }
+
+    {
+        phmap::flat_hash_map<std::string, std::vector<int>> mp3 = { {"a", {1, 2}}, {"b", {}} }, mp4;
+        {
+            phmap::FdOutputArchive ar_out("./dump.data");
+            EXPECT_TRUE(ar_out.saveBinary(mp3));
+        }
+        phmap::FdInputArchive ar_in("./dump.data");
+        EXPECT_TRUE(ar_in.loadBinary(&mp4));
+        EXPECT_TRUE(mp3 == mp4);
+
+        uint64_t past_end;
+        EXPECT_FALSE(ar_in.loadBinary(&past_end));
+        EXPECT_FALSE(ar_in.good());
+    }
+}
+
+TEST(DumpLoad, FdArchive_Concurrent) {
+    // dumps of several maps written and read concurrently at their offsets in one file
+    using Map = phmap::flat_hash_map<uint64_t, uint64_t>;
+    const size_t num_maps = 4;
+    std::vector<Map> maps(num_maps);
+    std::vector<uint64_t> offsets(num_maps + 1, 0);
+    for (size_t i = 0; i < num_maps; ++i) {
+        for (uint64_t j = 0; j < 10000 * (i + 1); ++j)
+            maps[i].emplace(j, j + i);
+        std::stringstream ss;
+        phmap::BinaryOutputArchive ar(ss);
+        maps[i].phmap_dump(ar);
+        offsets[i + 1] = offsets[i] + ss.str().size();
+    }
+
+    int fd = ::open("./dump.data", O_RDWR | O_CREAT | O_TRUNC, 0644);
+    ASSERT_GE(fd, 0);
+
+    std::vector<Map> loaded(num_maps);
+    std::vector<int> ok(num_maps, 0);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_maps; ++i)
+        threads.emplace_back([&, i]() {
+            phmap::FdOutputArchive ar(fd, offsets[i], 1 << 16);
+            ok[i] = maps[i].phmap_dump(ar) && ar.close() && ar.offset() == offsets[i + 1];
+        });
+    for (auto& t : threads)
+        t.join();
+    threads.clear();
+
+    for (size_t i = 0; i < num_maps; ++i)
+        threads.emplace_back([&, i]() {
+            phmap::FdInputArchive ar(fd, offsets[i], 1 << 16);
+            ok[i] += loaded[i].phmap_load(ar) && ar.offset() == offsets[i + 1];
+        });
+    for (auto& t : threads)
+        t.join();
+    ::close(fd);
+
+    for (size_t i = 0; i < num_maps; ++i) {
+        EXPECT_EQ(ok[i], 2);
+        EXPECT_TRUE(loaded[i] == maps[i]);
+    }
+}
+
+template <size_t N>
+using ChunkedMap = phmap::parallel_flat_hash_map<uint64_t, uint32_t, phmap::Hash<uint64_t>,
+                                                 phmap::EqualTo<uint64_t>,
+                                                 std::allocator<std::pair<const uint64_t, uint32_t>>,
+                                                 N, std::mutex>;
+
+template <class Map1, class Map2>
+void ExpectSameElements(const Map1& m1, const Map2& m2) {
+    EXPECT_EQ(m1.size(), m2.size());
+    for (const auto& v : m1) {
+        auto it = m2.find(v.first);
+        ASSERT_TRUE(it != m2.end());
+        EXPECT_TRUE(it->second == v.second);
+    }
+}
+
+TEST(DumpLoad, ParallelFlatHashMap_chunked) {
+    ChunkedMap<4> mp1;
+    for (uint64_t i = 0; i < 100000; ++i)
+        mp1.emplace(i * 11, (uint32_t)i);
+    EXPECT_TRUE(mp1.phmap_dump_chunked("./dump.data", 3));
+
+    ChunkedMap<4> mp2;
+    mp2.emplace(5, 5);                          // replaced by the load
+    EXPECT_TRUE(mp2.phmap_load_chunked("./dump.data"));
+    EXPECT_TRUE(mp1 == mp2);
+
+    // resharded: more, then fewer submaps
+    ChunkedMap<6> mp3;
+    EXPECT_TRUE(mp3.phmap_load_chunked("./dump.data", 5));
+    ExpectSameElements(mp1, mp3);
+    mp3.emplace(1, 1);
+    EXPECT_TRUE(mp3.phmap_dump_chunked("./dump.data"));
+
+    ChunkedMap<2> mp4;
+    EXPECT_TRUE(mp4.phmap_load_chunked("./dump.data", 1));
+    ExpectSameElements(mp3, mp4);
+
+    // not a chunked dump
+    {
+        phmap::BinaryOutputArchive ar_out("./dump.data");
+        EXPECT_TRUE(mp1.phmap_dump(ar_out));
+    }
+    EXPECT_FALSE(mp4.phmap_load_chunked("./dump.data"));
+    EXPECT_EQ(mp4.size(), mp3.size());
+}
+
+TEST(DumpLoad, ParallelNodeHashMap_chunked) {
+    using Map1 = phmap::parallel_node_hash_map<std::string, std::vector<int>>;
+    using Map2 = phmap::parallel_node_hash_map<std::string, std::vector<int>,
+                                               phmap::Hash<std::string>, phmap::EqualTo<std::string>,
+                                               std::allocator<std::pair<const std::string, std::vector<int>>>,
+                                               5>;
+    Map1 mp1;
+    for (int i = 0; i < 5000; ++i)
+        mp1[std::to_string(i)] = std::vector<int>(i % 7, i);
+    EXPECT_TRUE(mp1.phmap_dump_chunked("./dump.data"));
+
+    Map2 mp2;
+    EXPECT_TRUE(mp2.phmap_load_chunked("./dump.data"));
+    ExpectSameElements(mp1, mp2);
+
+    // truncated file
+    EXPECT_EQ(::truncate("./dump.data", 100), 0);
+    EXPECT_FALSE(mp2.phmap_load_chunked("./dump.data"));
+}
+
+#endif // PHMAP_HAVE_MMAP
+
+}
+}
+}
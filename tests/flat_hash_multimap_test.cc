@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "parallel_hashmap/phmap_multimap.h"
+
+namespace phmap {
+namespace priv {
+namespace {
+
+TEST(FlatHashMultimap, EmplaceAndEqualRange) {
+    flat_hash_multimap<int, std::string> m;
+    EXPECT_TRUE(m.empty());
+    m.emplace(1, "a");
+    m.emplace(2, "b");
+    m.emplace(1, "c");
+    m.insert({1, "d"});
+    EXPECT_EQ(m.size(), 4u);
+    EXPECT_EQ(m.key_count(), 2u);
+    EXPECT_EQ(m.count(1), 3u);
+    EXPECT_EQ(m.count(2), 1u);
+    EXPECT_EQ(m.count(3), 0u);
+    EXPECT_TRUE(m.contains(2));
+    EXPECT_FALSE(m.contains(3));
+
+    auto r = m.equal_range(1);
+    EXPECT_EQ(std::vector<std::string>(r.first, r.second),
+              (std::vector<std::string>{"a", "c", "d"}));
+    auto none = m.equal_range(3);
+    EXPECT_EQ(none.first, none.second);
+}
+
+TEST(FlatHashMultimap, ManyKeysAndValues) {
+    flat_hash_multimap<int, int> m;
+    for (int v = 0; v < 50; ++v)
+        for (int k = 0; k < 500; ++k)
+            m.emplace(k, k * 1000 + v);
+    EXPECT_EQ(m.size(), 25000u);
+    EXPECT_EQ(m.key_count(), 500u);
+    for (int k = 0; k < 500; ++k) {
+        auto r = m.equal_range(k);
+        ASSERT_EQ(r.second - r.first, 50);
+        for (int v = 0; v < 50; ++v)
+            EXPECT_EQ(r.first[v], k * 1000 + v);  // insertion order is kept
+    }
+
+    for (int k = 0; k < 500; k += 2)
+        EXPECT_EQ(m.erase(k), 50u);
+    EXPECT_EQ(m.erase(0), 0u);
+    EXPECT_EQ(m.size(), 12500u);
+
+    // reuses the space of the erased runs
+    for (int k = 1; k < 500; k += 2)
+        m.emplace(k, -1);
+    for (int k = 1; k < 500; k += 2) {
+        auto r = m.equal_range(k);
+        ASSERT_EQ(r.second - r.first, 51);
+        EXPECT_EQ(r.first[0], k * 1000);
+        EXPECT_EQ(r.first[50], -1);
+    }
+
+    size_t n = 0;
+    m.for_each([&](int k, int& v) { EXPECT_EQ(k & 1, 1); ++n; ++v; });
+    EXPECT_EQ(n, m.size());
+    EXPECT_EQ(*m.equal_range(1).first, 1001);
+}
+
+TEST(FlatHashMultimap, Append) {
+    flat_hash_multimap<std::string, int> m;
+    std::vector<int> v(100);
+    for (int i = 0; i < 100; ++i)
+        v[i] = i;
+    m.append("x", v.begin(), v.end());
+    m.append("y", {1, 2, 3});
+    m.append("x", v.begin(), v.begin() + 10);
+    m.append("z", v.begin(), v.begin());
+    EXPECT_EQ(m.count("x"), 110u);
+    EXPECT_EQ(m.count("y"), 3u);
+    EXPECT_FALSE(m.contains("z"));
+    EXPECT_EQ(m.size(), 113u);
+    auto r = m.equal_range("x");
+    EXPECT_EQ(r.first[99], 99);
+    EXPECT_EQ(r.first[109], 9);
+}
+
+TEST(FlatHashMultimap, MoveOnlyValues) {
+    flat_hash_multimap<int, std::unique_ptr<int>> m;
+    for (int i = 0; i < 1000; ++i)
+        m.emplace(i % 10, new int(i));
+    auto r = m.equal_range(3);
+    ASSERT_EQ(r.second - r.first, 100);
+    EXPECT_EQ(*r.first[99], 993);
+
+    auto m2 = std::move(m);
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m2.size(), 1000u);
+    m2.clear();
+    EXPECT_TRUE(m2.empty());
+    m2.emplace(1, new int(1));
+    EXPECT_EQ(*m2.equal_range(1).first[0], 1);
+}
+
+TEST(FlatHashMultimap, CopyAndCompare) {
+    flat_hash_multimap<int, std::string> m = { {1, "a"}, {2, "b"}, {1, "c"} };
+    flat_hash_multimap<int, std::string> m2(m);
+    EXPECT_TRUE(m == m2);
+    m2.emplace(2, "d");
+    EXPECT_TRUE(m != m2);
+    m = m2;
+    EXPECT_TRUE(m == m2);
+    EXPECT_EQ(m.count(2), 2u);
+
+    flat_hash_multimap<int, std::string> m3 = { {1, "c"}, {1, "a"}, {2, "b"} };
+    m2.erase(2);
+    m2.emplace(2, "b");
+    EXPECT_TRUE(m3 != m2);  // values are compared in order
+
+    m.reserve(100, 1000);
+    EXPECT_EQ(m.count(1), 2u);
+}
+
+TEST(FlatHashMultiset, Basic) {
+    flat_hash_multiset<std::string> s = { "a", "b", "a", "c", "a" };
+    EXPECT_EQ(s.size(), 5u);
+    EXPECT_EQ(s.key_count(), 3u);
+    EXPECT_EQ(s.count("a"), 3u);
+    EXPECT_EQ(s.insert("b", 4), 5u);
+    EXPECT_EQ(s.size(), 9u);
+    EXPECT_TRUE(s.erase_one("c"));
+    EXPECT_FALSE(s.contains("c"));
+    EXPECT_FALSE(s.erase_one("c"));
+    EXPECT_EQ(s.erase("a"), 3u);
+    EXPECT_EQ(s.erase("a"), 0u);
+    EXPECT_EQ(s.size(), 5u);
+
+    size_t total = 0;
+    s.for_each([&](const std::string& v, size_t n) { EXPECT_EQ(v, "b"); total += n; });
+    EXPECT_EQ(total, 5u);
+
+    flat_hash_multiset<std::string> s2(s);
+    EXPECT_TRUE(s == s2);
+    s2.insert("b");
+    EXPECT_TRUE(s != s2);
+}
+
+TEST(ParallelFlatHashMultimap, Basic) {
+    parallel_flat_hash_multimap<int, int> m = { {1, 10}, {2, 20}, {1, 11} };
+    m.append(3, {30, 31, 32});
+    EXPECT_EQ(m.size(), 6u);
+    EXPECT_EQ(m.key_count(), 3u);
+    EXPECT_EQ(m.count(3), 3u);
+    EXPECT_TRUE(m.contains(2));
+
+    std::vector<int> vals;
+    EXPECT_TRUE(m.with_values(1, [&](const int* first, const int* last) { vals.assign(first, last); }));
+    EXPECT_EQ(vals, (std::vector<int>{10, 11}));
+    EXPECT_FALSE(m.with_values(4, [](const int*, const int*) {}));
+    EXPECT_TRUE(m.with_values_m(2, [](int* first, int*) { *first = 21; }));
+
+    int sum = 0;
+    m.for_each([&](int, int v) { sum += v; });
+    EXPECT_EQ(sum, 10 + 11 + 21 + 30 + 31 + 32);
+
+    auto m2 = m;
+    EXPECT_TRUE(m == m2);
+    EXPECT_EQ(m2.erase(3), 3u);
+    EXPECT_TRUE(m != m2);
+
+    size_t n = 0;
+    for (size_t i = 0; i < m.subcnt(); ++i)
+        m.with_submap(i, [&](const decltype(m)::EmbeddedMap& sub) { n += sub.size(); });
+    EXPECT_EQ(n, 6u);
+}
+
+TEST(ParallelFlatHashMultimap, Threads) {
+    parallel_flat_hash_multimap<int, int, phmap::Hash<int>, phmap::EqualTo<int>,
+                                std::allocator<std::pair<const int, int>>, 4, std::mutex> m;
+    const int num_threads = 4;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t)
+        threads.emplace_back([&m, t]() {
+            for (int i = 0; i < 10000; ++i)
+                m.emplace(i % 1000, t);
+        });
+    for (auto& th : threads)
+        th.join();
+    EXPECT_EQ(m.size(), 40000u);
+    EXPECT_EQ(m.key_count(), 1000u);
+    m.with_values(7, [](const int* first, const int* last) {
+        EXPECT_EQ(last - first, 40);
+        EXPECT_EQ(std::count(first, last, 2), 10);
+    });
+}
+
+}  // namespace
+}  // namespace priv
+}  // namespace phmap
@@ -128,6 +128,37 @@ TEST(THIS_TEST_NAME, MergeExtractInsert) {
   EXPECT_THAT(set2, UnorderedElementsAre(Pointee(7), Pointee(23)));
 }
 
+TEST(THIS_TEST_NAME, SetAlgebra) {
+  using S = phmap::THIS_HASH_SET<int>;
+  S a, b;
+  for (int i = 0; i < 1000; ++i) a.insert(i);        // [0, 1000)
+  for (int i = 500; i < 3000; ++i) b.insert(i);      // [500, 3000)
+
+  EXPECT_EQ(intersection_size(a, b), 500u);
+  EXPECT_EQ(intersection_size(b, a), 500u);
+  EXPECT_EQ(intersection_size(a, a), a.size());
+
+  S i = set_intersection(a, b);
+  EXPECT_EQ(i.size(), 500u);
+  for (int k = 500; k < 1000; ++k) EXPECT_TRUE(i.contains(k));
+
+  S u = set_union(a, b);
+  EXPECT_EQ(u.size(), 3000u);
+  for (int k = 0; k < 3000; ++k) EXPECT_TRUE(u.contains(k));
+
+  S d1 = set_difference(a, b);  // iterates a
+  EXPECT_EQ(d1.size(), 500u);
+  for (int k = 0; k < 500; ++k) EXPECT_TRUE(d1.contains(k));
+
+  S d2 = set_difference(b, a);  // erases a from a copy of b
+  EXPECT_EQ(d2.size(), 2000u);
+  for (int k = 1000; k < 3000; ++k) EXPECT_TRUE(d2.contains(k));
+
+  EXPECT_TRUE(set_difference(a, a).empty());
+  EXPECT_TRUE(set_intersection(a, S()).empty());
+  EXPECT_TRUE(set_union(a, S()) == a);
+}
+
 }  // namespace
 }  // namespace priv
 }  // namespace phmap
@@ -0,0 +1,315 @@
+#include <array>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "parallel_hashmap/phmap.h"
+
+struct Digest {
+    uint8_t bytes[32];
+    bool operator==(const Digest& o) const { return std::equal(bytes, bytes + 32, o.bytes); }
+};
+
+struct Padded {
+    uint8_t  a;
+    uint32_t b;
+    bool operator==(const Padded& o) const { return a == o.a && b == o.b; }
+};
+
+struct Person {
+    std::string first, last;
+    int         age;
+    bool operator==(const Person& o) const { return first == o.first && last == o.last && age == o.age; }
+
+    template <class H>
+    friend H AbslHashValue(H h, const Person& p) {
+        return H::combine(std::move(h), p.first, p.last, p.age);
+    }
+};
+
+struct Point {
+    uint32_t x, y;
+    bool operator==(const Point& o) const { return x == o.x && y == o.y; }
+
+    friend size_t hash_value(const Point& p) { return phmap::HashState().combine(0, p.x, p.y); }
+};
+
+namespace phmap {
+template <> struct is_uniquely_represented<Digest> : std::true_type {};
+}
+
+namespace std {
+template <> struct hash<Padded> {
+    size_t operator()(const Padded& p) const { return p.a ^ (size_t(p.b) << 8); }
+};
+}
+
+namespace phmap {
+namespace priv {
+namespace {
+
+TEST(HashBytes, AllLengths) {
+    // every length of each code path (0, 1-3, 4-16, 17-48, > 48) gives distinct hashes,
+    // and each byte of the input matters
+    std::string s(200, 'a');
+    phmap::flat_hash_set<uint64_t> hashes;
+    for (size_t len = 0; len <= s.size(); ++len) {
+        uint64_t h = phmap::hash_bytes(s.data(), len);
+        EXPECT_EQ(h, phmap::hash_bytes(s.data(), len));
+        EXPECT_TRUE(hashes.insert(h).second) << len;
+        for (size_t i = 0; i < len; ++i) {
+            std::string t = s.substr(0, len);
+            t[i] = 'b';
+            EXPECT_NE(phmap::hash_bytes(t.data(), len), h) << len << " " << i;
+        }
+    }
+    EXPECT_NE(phmap::hash_bytes(s.data(), 10, 1), phmap::hash_bytes(s.data(), 10, 2));
+
+    // unaligned input
+    std::vector<char> buf(s.size() + 8);
+    for (size_t off = 1; off < 8; ++off) {
+        std::copy(s.begin(), s.end(), buf.begin() + off);
+        EXPECT_EQ(phmap::hash_bytes(buf.data() + off, 100), phmap::hash_bytes(s.data(), 100));
+    }
+}
+
+TEST(HashBytes, Avalanche) {
+    // flipping one input bit flips about half of the output bits
+    uint64_t key[4] = { 1, 2, 3, 4 };
+    const uint64_t h = phmap::hash_bytes(key, sizeof(key));
+    int total = 0, count = 0;
+    for (int bit = 0; bit < 256; ++bit) {
+        key[bit / 64] ^= uint64_t(1) << (bit % 64);
+        uint64_t d = h ^ phmap::hash_bytes(key, sizeof(key));
+        key[bit / 64] ^= uint64_t(1) << (bit % 64);
+        int flipped = 0;
+        for (; d; d &= d - 1)
+            ++flipped;
+        EXPECT_GT(flipped, 10);
+        total += flipped;
+        ++count;
+    }
+    EXPECT_NEAR(double(total) / count, 32.0, 2.0);
+}
+
+TEST(HashBytes, Strings) {
+    const std::string s = "http://www.example.com/some/path?query=1";
+    EXPECT_EQ(phmap::Hash<std::string>()(s), hash_key_bytes(s.data(), s.size()));
+    EXPECT_NE(phmap::Hash<std::string>()(s), phmap::Hash<std::string>()(s + "2"));
+
+    const std::u16string u = u"some text";
+    const std::wstring w = L"some text";
+    EXPECT_EQ(phmap::Hash<std::u16string>()(u),
+              phmap::Hash<std::string>()(std::string(reinterpret_cast<const char*>(u.data()),
+                                                     u.size() * sizeof(char16_t))));
+    EXPECT_NE(phmap::Hash<std::wstring>()(w), phmap::Hash<std::string>()("some text"));
+
+#if PHMAP_HAVE_STD_STRING_VIEW
+    // same hash for a string and a string_view, with phmap::Hash or the default hash of the maps
+    EXPECT_EQ(phmap::Hash<std::string>()(s), phmap::Hash<std::string_view>()(s));
+    EXPECT_EQ(phmap::Hash<std::u16string>()(u), phmap::Hash<std::u16string_view>()(u));
+    EXPECT_EQ(phmap::Hash<std::wstring>()(w), phmap::Hash<std::wstring_view>()(w));
+    EXPECT_EQ(hash_default_hash<std::string>()(s), hash_default_hash<std::string_view>()(s));
+    EXPECT_EQ(hash_default_hash<std::string>()(s), phmap::Hash<std::string>()(s));
+    EXPECT_EQ(hash_default_hash<std::wstring>()(w), phmap::Hash<std::wstring>()(w));
+
+    phmap::flat_hash_map<std::string, int> m;
+    m[s] = 1;
+    EXPECT_EQ(m.count(std::string_view(s)), 1u);
+#endif
+}
+
+TEST(HashBatch, SameAsOneByOne) {
+    std::vector<uint64_t> keys;
+    for (uint64_t i = 0; i < 1000; ++i)
+        keys.push_back(i * 0x9E3779B97F4A7C15ULL);
+    std::vector<size_t> out(keys.size());
+
+    phmap::hash_batch(keys.data(), keys.size(), out.data());
+    for (size_t i = 0; i < keys.size(); ++i)
+        EXPECT_EQ(out[i], phmap::Hash<uint64_t>()(keys[i]));
+
+    // the tables' hashes, usable with find(key, hash) or subidx(hash)
+    phmap::flat_hash_set<uint64_t> s(keys.begin(), keys.end());
+    s.hash_batch(keys.data(), keys.size(), out.data());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_EQ(out[i], s.hash(keys[i]));
+        EXPECT_TRUE(s.find(keys[i], out[i]) != s.end());
+    }
+
+    phmap::parallel_flat_hash_set<uint64_t> ps(keys.begin(), keys.end());
+    ps.hash_batch(keys.data(), keys.size(), out.data());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_EQ(out[i], ps.hash(keys[i]));
+        EXPECT_TRUE(ps.find(keys[i], out[i]) != ps.end());
+    }
+
+    std::vector<std::string> strs = { "a", "bb", "some longer string, longer than 48 characters....." };
+    phmap::flat_hash_map<std::string, int> m;
+    m.hash_batch(strs.data(), strs.size(), out.data());
+    for (size_t i = 0; i < strs.size(); ++i)
+        EXPECT_EQ(out[i], m.hash(strs[i]));
+}
+
+TEST(HashRange, Traits) {
+    EXPECT_TRUE(is_uniquely_represented<uint32_t>::value);
+    EXPECT_TRUE(is_uniquely_represented<char>::value);
+    EXPECT_FALSE(is_uniquely_represented<bool>::value);
+    EXPECT_FALSE(is_uniquely_represented<float>::value);
+    EXPECT_FALSE(is_uniquely_represented<std::string>::value);
+    EXPECT_FALSE(is_uniquely_represented<Padded>::value);
+    EXPECT_TRUE(is_uniquely_represented<Digest>::value);
+    EXPECT_TRUE((is_uniquely_represented<std::array<uint8_t, 32>>::value));
+    EXPECT_TRUE((is_uniquely_represented<std::pair<uint32_t, uint32_t>>::value));
+    EXPECT_FALSE((is_uniquely_represented<std::pair<uint8_t, uint32_t>>::value));
+}
+
+TEST(HashRange, Containers) {
+    // contiguous values of a uniquely represented type are hashed as bytes
+    std::vector<uint32_t> v = { 1, 2, 3, 4, 5 };
+    std::array<uint32_t, 5> a = {{ 1, 2, 3, 4, 5 }};
+    EXPECT_EQ(phmap::Hash<std::vector<uint32_t>>()(v), hash_key_bytes(v.data(), v.size() * sizeof(uint32_t)));
+    EXPECT_EQ(phmap::Hash<std::vector<uint32_t>>()(v), (phmap::Hash<std::array<uint32_t, 5>>()(a)));
+    EXPECT_EQ(phmap::Hash<std::vector<uint32_t>>()(v), phmap::Hash<phmap::Span<const uint32_t>>()(v));
+    EXPECT_EQ(phmap::Hash<std::vector<uint32_t>>()(v), phmap::Hash<phmap::Span<uint32_t>>()(phmap::MakeSpan(v)));
+    EXPECT_NE(phmap::Hash<std::vector<uint32_t>>()(v), phmap::Hash<std::vector<uint32_t>>()({ 1, 2, 3, 4 }));
+    EXPECT_NE(phmap::Hash<std::vector<uint32_t>>()({}), phmap::Hash<std::vector<uint32_t>>()({ 0 }));
+
+    // the other ones are combined, the same way for a vector and a span
+    std::vector<std::string> vs = { "a", "b" };
+    EXPECT_EQ(phmap::Hash<std::vector<std::string>>()(vs),
+              phmap::Hash<phmap::Span<const std::string>>()(vs));
+    EXPECT_NE(phmap::Hash<std::vector<std::string>>()(vs),
+              phmap::Hash<std::vector<std::string>>()({ "b", "a" }));
+    std::vector<Padded> vp = { { 1, 2 }, { 3, 4 } };
+    EXPECT_EQ(phmap::Hash<std::vector<Padded>>()(vp), phmap::Hash<phmap::Span<const Padded>>()(vp));
+    std::vector<bool> vb = { true, false, true };
+    EXPECT_NE(phmap::Hash<std::vector<bool>>()(vb), phmap::Hash<std::vector<bool>>()({ true, true, false }));
+
+    // user types declared uniquely represented
+    Digest d1{}, d2{};
+    d2.bytes[31] = 1;
+    EXPECT_EQ(phmap::Hash<Digest>()(d1), hash_key_bytes(&d1, sizeof(Digest)));
+    EXPECT_NE(phmap::Hash<Digest>()(d1), phmap::Hash<Digest>()(d2));
+    EXPECT_EQ(phmap::Hash<Padded>()(vp[0]), std::hash<Padded>()(vp[0]));
+
+    phmap::flat_hash_map<std::vector<uint32_t>, int> m;
+    m[v] = 1;
+    m[{ 1, 2 }] = 2;
+    EXPECT_EQ(m.at(v), 1);
+    phmap::flat_hash_set<Digest> digests = { d1, d2 };
+    EXPECT_EQ(digests.size(), 2u);
+    EXPECT_EQ(digests.count(d2), 1u);
+    phmap::flat_hash_set<std::array<uint8_t, 32>> arrays;
+    arrays.insert(std::array<uint8_t, 32>{});
+    EXPECT_EQ(arrays.count(std::array<uint8_t, 32>{}), 1u);
+}
+
+TEST(Crc32c, Values) {
+    // standard check values of CRC-32C
+    EXPECT_EQ(phmap::crc32c("123456789", 9), 0xe3069283u);
+    EXPECT_EQ(phmap::crc32c("", 0), 0u);
+    std::string zeros(32, '\0');
+    EXPECT_EQ(phmap::crc32c(zeros.data(), zeros.size()), 0x8a9136aau);
+    // continued
+    EXPECT_EQ(phmap::crc32c("6789", 4, phmap::crc32c("12345", 5)), 0xe3069283u);
+}
+
+TEST(Crc32c, Hash) {
+    phmap::flat_hash_set<size_t> hashes;
+    for (uint64_t i = 0; i < 100000; ++i)
+        EXPECT_TRUE(hashes.insert(phmap::Crc32cHash<uint64_t>()(i << 20)).second);
+    // both halves of the hash depend on all the bits of the key
+    size_t h = phmap::Crc32cHash<uint64_t>()(0);
+    for (int bit = 0; bit < 64; ++bit) {
+        size_t d = h ^ phmap::Crc32cHash<uint64_t>()(uint64_t(1) << bit);
+        EXPECT_NE(d & 0xffffffff, 0u);
+        if (sizeof(size_t) == 8) {
+            EXPECT_NE(d >> 16 >> 16, 0u);
+        }
+    }
+
+    std::string s = "some url";
+    EXPECT_NE(phmap::Crc32cHash<std::string>()(s), phmap::Crc32cHash<std::string>()(s + '\0'));
+#if PHMAP_HAVE_STD_STRING_VIEW
+    EXPECT_EQ(phmap::Crc32cHash<std::string>()(s), phmap::Crc32cHash<std::string_view>()(s));
+#endif
+#if defined(PHMAP_USE_CRC32C_HASH)
+    EXPECT_EQ(phmap::Crc32cHash<std::string>()(s), phmap::Hash<std::string>()(s));
+#endif
+
+    phmap::flat_hash_map<uint64_t, int, phmap::Crc32cHash<uint64_t>> m;
+    for (int i = 0; i < 1000; ++i)
+        m[uint64_t(i) * 4096] = i;
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(m[uint64_t(i) * 4096], i);
+    phmap::flat_hash_set<Digest, phmap::Crc32cHash<Digest>> digests = { Digest{}, Digest{{ 1 }} };
+    EXPECT_EQ(digests.size(), 2u);
+}
+
+TEST(MixingHashState, AbslHashValue) {
+    static_assert(has_absl_hash_value<Person>::value, "");
+    static_assert(!has_absl_hash_value<Point>::value, "");
+
+    Person p{ "ab", "c", 40 };
+    size_t h = phmap::Hash<Person>()(p);
+    EXPECT_EQ(h, MixingHashState::combine(MixingHashState(), p.first, p.last, p.age).value());
+    EXPECT_EQ(h, MixingHashState::combine(MixingHashState(), std::make_tuple(p.first, p.last, p.age)).value());
+    EXPECT_NE(h, phmap::Hash<Person>()(Person{ "a", "bc", 40 }));
+    EXPECT_NE(h, phmap::Hash<Person>()(Person{ "c", "ab", 40 }));
+    EXPECT_NE(h, phmap::Hash<Person>()(Person{ "ab", "c", 41 }));
+
+    // members of composite types
+    std::vector<Person> people = { p, Person{ "x", "y", 1 } };
+    EXPECT_EQ(phmap::Hash<std::vector<Person>>()(people),
+              phmap::Hash<phmap::Span<const Person>>()(people));
+    EXPECT_EQ((phmap::Hash<std::pair<Person, int>>()(std::make_pair(p, 1))),
+              (phmap::Hash<std::tuple<Person, int>>()(std::make_tuple(p, 1))));
+
+    phmap::flat_hash_set<Person> s = { p, Person{ "a", "bc", 40 } };
+    EXPECT_EQ(s.size(), 2u);
+    EXPECT_EQ(s.count(Person{ "ab", "c", 40 }), 1u);
+}
+
+TEST(MixingHashState, Values) {
+    // same values, same hash, whatever the type of the container
+    EXPECT_EQ((phmap::Hash<std::pair<std::string, int>>()(std::make_pair(std::string("a"), 1))),
+              (phmap::Hash<std::tuple<std::string, int>>()(std::make_tuple(std::string("a"), 1))));
+    EXPECT_EQ(HashState().combine(1, 0.0), HashState().combine(1, -0.0));
+    EXPECT_NE(HashState().combine(1, 1.0), HashState().combine(1, -1.0));
+    EXPECT_NE(HashState().combine(0, 1), HashState().combine(1, 1));
+    EXPECT_NE(HashState().combine(0, 1, 2), HashState().combine(0, 2, 1));
+    EXPECT_NE(HashState().combine(0), HashState().combine(0, 0));
+    EXPECT_NE(HashState().combine(0, std::vector<int>{}), HashState().combine(0, std::vector<int>{ 0 }));
+    EXPECT_NE(HashState().combine(0, std::vector<std::string>{ "ab", "c" }),
+              HashState().combine(0, std::vector<std::string>{ "a", "bc" }));
+    EXPECT_NE(HashState().combine(0, std::vector<bool>{ true }),
+              HashState().combine(0, std::vector<bool>{ true, false }));
+    int i = 0, j = 0;
+    EXPECT_NE(HashState().combine(0, &i), HashState().combine(0, &j));
+    EXPECT_NE(HashState().combine(0, Padded{ 1, 2 }), HashState().combine(0, Padded{ 2, 1 }));
+    Digest d{};
+    d.bytes[31] = 1;
+    EXPECT_NE(HashState().combine(0, d), HashState().combine(0, Digest{}));
+
+    // small grid of points: no collision of the hashes, nor of their low bits
+    // more than a random function would have
+    phmap::flat_hash_set<size_t> hashes, low;
+    for (uint32_t x = 0; x < 256; ++x) {
+        for (uint32_t y = 0; y < 256; ++y) {
+            size_t h = phmap::Hash<Point>()(Point{ x, y });
+            hashes.insert(h);
+            low.insert(h & 0xfffff);
+        }
+    }
+    EXPECT_EQ(hashes.size(), 65536u);
+    EXPECT_GT(low.size(), 61000u);    // 2^16 values in 2^20 buckets: 63500 expected
+}
+
+}  // namespace
+}  // namespace priv
+}  // namespace phmap
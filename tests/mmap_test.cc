@@ -0,0 +1,203 @@
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "parallel_hashmap/phmap_mmap.h"
+
+#if PHMAP_HAVE_MMAP
+
+namespace phmap {
+namespace priv {
+namespace {
+
+const size_t kFileSize = size_t(256) << 20;
+
+std::string TestFile(const char* name) {
+    std::string path = std::string("./mmap_test_") + name + ".dat";
+    std::remove(path.c_str());
+    return path;
+}
+
+TEST(OffsetPtr, Basic) {
+    int a[4] = {1, 2, 3, 4};
+    offset_ptr<int> p(&a[1]);
+    EXPECT_EQ(*p, 2);
+    EXPECT_EQ(p[1], 3);
+    EXPECT_EQ(*(p + 2), 4);
+    EXPECT_EQ(*--p, 1);
+    EXPECT_EQ(offset_ptr<int>(&a[3]) - p, 3);
+
+    offset_ptr<int> q;
+    EXPECT_FALSE(q);
+    EXPECT_TRUE(q == nullptr);
+    q = p;                                  // copy at another address
+    EXPECT_TRUE(q == p);
+    EXPECT_EQ(q.get(), &a[0]);
+
+    offset_ptr<const void> v(q);
+    EXPECT_EQ(static_cast<offset_ptr<const int>>(v).get(), &a[0]);
+}
+
+TEST(OffsetPtr, PositionIndependent) {
+    struct Node
+    {
+        int             value;
+        offset_ptr<int> ptr;                // points to `value`
+    };
+    Node n1;
+    n1.value = 7;
+    n1.ptr = &n1.value;
+
+    Node n2;
+    std::memcpy(static_cast<void*>(&n2), &n1, sizeof(Node));   // "mapped elsewhere"
+    n2.value = 8;
+    EXPECT_EQ(n2.ptr.get(), &n2.value);
+    EXPECT_EQ(*n2.ptr, 8);
+}
+
+using Alloc  = mmap_file_allocator<std::pair<const uint64_t, uint64_t>>;
+using Map    = flat_hash_map<uint64_t, uint64_t, Hash<uint64_t>, EqualTo<uint64_t>, Alloc>;
+
+TEST(MmapFile, FlatHashMapReopen) {
+    std::string path = TestFile("flat");
+    const uint64_t n = 100000;
+
+    // leave room after the mapping, so that the file can be grown in place
+    void* addr = ::mmap(nullptr, kFileSize * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(addr, MAP_FAILED);
+    ::munmap(addr, kFileSize * 2);
+    {
+        mmap_file file(path, kFileSize, addr);
+        EXPECT_TRUE(file.created());
+        EXPECT_EQ(file.base(), addr);
+        Map* m = file.find_or_construct<Map>("map", file.get_allocator<Map::value_type>());
+        for (uint64_t i = 0; i < n; ++i)
+            m->emplace(i, i * 3);
+        EXPECT_EQ(file.find_or_construct<Map>("map", file.get_allocator<Map::value_type>()), m);
+        EXPECT_GT(file.used_bytes(), n * sizeof(Map::value_type));
+        file.flush();
+    }
+    {
+        mmap_file file(path, kFileSize);
+        EXPECT_FALSE(file.created());
+        EXPECT_TRUE(file.find<Map>("other") == nullptr);
+        Map* m = file.find<Map>("map");
+        ASSERT_TRUE(m != nullptr);
+        EXPECT_EQ(m->size(), n);
+        for (uint64_t i = 0; i < n; ++i)
+            ASSERT_EQ(m->at(i), i * 3);
+        for (uint64_t i = 0; i < n; i += 2)
+            m->erase(i);
+        (*m)[n] = 1;
+    }
+    {
+        mmap_file file(path, kFileSize * 2);     // grown
+        EXPECT_EQ(file.size(), kFileSize * 2);
+        Map* m = file.find<Map>("map");
+        ASSERT_TRUE(m != nullptr);
+        EXPECT_EQ(m->size(), n / 2 + 1);
+        EXPECT_FALSE(m->contains(0));
+        EXPECT_EQ(m->at(1), 3u);
+        EXPECT_EQ(m->at(n), 1u);
+        EXPECT_TRUE(file.destroy<Map>("map"));
+        EXPECT_FALSE(file.destroy<Map>("map"));
+        EXPECT_EQ(file.used_bytes(), 0u);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(MmapFile, NestedContainers) {
+    using VAlloc = mmap_file_allocator<int>;
+    using Vec    = std::vector<int, VAlloc>;
+    using NAlloc = mmap_file_allocator<std::pair<const int, Vec>>;
+    using NMap   = node_hash_map<int, Vec, Hash<int>, EqualTo<int>, NAlloc>;
+
+    std::string path = TestFile("nested");
+    {
+        mmap_file file(path, kFileSize);
+        NMap* m = file.find_or_construct<NMap>("nested", file.get_allocator<NMap::value_type>());
+        for (int i = 0; i < 1000; ++i) {
+            Vec& v = m->try_emplace(i, file.get_allocator<int>()).first->second;
+            for (int j = 0; j < i % 10; ++j)
+                v.push_back(i + j);
+        }
+    }
+    {
+        mmap_file file(path, kFileSize);
+        NMap* m = file.find<NMap>("nested");
+        ASSERT_TRUE(m != nullptr);
+        EXPECT_EQ(m->size(), 1000u);
+        for (int i = 0; i < 1000; ++i) {
+            const Vec& v = m->at(i);
+            ASSERT_EQ(v.size(), size_t(i % 10));
+            for (int j = 0; j < i % 10; ++j)
+                EXPECT_EQ(v[j], i + j);
+        }
+        m->clear();
+        m->rehash(0);
+        EXPECT_EQ(file.used_bytes(), ((sizeof(NMap) + 15) & ~size_t(15)));
+    }
+    std::remove(path.c_str());
+}
+
+TEST(MmapFile, ParallelFlatHashMap) {
+    using PMap = parallel_flat_hash_map<uint64_t, uint64_t, Hash<uint64_t>, EqualTo<uint64_t>,
+                                        Alloc, 4, std::mutex>;
+    std::string path = TestFile("parallel");
+    const uint64_t num_threads = 4, n = 50000;
+    {
+        mmap_file file(path, kFileSize);
+        PMap* m = file.find_or_construct<PMap>("pmap", file.get_allocator<PMap::value_type>());
+        std::vector<std::thread> threads;
+        for (uint64_t t = 0; t < num_threads; ++t)
+            threads.emplace_back([m, t]() {
+                for (uint64_t i = 0; i < n; ++i)
+                    m->try_emplace_l(i * num_threads + t, [](PMap::value_type&) {}, t);
+            });
+        for (auto& th : threads)
+            th.join();
+        EXPECT_EQ(m->size(), num_threads * n);
+    }
+    {
+        mmap_file file(path, kFileSize);
+        PMap* m = file.find<PMap>("pmap");
+        ASSERT_TRUE(m != nullptr);
+        EXPECT_EQ(m->size(), num_threads * n);
+        for (uint64_t i = 0; i < num_threads * n; ++i)
+            ASSERT_EQ(m->at(i), i % num_threads);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(MmapFile, Errors) {
+    std::string path = TestFile("errors");
+    {
+        mmap_file file(path, size_t(1) << 20);
+        auto alloc = file.get_allocator<char>();
+        EXPECT_THROW(alloc.allocate(size_t(2) << 20), std::bad_alloc);
+        auto p = alloc.allocate(100);
+        alloc.deallocate(p, 100);
+        EXPECT_EQ(file.used_bytes(), 0u);
+        EXPECT_THROW(file.find_or_construct<int>("a name which is much too long for the file header"),
+                     std::invalid_argument);
+        file.find_or_construct<int>("int", 5);
+        EXPECT_THROW(file.find<double>("int"), std::invalid_argument);
+    }
+    {
+        FILE* f = std::fopen(path.c_str(), "wb");
+        std::fputs("not a phmap file", f);
+        std::fclose(f);
+        EXPECT_THROW(mmap_file(path, size_t(1) << 20), std::runtime_error);
+    }
+    std::remove(path.c_str());
+}
+
+}  // namespace
+}  // namespace priv
+}  // namespace phmap
+
+#endif // PHMAP_HAVE_MMAP
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "parallel_hashmap/phmap_ordered.h"
+
+namespace phmap {
+namespace priv {
+namespace {
+
+using Map = ordered_flat_hash_map<int, std::string>;
+
+std::vector<int> keys(const Map& m) {
+    std::vector<int> res;
+    for (const auto& e : m)
+        res.push_back(e.first);
+    return res;
+}
+
+TEST(OrderedFlatHashMap, InsertionOrder) {
+    Map m = { {3, "c"}, {1, "a"}, {2, "b"} };
+    EXPECT_EQ(keys(m), (std::vector<int>{3, 1, 2}));
+    EXPECT_FALSE(m.insert({1, "x"}).second);
+    EXPECT_EQ(m.at(1), "a");
+    m[0] = "z";
+    m.insert_or_assign(3, "cc");
+    EXPECT_EQ(keys(m), (std::vector<int>{3, 1, 2, 0}));
+    EXPECT_EQ(m[3], "cc");
+    EXPECT_EQ(m.index_of(2), 2u);
+    EXPECT_EQ(m.index_of(7), Map::npos);
+    EXPECT_EQ(m.find(0) - m.begin(), 3);
+    EXPECT_TRUE(m.find(7) == m.end());
+    EXPECT_EQ(m.data()[1].second, "a");
+    EXPECT_THROW(m.at(7), std::out_of_range);
+}
+
+TEST(OrderedFlatHashMap, Erase) {
+    Map m;
+    for (int i = 0; i < 10; ++i)
+        m.emplace(i, std::to_string(i));
+    EXPECT_EQ(m.erase(3), 1u);
+    EXPECT_EQ(m.erase(3), 0u);
+    EXPECT_EQ(keys(m), (std::vector<int>{0, 1, 2, 4, 5, 6, 7, 8, 9}));
+    EXPECT_EQ(m.swap_erase(1), 1u);
+    EXPECT_EQ(keys(m), (std::vector<int>{0, 9, 2, 4, 5, 6, 7, 8}));
+    auto it = m.erase(m.begin());
+    EXPECT_EQ(it->first, 9);
+    EXPECT_EQ(erase_if(m, [](const Map::value_type& e) { return e.first % 2 == 0; }), 4u);
+    EXPECT_EQ(keys(m), (std::vector<int>{9, 5, 7}));
+    for (int k : {9, 5, 7})
+        EXPECT_EQ(m.at(k), std::to_string(k));
+    for (int k : {0, 1, 2, 3, 4, 6, 8})
+        EXPECT_FALSE(m.contains(k));
+}
+
+TEST(OrderedFlatHashMap, Large) {
+    ordered_flat_hash_map<int64_t, int64_t> m;
+    const int64_t n = 100000;
+    for (int64_t i = 0; i < n; ++i)
+        m[i * 7919] = i;
+    EXPECT_EQ(m.size(), (size_t)n);
+    int64_t expected = 0;
+    for (const auto& e : m)
+        EXPECT_EQ(e.second, expected++);
+
+    // many erase + insert cycles reuse deleted slots
+    for (int64_t i = 0; i < n; i += 2)
+        m.swap_erase(i * 7919);
+    for (int64_t i = 0; i < n; i += 2)
+        m[i * 7919 + 1] = i;
+    EXPECT_EQ(m.size(), (size_t)n);
+    for (int64_t i = 0; i < n; ++i)
+        ASSERT_EQ(m.at(i * 7919 + (i & 1 ? 0 : 1)), i);
+
+    m.rehash(0);
+    EXPECT_EQ(m.size(), (size_t)n);
+    EXPECT_TRUE(m.contains(7919));
+}
+
+TEST(OrderedFlatHashMap, Sort) {
+    Map m;
+    for (int i : {5, 3, 9, 1, 7})
+        m[i] = std::to_string(i);
+    m.sort_keys();
+    EXPECT_EQ(keys(m), (std::vector<int>{1, 3, 5, 7, 9}));
+    m.sort([](const Map::value_type& a, const Map::value_type& b) { return a.first > b.first; });
+    EXPECT_EQ(keys(m), (std::vector<int>{9, 7, 5, 3, 1}));
+    for (int i : {5, 3, 9, 1, 7})
+        EXPECT_EQ(m.at(i), std::to_string(i));
+    EXPECT_EQ(m.index_of(9), 0u);
+}
+
+TEST(OrderedFlatHashMap, CopyMoveCompare) {
+    Map m = { {1, "a"}, {2, "b"} };
+    Map m2(m);
+    EXPECT_TRUE(m == m2);
+    EXPECT_EQ(keys(m2), (std::vector<int>{1, 2}));
+    m2[3] = "c";
+    EXPECT_TRUE(m != m2);
+
+    Map m3 = { {2, "b"}, {1, "a"} };
+    EXPECT_TRUE(m == m3);  // order does not matter
+
+    Map m4(std::move(m2));
+    EXPECT_TRUE(m2.empty());
+    EXPECT_FALSE(m2.contains(1));
+    m2[4] = "d";
+    EXPECT_EQ(m2.size(), 1u);
+    EXPECT_EQ(m4.size(), 3u);
+    m = m4;
+    EXPECT_EQ(m.at(3), "c");
+    m.clear();
+    EXPECT_TRUE(m.empty());
+    EXPECT_FALSE(m.contains(3));
+    m[3] = "cc";
+    EXPECT_EQ(m.at(3), "cc");
+}
+
+TEST(OrderedFlatHashMap, MoveOnlyAndReserve) {
+    ordered_flat_hash_map<std::string, std::unique_ptr<int>> m;
+    m.reserve(1000);
+    size_t cap = m.capacity();
+    EXPECT_GE(cap, 1000u);
+    for (int i = 0; i < 1000; ++i)
+        m.try_emplace(std::to_string(i), new int(i));
+    EXPECT_EQ(m.capacity(), cap);
+    EXPECT_EQ(*m.at("500"), 500);
+    m.swap_erase("0");
+    EXPECT_EQ(*m.begin()->second, 999);
+}
+
+}  // namespace
+}  // namespace priv
+}  // namespace phmap
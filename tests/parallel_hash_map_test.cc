@@ -163,6 +163,25 @@ TEST(THIS_TEST_NAME, EmplaceSingle) {
     EXPECT_EQ(m.count(11), 0);
 }
 
+TEST(THIS_TEST_NAME, Equal) {
+    using Map = ThisMap<int, int>;
+    Map a, b;
+    for (int i = 0; i < 10000; ++i) {
+        a.emplace(i, i);
+        b.emplace(i, i);
+    }
+    EXPECT_TRUE(a == b);
+    b[5000] = 0;
+    EXPECT_FALSE(a == b);
+    b[5000] = 5000;
+    b.erase(1);
+    b.emplace(10000, 10000);
+    EXPECT_FALSE(a == b);
+    b.erase(10000);
+    b.emplace(1, 1);
+    EXPECT_TRUE(a == b);
+}
+
 
 }  // namespace
 }  // namespace priv
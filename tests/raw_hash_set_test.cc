@@ -1514,6 +1514,28 @@ TEST(Table, Equality3) {
 }
 #endif
 
+TEST(Table, EqualitySameCapacity) {
+  IntTable t, u;
+  for (int64_t i = 0; i < 1000; ++i) t.emplace(i);
+  // different insertion order, so the elements may be in different slots.
+  for (int64_t i = 999; i >= 0; --i) u.emplace(i);
+  ASSERT_EQ(t.capacity(), u.capacity());
+  EXPECT_TRUE(t == u);
+
+  // erase and reinsert, so the control bytes differ.
+  for (int64_t i = 0; i < 1000; i += 3) u.erase(i);
+  for (int64_t i = 0; i < 1000; i += 3) u.emplace(i);
+  ASSERT_EQ(t.capacity(), u.capacity());
+  EXPECT_TRUE(t == u);
+  EXPECT_TRUE(u == t);
+
+  u.erase(500);
+  u.emplace(1000);
+  ASSERT_EQ(t.capacity(), u.capacity());
+  EXPECT_FALSE(t == u);
+  EXPECT_FALSE(u == t);
+}
+
 TEST(Table, NumDeletedRegression) {
   IntTable t;
   t.emplace(0);
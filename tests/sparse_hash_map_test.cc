@@ -0,0 +1,174 @@
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "parallel_hashmap/phmap_sparse.h"
+
+namespace phmap {
+namespace priv {
+namespace {
+
+TEST(SparseHashMap, Basic) {
+    sparse_hash_map<int, std::string> m = { {1, "a"}, {2, "b"} };
+    EXPECT_EQ(m.size(), 2u);
+    EXPECT_FALSE(m.insert({1, "x"}).second);
+    EXPECT_EQ(m.at(1), "a");
+    m[3] = "c";
+    m.insert_or_assign(2, "bb");
+    EXPECT_EQ(m[2], "bb");
+    EXPECT_TRUE(m.try_emplace(4, "d").second);
+    EXPECT_FALSE(m.try_emplace(4, "e").second);
+    EXPECT_EQ(m.find(4)->second, "d");
+    EXPECT_TRUE(m.find(5) == m.end());
+    EXPECT_EQ(m.count(3), 1u);
+    EXPECT_THROW(m.at(5), std::out_of_range);
+    EXPECT_EQ(m.erase(3), 1u);
+    EXPECT_EQ(m.erase(3), 0u);
+    EXPECT_FALSE(m.contains(3));
+    EXPECT_EQ(m.size(), 3u);
+}
+
+TEST(SparseHashMap, Large) {
+    sparse_hash_map<int64_t, int64_t> m;
+    const int64_t n = 100000;
+    for (int64_t i = 0; i < n; ++i)
+        m[i * 7919] = i;
+    EXPECT_EQ(m.size(), (size_t)n);
+    EXPECT_LE(m.load_factor(), 0.5f);
+    for (int64_t i = 0; i < n; ++i)
+        ASSERT_EQ(m.at(i * 7919), i);
+
+    size_t cnt = 0;
+    for (const auto& e : m) {
+        EXPECT_EQ(e.first, e.second * 7919);
+        ++cnt;
+    }
+    EXPECT_EQ(cnt, (size_t)n);
+
+    // erase + insert cycles reuse the tombstones
+    for (int k = 0; k < 4; ++k) {
+        for (int64_t i = 0; i < n; i += 2)
+            m.erase(i * 7919 + k);
+        for (int64_t i = 0; i < n; i += 2)
+            m[i * 7919 + k + 1] = i;
+    }
+    EXPECT_EQ(m.size(), (size_t)n);
+    for (int64_t i = 0; i < n; ++i)
+        ASSERT_EQ(m.at(i * 7919 + (i & 1 ? 0 : 4)), i);
+
+    m.rehash(0);
+    EXPECT_EQ(m.size(), (size_t)n);
+    EXPECT_TRUE(m.contains(7919));
+}
+
+TEST(SparseHashMap, EraseWhileIterating) {
+    sparse_hash_map<int, int> m;
+    for (int i = 0; i < 1000; ++i)
+        m[i] = i;
+    EXPECT_EQ(erase_if(m, [](const std::pair<const int, int>& e) { return e.first % 3 == 0; }), 334u);
+    EXPECT_EQ(m.size(), 666u);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(m.contains(i), i % 3 != 0);
+
+    for (auto it = m.begin(); it != m.end(); )
+        it = it->first % 2 ? m.erase(it) : std::next(it);
+    EXPECT_EQ(m.size(), 333u);
+    m.erase(m.begin(), m.end());
+    EXPECT_TRUE(m.empty());
+    m[1] = 1;
+    EXPECT_EQ(m.size(), 1u);
+}
+
+TEST(SparseHashMap, CopyMoveCompare) {
+    sparse_hash_map<std::string, std::string> m;
+    for (int i = 0; i < 200; ++i)
+        m[std::to_string(i)] = std::to_string(i * 2);
+    m.erase("7");
+
+    sparse_hash_map<std::string, std::string> m2(m);
+    EXPECT_TRUE(m == m2);
+    m2["7"] = "14";
+    EXPECT_TRUE(m != m2);
+
+    sparse_hash_map<std::string, std::string> m3(std::move(m2));
+    EXPECT_TRUE(m2.empty());
+    m2["x"] = "y";
+    EXPECT_EQ(m3.size(), 200u);
+    m = m3;
+    EXPECT_EQ(m.at("7"), "14");
+    m.swap(m2);
+    EXPECT_EQ(m.size(), 1u);
+    m.clear();
+    EXPECT_TRUE(m.empty());
+    EXPECT_FALSE(m.contains("x"));
+    m["x"] = "z";
+    EXPECT_EQ(m.at("x"), "z");
+}
+
+TEST(SparseHashMap, MoveOnlyAndReserve) {
+    sparse_hash_map<int, std::unique_ptr<int>> m;
+    m.reserve(1000);
+    size_t cap = m.capacity();
+    for (int i = 0; i < 1000; ++i)
+        m.emplace(i, new int(i));
+    EXPECT_EQ(m.capacity(), cap);
+    EXPECT_EQ(*m.at(500), 500);
+}
+
+TEST(SparseHashSet, Basic) {
+    sparse_hash_set<std::string> s = { "a", "b", "c" };
+    EXPECT_TRUE(s.insert("d").second);
+    EXPECT_FALSE(s.insert("a").second);
+    EXPECT_TRUE(s.emplace(std::string(3, 'e')).second);
+    EXPECT_EQ(s.size(), 5u);
+    EXPECT_TRUE(s.contains("eee"));
+    EXPECT_EQ(s.erase("b"), 1u);
+    EXPECT_EQ(s.count("b"), 0u);
+
+    sparse_hash_set<std::string> s2 = { "eee", "d", "c", "a" };
+    EXPECT_TRUE(s == s2);
+}
+
+TEST(ParallelSparseHashMap, Basic) {
+    parallel_sparse_hash_map<int, int> m;
+    for (int i = 0; i < 10000; ++i)
+        m.emplace(i, i);
+    EXPECT_EQ(m.size(), 10000u);
+    EXPECT_EQ(m[77], 77);
+    for (int i = 0; i < 10000; i += 2)
+        EXPECT_EQ(m.erase(i), 1u);
+    EXPECT_EQ(m.size(), 5000u);
+    EXPECT_EQ(erase_if(m, [](const std::pair<const int, int>& e) { return e.first < 5000; }), 2500u);
+    EXPECT_EQ(m.size(), 2500u);
+    for (int i = 0; i < 10000; ++i)
+        EXPECT_EQ(m.contains(i), i >= 5000 && (i & 1));
+
+    auto m2 = m;
+    EXPECT_TRUE(m == m2);
+    m2.erase(9999);
+    EXPECT_TRUE(m != m2);
+}
+
+TEST(ParallelSparseHashSet, Threads) {
+    parallel_sparse_hash_set<int, phmap::Hash<int>, phmap::EqualTo<int>,
+                             std::allocator<int>, 4, std::mutex> s;
+    const int num_threads = 4;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t)
+        threads.emplace_back([&s, t]() {
+            for (int i = 0; i < 20000; ++i)
+                s.insert(i * num_threads + t);
+        });
+    for (auto& th : threads)
+        th.join();
+    EXPECT_EQ(s.size(), 80000u);
+    EXPECT_TRUE(s.contains(79999));
+}
+
+}  // namespace
+}  // namespace priv
+}  // namespace phmap
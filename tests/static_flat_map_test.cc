@@ -0,0 +1,83 @@
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "parallel_hashmap/phmap_static.h"
+
+namespace phmap {
+namespace priv {
+namespace {
+
+enum class Opcode : uint8_t { Nop, Load, Store, Add, Jump };
+
+constexpr auto opcodes = phmap::make_static_flat_map<int, Opcode>({
+    {0x00, Opcode::Nop}, {0x10, Opcode::Load}, {0x11, Opcode::Store},
+    {0x20, Opcode::Add}, {0x40, Opcode::Jump} });
+
+static_assert(opcodes.size() == 5, "");
+static_assert(opcodes.at(0x11) == Opcode::Store, "");
+static_assert(opcodes.contains(0x40), "");
+static_assert(!opcodes.contains(0x41), "");
+static_assert(opcodes.find(0x12) == opcodes.end(), "");
+
+TEST(StaticFlatMap, Integers) {
+    for (const auto& e : opcodes)
+        EXPECT_EQ(opcodes.find(e.first)->second, e.second);
+    EXPECT_EQ(opcodes.begin()->first, 0x00);  // order of the initializer
+    EXPECT_EQ(opcodes.count(0x20), 1u);
+    EXPECT_EQ(opcodes.count(0x21), 0u);
+    EXPECT_THROW(opcodes.at(0x21), std::out_of_range);
+    auto r = opcodes.equal_range(0x10);
+    EXPECT_EQ(r.second - r.first, 1);
+}
+
+TEST(StaticFlatMap, Mix) {
+    // same value as phmap_mix<8> when it uses a 128 bit multiplication
+    static_assert(static_mix(0) == 0, "");
+    EXPECT_EQ(static_mix(1), 0xde5fb9d2630458e9ULL);
+#if defined(PHMAP_HAS_UMUL128)
+    for (uint64_t v : {1ULL, 12345ULL, 0xffffffffffffffffULL, 0x8000000000000001ULL})
+        EXPECT_EQ(static_mix(v), phmap_mix<8>()(v));
+#endif
+}
+
+#if PHMAP_HAVE_STD_STRING_VIEW
+constexpr auto keywords = phmap::make_static_flat_map<std::string_view, int>({
+    {"if", 1}, {"else", 2}, {"while", 3}, {"for", 4}, {"do", 5}, {"return", 6},
+    {"break", 7}, {"continue", 8}, {"switch", 9}, {"case", 10}, {"default", 11} });
+
+static_assert(keywords.at("while") == 3, "");
+static_assert(keywords.at("default") == 11, "");
+static_assert(!keywords.contains("goto"), "");
+
+TEST(StaticFlatMap, Strings) {
+    for (const auto& e : keywords)
+        EXPECT_EQ(keywords.at(e.first), e.second);
+    std::string s = "return";
+    EXPECT_EQ(keywords.at(s), 6);
+    EXPECT_FALSE(keywords.contains(""));
+    EXPECT_FALSE(keywords.contains("iff"));
+}
+#endif
+
+TEST(StaticFlatMap, Large) {
+    std::pair<uint32_t, uint32_t> items[300] = {};
+    for (uint32_t i = 0; i < 300; ++i)
+        items[i] = {i * 7919, i};
+    // built at runtime here, with the same algorithm
+    auto m = phmap::make_static_flat_map(items);
+    for (uint32_t i = 0; i < 300; ++i) {
+        ASSERT_TRUE(m.contains(i * 7919));
+        EXPECT_EQ(m.at(i * 7919), i);
+        EXPECT_FALSE(m.contains(i * 7919 + 1));
+    }
+    EXPECT_EQ(m.bucket_count(), 512u);
+
+    std::pair<int, int> dups[3] = { {1, 1}, {2, 2}, {1, 3} };
+    EXPECT_THROW(phmap::make_static_flat_map(dups), std::invalid_argument);
+}
+
+}  // namespace
+}  // namespace priv
+}  // namespace phmap
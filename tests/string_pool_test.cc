@@ -0,0 +1,94 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "parallel_hashmap/phmap_string_pool.h"
+
+#if PHMAP_HAVE_STD_STRING_VIEW
+
+namespace phmap {
+namespace priv {
+namespace {
+
+TEST(StringPool, Basic) {
+    string_pool<> pool;
+    EXPECT_TRUE(pool.empty());
+    EXPECT_EQ(pool.find("a"), string_pool<>::npos);
+
+    std::string hello = "hello";
+    auto id = pool.intern(hello);
+    EXPECT_EQ(pool.intern("hello"), id);
+    EXPECT_NE(pool.intern("world"), id);
+    EXPECT_EQ(pool.size(), 2u);
+    EXPECT_EQ(pool.find("hello"), id);
+    EXPECT_TRUE(pool.contains("world"));
+    EXPECT_FALSE(pool.contains("hell"));
+
+    std::string_view v = pool.intern_view(hello);
+    EXPECT_EQ(v, "hello");
+    EXPECT_NE(v.data(), hello.data());        // a copy, owned by the pool
+    EXPECT_EQ(pool.view(id).data(), v.data());
+    hello[0] = 'j';
+    EXPECT_EQ(pool.view(id), "hello");
+
+    auto empty_id = pool.intern("");
+    EXPECT_EQ(pool.view(empty_id), "");
+    EXPECT_EQ(pool.intern(std::string_view()), empty_id);
+}
+
+TEST(StringPool, ManyStrings) {
+    string_pool<4, phmap::NullMutex> pool(1024);
+    std::vector<uint32_t> ids;
+    for (int i = 0; i < 100000; ++i)
+        ids.push_back(pool.intern(std::to_string(i)));
+    std::string big(5000, 'x');                 // larger than an arena block
+    auto big_id = pool.intern(big);
+    EXPECT_EQ(pool.size(), 100001u);
+    for (int i = 0; i < 100000; ++i) {
+        ASSERT_EQ(pool.view(ids[i]), std::to_string(i));
+        ASSERT_EQ(pool.find(std::to_string(i)), ids[i]);
+    }
+    EXPECT_EQ(pool.view(big_id), big);
+    EXPECT_GE(pool.arena_bytes(), 488890u + 5000u);
+
+    size_t n = 0;
+    pool.for_each([&](uint32_t id, std::string_view s) {
+        EXPECT_EQ(pool.view(id), s);
+        ++n;
+    });
+    EXPECT_EQ(n, pool.size());
+
+    pool.clear();
+    EXPECT_TRUE(pool.empty());
+    EXPECT_EQ(pool.arena_bytes(), 0u);
+    EXPECT_FALSE(pool.contains("1"));
+    EXPECT_EQ(pool.view(pool.intern("1")), "1");
+}
+
+TEST(StringPool, Threads) {
+    string_pool<> pool;
+    const int num_threads = 8;
+    const int num_strings = 20000;
+    std::vector<std::vector<uint32_t>> ids(num_threads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t)
+        threads.emplace_back([&, t]() {
+            // every thread interns the same strings, in a different order
+            for (int i = 0; i < num_strings; ++i)
+                ids[t].push_back(pool.intern("str" + std::to_string((i * (t + 1)) % num_strings)));
+        });
+    for (auto& th : threads)
+        th.join();
+    EXPECT_EQ(pool.size(), (size_t)num_strings);
+    for (int t = 0; t < num_threads; ++t)
+        for (int i = 0; i < num_strings; ++i)
+            ASSERT_EQ(pool.view(ids[t][i]), "str" + std::to_string((i * (t + 1)) % num_strings));
+}
+
+}  // namespace
+}  // namespace priv
+}  // namespace phmap
+
+#endif
@@ -0,0 +1,206 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "parallel_hashmap/phmap_wal.h"
+
+#if PHMAP_HAVE_MMAP
+
+namespace phmap {
+namespace priv {
+namespace {
+
+using Map = phmap::parallel_flat_hash_map<uint64_t, uint64_t, phmap::Hash<uint64_t>,
+                                          phmap::EqualTo<uint64_t>,
+                                          std::allocator<std::pair<const uint64_t, uint64_t>>,
+                                          4, std::mutex>;
+using Log = phmap::mutation_log<Map>;
+
+std::string TestFile(const char* name) {
+    std::string path = std::string("./wal_test_") + name + ".dat";
+    std::remove(path.c_str());
+    return path;
+}
+
+void ExpectSameElements(const Map& a, const Map& b) {
+    EXPECT_EQ(a.size(), b.size());
+    for (const auto& v : a) {
+        auto it = b.find(v.first);
+        ASSERT_TRUE(it != b.end()) << v.first;
+        EXPECT_EQ(it->second, v.second);
+    }
+}
+
+TEST(MutationLog, CommitAndReplay) {
+    std::string base = TestFile("base"), wal = TestFile("log");
+
+    Map m;
+    for (uint64_t i = 0; i < 1000; ++i)
+        m.emplace(i, i);
+    {
+        phmap::BinaryOutputArchive ar(base.c_str());
+        ASSERT_TRUE(m.phmap_dump(ar));
+    }
+
+    {
+        Log log(m, wal.c_str());
+        EXPECT_TRUE(log.insert(Map::value_type(5000, 1)));
+        EXPECT_FALSE(log.insert(Map::value_type(5, 1)));       // present: unchanged
+        EXPECT_FALSE(log.insert_or_assign(10, 100));
+        EXPECT_TRUE(log.insert_or_assign(6000, 2));
+        EXPECT_TRUE(log.modify_if(20, [](Map::value_type& v) { v.second += 1000; }));
+        EXPECT_FALSE(log.modify_if(7000, [](Map::value_type& v) { v.second = 0; }));
+        EXPECT_EQ(log.erase(30), 1u);
+        EXPECT_EQ(log.erase(8000), 0u);
+        EXPECT_TRUE(log.commit());
+        size_t size = log.file_size();
+        EXPECT_GT(size, 0u);
+        EXPECT_TRUE(log.commit());                              // nothing to write
+        EXPECT_EQ(log.file_size(), size);
+
+        EXPECT_EQ(log.erase(40), 1u);                           // committed by the destructor
+    }
+    EXPECT_EQ(m[5], 5u);
+    EXPECT_EQ(m[20], 1020u);
+
+    Map r;
+    {
+        phmap::BinaryInputArchive ar(base.c_str());
+        ASSERT_TRUE(r.phmap_load(ar));
+    }
+    EXPECT_TRUE(Log::replay(r, wal.c_str()));
+    ExpectSameElements(m, r);
+
+    // reopening appends after the existing groups
+    {
+        Log log(m, wal.c_str());
+        log.insert_or_assign(10, 200);
+    }
+    Map r2;
+    {
+        phmap::BinaryInputArchive ar(base.c_str());
+        ASSERT_TRUE(r2.phmap_load(ar));
+    }
+    EXPECT_TRUE(Log::replay(r2, wal.c_str()));
+    EXPECT_EQ(r2[10], 200u);
+    ExpectSameElements(m, r2);
+
+    Map empty;
+    EXPECT_TRUE(Log::replay(empty, TestFile("missing").c_str()));
+    EXPECT_TRUE(empty.empty());
+
+    std::remove(base.c_str());
+    std::remove(wal.c_str());
+}
+
+TEST(MutationLog, GroupCommitConcurrent) {
+    std::string wal = TestFile("concurrent");
+    const uint64_t num_threads = 4, per_thread = 20000;
+
+    Map m;
+    {
+        Log log(m, wal.c_str(), std::chrono::milliseconds(1));
+        std::vector<std::thread> threads;
+        for (uint64_t t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&log, t, per_thread]() {
+                for (uint64_t i = t * per_thread; i < (t + 1) * per_thread; ++i) {
+                    log.insert_or_assign(i, i);
+                    if (i % 3 == 0)
+                        log.modify_if(i, [](Map::value_type& v) { v.second *= 2; });
+                    if (i % 7 == 0)
+                        log.erase(i);
+                }
+            });
+        }
+        for (auto& th : threads)
+            th.join();
+        EXPECT_TRUE(log.good());
+    }
+
+    Map r;
+    EXPECT_TRUE(Log::replay(r, wal.c_str()));
+    ExpectSameElements(m, r);
+    std::remove(wal.c_str());
+}
+
+TEST(MutationLog, RotateWithFullDump) {
+    std::string base = TestFile("rotate_base"), wal1 = TestFile("rotate1"),
+                wal2 = TestFile("rotate2");
+
+    Map m;
+    Log log(m, wal1.c_str());
+    for (uint64_t i = 0; i < 500; ++i)
+        log.insert_or_assign(i, i);
+    log.commit();
+
+    // new mutations go to wal2, and are also in the dump (replaying is idempotent)
+    EXPECT_TRUE(log.rotate(wal2.c_str()));
+    log.insert_or_assign(1, 1000);
+    {
+        phmap::BinaryOutputArchive ar(base.c_str());
+        ASSERT_TRUE(m.phmap_dump(ar));
+    }
+    log.erase(2);
+    log.insert_or_assign(600, 6);
+    log.commit();
+
+    Map r;
+    {
+        phmap::BinaryInputArchive ar(base.c_str());
+        ASSERT_TRUE(r.phmap_load(ar));
+    }
+    EXPECT_TRUE(Log::replay(r, wal2.c_str()));
+    ExpectSameElements(m, r);
+
+    std::remove(base.c_str());
+    std::remove(wal1.c_str());
+    std::remove(wal2.c_str());
+}
+
+TEST(MutationLog, TornGroup) {
+    std::string wal = TestFile("torn");
+
+    Map m;
+    uint64_t first_group;
+    {
+        Log log(m, wal.c_str());
+        log.insert_or_assign(1, 1);
+        log.commit();
+        first_group = log.file_size();
+        log.insert_or_assign(2, 2);
+        log.commit();
+    }
+    // crash during the second commit
+    ASSERT_EQ(::truncate(wal.c_str(), static_cast<off_t>(first_group + 12)), 0);
+
+    Map r;
+    EXPECT_TRUE(Log::replay(r, wal.c_str()));
+    EXPECT_EQ(r.size(), 1u);
+    EXPECT_EQ(r[1], 1u);
+
+    // the torn group is dropped, and the next ones are appended after the first one
+    {
+        Log log(r, wal.c_str());
+        EXPECT_EQ(log.file_size(), first_group);
+        log.insert_or_assign(3, 3);
+    }
+    Map r2;
+    EXPECT_TRUE(Log::replay(r2, wal.c_str()));
+    ExpectSameElements(r, r2);
+    EXPECT_EQ(r2.size(), 2u);
+    EXPECT_EQ(r2.count(2), 0u);
+
+    std::remove(wal.c_str());
+}
+
+}  // namespace
+}  // namespace priv
+}  // namespace phmap
+
+#endif // PHMAP_HAVE_MMAP